@@ -0,0 +1,341 @@
+/******************************************************************************
+DSPatch - The Refreshingly Simple C++ Dataflow Framework
+Copyright (c) 2025, Marcus Tomlinson
+
+BSD 2-Clause License
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace DSPatch::Benchmarks
+{
+
+// A benchmark's setup function configures whatever state it needs (E.g. a circuit), and returns the operation to be timed
+// (capturing that state). The operation is called repeatedly, and its state released once the benchmark completes.
+using Operation = std::function<void()>;
+using Setup = std::function<Operation()>;
+
+struct Options final
+{
+    std::string filter;
+    int warmUps = 3;
+    int repetitions = 20;
+    double minSampleMs = 10.0;
+    std::string jsonPath;
+    std::string csvPath;
+};
+
+struct Result final
+{
+    std::string name;
+    int64_t iterations = 0;      // operations per sample
+    std::vector<double> samples;  // ns per operation
+
+    double mean = 0.0;
+    double stddev = 0.0;
+    double min = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+};
+
+class Registry final
+{
+public:
+    void Add( const std::string& name, const Setup& setup );
+
+    std::vector<Result> Run( const Options& options ) const;
+
+private:
+    struct Benchmark final
+    {
+        std::string name;
+        Setup setup;
+    };
+
+    static double _Time( const Operation& operation, int64_t iterations );
+    static void _Summarize( Result& result );
+    static double _Percentile( const std::vector<double>& sorted, double percentile );
+
+    std::vector<Benchmark> _benchmarks;
+};
+
+bool ParseOptions( int argc, char* argv[], Options& options );
+
+void PrintResults( const std::vector<Result>& results, std::ostream& stream );
+bool WriteJson( const std::vector<Result>& results, const std::string& path );
+bool WriteCsv( const std::vector<Result>& results, const std::string& path );
+
+inline void Registry::Add( const std::string& name, const Setup& setup )
+{
+    _benchmarks.emplace_back( Benchmark{ name, setup } );
+}
+
+inline std::vector<Result> Registry::Run( const Options& options ) const
+{
+    std::vector<Result> results;
+
+    for ( const auto& benchmark : _benchmarks )
+    {
+        if ( benchmark.name.find( options.filter ) == std::string::npos )
+        {
+            continue;
+        }
+
+        std::cerr << "Running " << benchmark.name << "..." << std::endl;
+
+        Result result;
+        result.name = benchmark.name;
+
+        {
+            auto operation = benchmark.setup();
+
+            // calibrate the number of iterations per sample, such that each sample takes at least minSampleMs
+            result.iterations = 1;
+            while ( _Time( operation, result.iterations ) * 1e-6 < options.minSampleMs && result.iterations < ( 1ll << 40 ) )
+            {
+                result.iterations *= 2;
+            }
+
+            // warm up caches, branch predictors, allocators and thread schedulers
+            for ( int i = 0; i < options.warmUps; ++i )
+            {
+                _Time( operation, result.iterations );
+            }
+
+            for ( int i = 0; i < options.repetitions; ++i )
+            {
+                result.samples.emplace_back( _Time( operation, result.iterations ) / (double)result.iterations );
+            }
+        }
+
+        _Summarize( result );
+        results.emplace_back( std::move( result ) );
+    }
+
+    return results;
+}
+
+inline double Registry::_Time( const Operation& operation, int64_t iterations )
+{
+    const auto begin = std::chrono::steady_clock::now();
+
+    for ( int64_t i = 0; i < iterations; ++i )
+    {
+        operation();
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>( end - begin ).count();
+}
+
+inline void Registry::_Summarize( Result& result )
+{
+    auto sorted = result.samples;
+    std::sort( sorted.begin(), sorted.end() );
+
+    const auto count = (double)sorted.size();
+
+    double sum = 0.0;
+    for ( auto sample : sorted )
+    {
+        sum += sample;
+    }
+    result.mean = sum / count;
+
+    double squares = 0.0;
+    for ( auto sample : sorted )
+    {
+        squares += ( sample - result.mean ) * ( sample - result.mean );
+    }
+    result.stddev = sorted.size() > 1 ? std::sqrt( squares / ( count - 1.0 ) ) : 0.0;
+
+    result.min = sorted.front();
+    result.p50 = _Percentile( sorted, 50.0 );
+    result.p90 = _Percentile( sorted, 90.0 );
+    result.p99 = _Percentile( sorted, 99.0 );
+    result.max = sorted.back();
+}
+
+inline double Registry::_Percentile( const std::vector<double>& sorted, double percentile )
+{
+    // linear interpolation between closest ranks
+    const auto rank = percentile / 100.0 * (double)( sorted.size() - 1 );
+    const auto lower = (size_t)rank;
+    const auto upper = std::min( lower + 1, sorted.size() - 1 );
+
+    return sorted[lower] + ( sorted[upper] - sorted[lower] ) * ( rank - (double)lower );
+}
+
+inline bool ParseOptions( int argc, char* argv[], Options& options )
+{
+    for ( int i = 1; i < argc; ++i )
+    {
+        const std::string arg = argv[i];
+
+        if ( arg == "--help" )
+        {
+            return false;
+        }
+
+        if ( i + 1 == argc )
+        {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+
+        const std::string value = argv[++i];
+
+        if ( arg == "--filter" )
+        {
+            options.filter = value;
+        }
+        else if ( arg == "--warmups" )
+        {
+            options.warmUps = std::stoi( value );
+        }
+        else if ( arg == "--repetitions" )
+        {
+            options.repetitions = std::max( 1, std::stoi( value ) );
+        }
+        else if ( arg == "--min-sample-ms" )
+        {
+            options.minSampleMs = std::stod( value );
+        }
+        else if ( arg == "--json" )
+        {
+            options.jsonPath = value;
+        }
+        else if ( arg == "--csv" )
+        {
+            options.csvPath = value;
+        }
+        else
+        {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+inline void PrintResults( const std::vector<Result>& results, std::ostream& stream )
+{
+    stream << std::left << std::setw( 40 ) << "Benchmark (ns/op)" << std::right;
+    for ( auto column : { "mean", "stddev", "min", "p50", "p90", "p99", "max" } )
+    {
+        stream << std::setw( 12 ) << column;
+    }
+    stream << std::endl;
+
+    stream << std::fixed << std::setprecision( 1 );
+    for ( const auto& result : results )
+    {
+        stream << std::left << std::setw( 40 ) << result.name << std::right;
+        for ( auto value : { result.mean, result.stddev, result.min, result.p50, result.p90, result.p99, result.max } )
+        {
+            stream << std::setw( 12 ) << value;
+        }
+        stream << std::endl;
+    }
+}
+
+inline bool WriteJson( const std::vector<Result>& results, const std::string& path )
+{
+    std::ofstream stream( path );
+
+    if ( !stream )
+    {
+        return false;
+    }
+
+    stream << std::setprecision( 17 );
+    stream << "{\n  \"unit\": \"ns/op\",\n  \"benchmarks\": [";
+
+    for ( size_t i = 0; i < results.size(); ++i )
+    {
+        const auto& result = results[i];
+
+        stream << ( i == 0 ? "\n" : ",\n" );
+        stream << "    {\n";
+        stream << "      \"name\": \"" << result.name << "\",\n";
+        stream << "      \"iterations\": " << result.iterations << ",\n";
+        stream << "      \"mean\": " << result.mean << ",\n";
+        stream << "      \"stddev\": " << result.stddev << ",\n";
+        stream << "      \"min\": " << result.min << ",\n";
+        stream << "      \"p50\": " << result.p50 << ",\n";
+        stream << "      \"p90\": " << result.p90 << ",\n";
+        stream << "      \"p99\": " << result.p99 << ",\n";
+        stream << "      \"max\": " << result.max << ",\n";
+        stream << "      \"samples\": [";
+
+        for ( size_t j = 0; j < result.samples.size(); ++j )
+        {
+            stream << ( j == 0 ? "" : ", " ) << result.samples[j];
+        }
+
+        stream << "]\n    }";
+    }
+
+    stream << "\n  ]\n}\n";
+
+    return (bool)stream;
+}
+
+inline bool WriteCsv( const std::vector<Result>& results, const std::string& path )
+{
+    std::ofstream stream( path );
+
+    if ( !stream )
+    {
+        return false;
+    }
+
+    stream << std::setprecision( 17 );
+    stream << "name,iterations,mean,stddev,min,p50,p90,p99,max\n";
+
+    for ( const auto& result : results )
+    {
+        stream << result.name << ',' << result.iterations << ',' << result.mean << ',' << result.stddev << ',' << result.min
+               << ',' << result.p50 << ',' << result.p90 << ',' << result.p99 << ',' << result.max << '\n';
+    }
+
+    return (bool)stream;
+}
+
+}  // namespace DSPatch::Benchmarks
@@ -0,0 +1,177 @@
+/******************************************************************************
+DSPatch - The Refreshingly Simple C++ Dataflow Framework
+Copyright (c) 2025, Marcus Tomlinson
+
+BSD 2-Clause License
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include "components/SyntheticNode.h"
+
+#include <DSPatch.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace DSPatch::Benchmarks
+{
+
+// Parameters of a synthetic layered DAG (optionally with feedback edges)
+struct GraphSpec final
+{
+    enum class Distribution
+    {
+        Fixed,        // every node costs exactly costAmount
+        Uniform,      // uniform between 0 and 2 * costAmount
+        Exponential,  // exponential with a mean of costAmount (a few nodes are much more expensive than the rest)
+    };
+
+    int componentCount = 1000;
+    int width = 0;  // nodes per layer (0 = sqrt( componentCount ))
+
+    int fanIn = 2;   // inputs per node (connected to random nodes in the previous layer)
+    int fanOut = 4;  // preferred max consumers per node (exceeded when a free node can't be found within a few draws)
+
+    int feedbackEdges = 0;  // edges from a node back to a node in an earlier layer
+
+    SyntheticNode::Cost cost = SyntheticNode::Cost::None;
+    int64_t costAmount = 0;  // ns for Cost::Spin, bytes for Cost::Memory
+    Distribution distribution = Distribution::Fixed;
+
+    unsigned seed = 1;
+};
+
+struct Graph final
+{
+    std::vector<std::vector<Component::SPtr>> layers;
+
+    int GetDepth() const
+    {
+        return (int)layers.size();
+    }
+
+    int GetWidth() const
+    {
+        return layers.empty() ? 0 : (int)layers.front().size();
+    }
+};
+
+// Adds a graph built to spec to a circuit. The same spec (incl. seed) always generates the same graph.
+inline Graph GenerateGraph( const GraphSpec& spec, Circuit& circuit )
+{
+    std::mt19937 random( spec.seed );
+
+    const auto width = spec.width > 0
+                           ? spec.width
+                           : std::max( 1, (int)std::sqrt( (double)std::max( 1, spec.componentCount ) ) );
+    const auto depth = std::max( 1, ( spec.componentCount + width - 1 ) / width );
+
+    auto drawCost = [&]() -> int64_t {
+        switch ( spec.distribution )
+        {
+            case GraphSpec::Distribution::Uniform:
+                return std::uniform_int_distribution<int64_t>( 0, 2 * spec.costAmount )( random );
+            case GraphSpec::Distribution::Exponential:
+                return spec.costAmount == 0
+                           ? 0
+                           : (int64_t)std::exponential_distribution<double>( 1.0 / (double)spec.costAmount )( random );
+            default:
+                return spec.costAmount;
+        }
+    };
+
+    // every node has an additional input reserved for a potential feedback edge
+    const auto inputCount = spec.fanIn + ( spec.feedbackEdges > 0 ? 1 : 0 );
+
+    Graph graph;
+    graph.layers.resize( depth );
+
+    int remaining = spec.componentCount;
+    for ( int layer = 0; layer < depth; ++layer )
+    {
+        auto& nodes = graph.layers[layer];
+
+        const auto layerWidth = std::min( width, remaining );
+        remaining -= layerWidth;
+
+        for ( int i = 0; i < layerWidth; ++i )
+        {
+            auto node = std::make_shared<SyntheticNode>( layer == 0 ? 0 : inputCount, spec.cost, drawCost() );
+            circuit.AddComponent( node );
+            nodes.emplace_back( node );
+        }
+
+        if ( layer == 0 )
+        {
+            continue;
+        }
+
+        // connect each node's inputs to random nodes in the previous layer, preferring those with spare fan-out
+        const auto& previous = graph.layers[layer - 1];
+        std::vector<int> consumers( previous.size(), 0 );
+
+        std::uniform_int_distribution<int> pick( 0, (int)previous.size() - 1 );
+
+        for ( const auto& node : nodes )
+        {
+            for ( int input = 0; input < spec.fanIn; ++input )
+            {
+                auto from = pick( random );
+                for ( int attempt = 0; attempt < 8 && consumers[from] >= spec.fanOut; ++attempt )
+                {
+                    from = pick( random );
+                }
+
+                ++consumers[from];
+                circuit.ConnectOutToIn( previous[from], 0, node, input );
+            }
+        }
+    }
+
+    // feedback edges run from a node to the reserved input of a node in an earlier layer
+    if ( depth > 2 )
+    {
+        for ( int i = 0; i < spec.feedbackEdges; ++i )
+        {
+            const auto toLayer = std::uniform_int_distribution<int>( 1, depth - 2 )( random );
+            const auto fromLayer = std::uniform_int_distribution<int>( toLayer + 1, depth - 1 )( random );
+
+            const auto& from = graph.layers[fromLayer];
+            const auto& to = graph.layers[toLayer];
+
+            circuit.ConnectOutToIn( from[std::uniform_int_distribution<size_t>( 0, from.size() - 1 )( random )],
+                                    0,
+                                    to[std::uniform_int_distribution<size_t>( 0, to.size() - 1 )( random )],
+                                    spec.fanIn );
+        }
+    }
+
+    return graph;
+}
+
+}  // namespace DSPatch::Benchmarks
@@ -0,0 +1,357 @@
+/******************************************************************************
+DSPatch - The Refreshingly Simple C++ Dataflow Framework
+Copyright (c) 2025, Marcus Tomlinson
+
+BSD 2-Clause License
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+// Compares two result files written by Benchmarks --json, flagging statistically significant regressions (and improvements)
+// via Welch's t-test on each benchmark's samples. Exits with 1 if any benchmark regressed.
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct Samples final
+{
+    std::vector<double> values;
+
+    double mean = 0.0;
+    double variance = 0.0;
+};
+
+// Minimal reader for the JSON written by Benchmarks: extracts the "name" and "samples" of each benchmark
+class ResultReader final
+{
+public:
+    explicit ResultReader( std::string text )
+        : _text( std::move( text ) )
+    {
+    }
+
+    bool Read( std::map<std::string, Samples>& results )
+    {
+        std::string name;
+
+        while ( _Find( '"' ) )
+        {
+            const auto key = _ReadString();
+
+            if ( !_Find( ':' ) )
+            {
+                return false;
+            }
+
+            if ( key == "name" )
+            {
+                _Find( '"' );
+                name = _ReadString();
+            }
+            else if ( key == "samples" )
+            {
+                if ( name.empty() || !_Find( '[' ) )
+                {
+                    return false;
+                }
+
+                auto& samples = results[name];
+                while ( _pos < _text.size() && _text[_pos] != ']' )
+                {
+                    size_t length = 0;
+                    samples.values.emplace_back( std::stod( _text.substr( _pos ), &length ) );
+                    _pos += length;
+
+                    while ( _pos < _text.size() && ( _text[_pos] == ',' || std::isspace( (unsigned char)_text[_pos] ) ) )
+                    {
+                        ++_pos;
+                    }
+                }
+
+                name.clear();
+            }
+        }
+
+        return true;
+    }
+
+private:
+    bool _Find( char c )
+    {
+        _pos = _text.find( c, _pos );
+
+        if ( _pos == std::string::npos )
+        {
+            return false;
+        }
+
+        ++_pos;
+
+        // skip whitespace
+        while ( _pos < _text.size() && std::isspace( (unsigned char)_text[_pos] ) )
+        {
+            ++_pos;
+        }
+
+        return true;
+    }
+
+    std::string _ReadString()
+    {
+        const auto end = _text.find( '"', _pos );
+        auto result = _text.substr( _pos, end - _pos );
+        _pos = end + 1;
+        return result;
+    }
+
+    std::string _text;
+    size_t _pos = 0;
+};
+
+bool ReadResults( const std::string& path, std::map<std::string, Samples>& results )
+{
+    std::ifstream stream( path );
+
+    if ( !stream )
+    {
+        std::cerr << "Failed to open " << path << std::endl;
+        return false;
+    }
+
+    std::stringstream text;
+    text << stream.rdbuf();
+
+    try
+    {
+        if ( !ResultReader( text.str() ).Read( results ) )
+        {
+            std::cerr << "Failed to parse " << path << std::endl;
+            return false;
+        }
+    }
+    catch ( const std::exception& )
+    {
+        std::cerr << "Failed to parse " << path << std::endl;
+        return false;
+    }
+
+    for ( auto& [name, samples] : results )
+    {
+        const auto count = (double)samples.values.size();
+
+        for ( auto value : samples.values )
+        {
+            samples.mean += value / count;
+        }
+        for ( auto value : samples.values )
+        {
+            samples.variance += ( value - samples.mean ) * ( value - samples.mean ) / std::max( count - 1.0, 1.0 );
+        }
+    }
+
+    return true;
+}
+
+// Continued fraction for the regularized incomplete beta function (modified Lentz's method)
+double BetaContinuedFraction( double a, double b, double x )
+{
+    constexpr double epsilon = 1e-14;
+    constexpr double tiny = 1e-300;
+
+    double c = 1.0;
+    double d = 1.0 - ( a + b ) * x / ( a + 1.0 );
+    d = 1.0 / ( std::fabs( d ) < tiny ? tiny : d );
+    double result = d;
+
+    for ( int m = 1; m <= 300; ++m )
+    {
+        const double m2 = 2.0 * m;
+
+        // even step
+        double numerator = m * ( b - m ) * x / ( ( a + m2 - 1.0 ) * ( a + m2 ) );
+        d = 1.0 + numerator * d;
+        d = 1.0 / ( std::fabs( d ) < tiny ? tiny : d );
+        c = 1.0 + numerator / c;
+        c = std::fabs( c ) < tiny ? tiny : c;
+        result *= d * c;
+
+        // odd step
+        numerator = -( a + m ) * ( a + b + m ) * x / ( ( a + m2 ) * ( a + m2 + 1.0 ) );
+        d = 1.0 + numerator * d;
+        d = 1.0 / ( std::fabs( d ) < tiny ? tiny : d );
+        c = 1.0 + numerator / c;
+        c = std::fabs( c ) < tiny ? tiny : c;
+        const double delta = d * c;
+        result *= delta;
+
+        if ( std::fabs( delta - 1.0 ) < epsilon )
+        {
+            break;
+        }
+    }
+
+    return result;
+}
+
+double IncompleteBeta( double a, double b, double x )
+{
+    if ( x <= 0.0 )
+    {
+        return 0.0;
+    }
+    if ( x >= 1.0 )
+    {
+        return 1.0;
+    }
+
+    const double front =
+        std::exp( std::lgamma( a + b ) - std::lgamma( a ) - std::lgamma( b ) + a * std::log( x ) + b * std::log( 1.0 - x ) );
+
+    // the continued fraction converges quickly only for x < (a + 1) / (a + b + 2), otherwise use the symmetry relation
+    if ( x < ( a + 1.0 ) / ( a + b + 2.0 ) )
+    {
+        return front * BetaContinuedFraction( a, b, x ) / a;
+    }
+    return 1.0 - front * BetaContinuedFraction( b, a, 1.0 - x ) / b;
+}
+
+// Two-sided p-value of Welch's t-test
+double WelchPValue( const Samples& a, const Samples& b )
+{
+    const auto na = (double)a.values.size();
+    const auto nb = (double)b.values.size();
+
+    if ( na < 2 || nb < 2 )
+    {
+        return 1.0;
+    }
+
+    const double va = a.variance / na;
+    const double vb = b.variance / nb;
+
+    if ( va + vb == 0.0 )
+    {
+        return a.mean == b.mean ? 1.0 : 0.0;
+    }
+
+    const double t = ( a.mean - b.mean ) / std::sqrt( va + vb );
+    const double df = ( va + vb ) * ( va + vb ) / ( va * va / ( na - 1.0 ) + vb * vb / ( nb - 1.0 ) );
+
+    return IncompleteBeta( df / 2.0, 0.5, df / ( df + t * t ) );
+}
+
+}  // namespace
+
+int main( int argc, char* argv[] )
+{
+    double alpha = 0.01;
+    double threshold = 0.05;
+    std::vector<std::string> paths;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        const std::string arg = argv[i];
+
+        if ( arg == "--alpha" && i + 1 < argc )
+        {
+            alpha = std::stod( argv[++i] );
+        }
+        else if ( arg == "--threshold" && i + 1 < argc )
+        {
+            threshold = std::stod( argv[++i] );
+        }
+        else
+        {
+            paths.emplace_back( arg );
+        }
+    }
+
+    if ( paths.size() != 2 )
+    {
+        std::cerr << "Usage: BenchmarkCompare [--alpha <p-value>] [--threshold <fraction>] <baseline.json> <candidate.json>\n"
+                  << "  A benchmark is flagged if its mean changed by more than threshold (default 0.05) with p < alpha"
+                  << " (default 0.01)." << std::endl;
+        return 2;
+    }
+
+    std::map<std::string, Samples> baseline, candidate;
+
+    if ( !ReadResults( paths[0], baseline ) || !ReadResults( paths[1], candidate ) )
+    {
+        return 2;
+    }
+
+    int regressionCount = 0;
+
+    std::cout << std::left << std::setw( 40 ) << "Benchmark (ns/op)" << std::right << std::setw( 14 ) << "baseline"
+              << std::setw( 14 ) << "candidate" << std::setw( 10 ) << "change" << std::setw( 12 ) << "p-value" << std::endl;
+
+    for ( const auto& [name, candidateSamples] : candidate )
+    {
+        auto it = baseline.find( name );
+
+        if ( it == baseline.end() )
+        {
+            std::cout << std::left << std::setw( 40 ) << name << std::right << std::setw( 14 ) << "-" << std::endl;
+            continue;
+        }
+
+        const auto& baselineSamples = it->second;
+
+        const double change = candidateSamples.mean / baselineSamples.mean - 1.0;
+        const double pValue = WelchPValue( baselineSamples, candidateSamples );
+
+        std::string verdict;
+        if ( pValue < alpha && change > threshold )
+        {
+            verdict = "  REGRESSION";
+            ++regressionCount;
+        }
+        else if ( pValue < alpha && change < -threshold )
+        {
+            verdict = "  improvement";
+        }
+
+        std::cout << std::left << std::setw( 40 ) << name << std::right << std::fixed << std::setprecision( 1 ) << std::setw( 14 )
+                  << baselineSamples.mean << std::setw( 14 ) << candidateSamples.mean << std::setw( 9 ) << change * 100.0 << "%"
+                  << std::setprecision( 4 ) << std::setw( 12 ) << pValue << verdict << std::endl;
+    }
+
+    if ( regressionCount != 0 )
+    {
+        std::cout << regressionCount << " benchmark(s) regressed." << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+/******************************************************************************
+DSPatch - The Refreshingly Simple C++ Dataflow Framework
+Copyright (c) 2025, Marcus Tomlinson
+
+BSD 2-Clause License
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include <DSPatch.h>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace DSPatch::Benchmarks
+{
+
+// A stateless node that sums its inputs, then burns a fixed amount of synthetic work per tick: either spinning for a number of
+// nanoseconds (compute-bound), or reading through a private working set of a number of bytes (memory-bound).
+class SyntheticNode final : public Component
+{
+public:
+    enum class Cost
+    {
+        None,
+        Spin,
+        Memory
+    };
+
+    SyntheticNode( int inputCount, Cost cost, int64_t amount )
+        : Component( ProcessOrder::OutOfOrder )
+        , _cost( cost )
+        , _amount( amount )
+    {
+        SetInputCount_( inputCount );
+        SetOutputCount_( 1 );
+
+        if ( _cost == Cost::Memory )
+        {
+            // one cache line per element
+            _workingSet.resize( std::max<int64_t>( 1, _amount / 64 ) * 8, 1 );
+        }
+    }
+
+protected:
+    void Process_( SignalBus& inputs, SignalBus& outputs ) override
+    {
+        int64_t sum = 1;
+
+        for ( int i = 0; i < inputs.GetSignalCount(); ++i )
+        {
+            if ( auto in = inputs.GetValue<int64_t>( i ) )
+            {
+                sum += *in;
+            }
+        }
+
+        if ( _cost == Cost::Spin )
+        {
+            const auto end = std::chrono::steady_clock::now() + std::chrono::nanoseconds( _amount );
+            while ( std::chrono::steady_clock::now() < end )
+            {
+            }
+        }
+        else if ( _cost == Cost::Memory )
+        {
+            for ( size_t i = 0; i < _workingSet.size(); i += 8 )
+            {
+                sum += _workingSet[i];
+            }
+        }
+
+        outputs.SetValue( 0, sum & 0xffff );
+    }
+
+private:
+    const Cost _cost;
+    const int64_t _amount;
+
+    std::vector<int64_t> _workingSet;
+};
+
+}  // namespace DSPatch::Benchmarks
@@ -0,0 +1,609 @@
+/******************************************************************************
+DSPatch - The Refreshingly Simple C++ Dataflow Framework
+Copyright (c) 2025, Marcus Tomlinson
+
+BSD 2-Clause License
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#include "Benchmark.h"
+
+#include "components/Adder.h"
+#include "components/Counter.h"
+#include "components/Incrementer.h"
+#include "components/Sink.h"
+#include "components/SyntheticNode.h"
+#include "components/VectorCounter.h"
+
+#include <DSPatch.h>
+
+#include <sstream>
+
+using namespace DSPatch;
+using namespace DSPatch::Benchmarks;
+
+// Micro benchmarks
+// ================
+
+static void AddSignalBusBenchmarks( Registry& registry )
+{
+    registry.Add( "SignalBus/SetValue", [] {
+        auto bus = std::make_shared<SignalBus>();
+        bus->SetSignalCount( 1 );
+
+        return [bus, i = 0]() mutable { bus->SetValue( 0, i++ ); };
+    } );
+
+    registry.Add( "SignalBus/GetValue", [] {
+        auto bus = std::make_shared<SignalBus>();
+        bus->SetSignalCount( 1 );
+        bus->SetValue( 0, 1 );
+
+        return [bus, sum = 0]() mutable { sum += *bus->GetValue<int>( 0 ); };
+    } );
+
+    registry.Add( "SignalBus/MoveSignal/Vector1024", [] {
+        auto fromBus = std::make_shared<SignalBus>();
+        auto toBus = std::make_shared<SignalBus>();
+        fromBus->SetSignalCount( 1 );
+        toBus->SetSignalCount( 1 );
+        fromBus->SetValue( 0, std::vector<float>( 1024 ) );
+
+        return [fromBus, toBus]() {
+            toBus->MoveSignal( 0, *fromBus->GetSignal( 0 ) );
+            fromBus->MoveSignal( 0, *toBus->GetSignal( 0 ) );
+        };
+    } );
+
+    registry.Add( "SignalBus/SetSignal/Vector1024", [] {
+        auto fromBus = std::make_shared<SignalBus>();
+        auto toBus = std::make_shared<SignalBus>();
+        fromBus->SetSignalCount( 1 );
+        toBus->SetSignalCount( 1 );
+        fromBus->SetValue( 0, std::vector<float>( 1024 ) );
+
+        return [fromBus, toBus]() { toBus->SetSignal( 0, *fromBus->GetSignal( 0 ) ); };
+    } );
+}
+
+static void AddFanOutBenchmarks( Registry& registry )
+{
+    // 1 output feeding 8 inputs: 7 copies and 1 move per tick
+    for ( int size : { 16, 1024, 65536 } )
+    {
+        registry.Add( "FanOut/8x/Vector" + std::to_string( size ), [size] {
+            auto circuit = std::make_shared<Circuit>();
+
+            auto source = std::make_shared<VectorCounter>( size );
+            circuit->AddComponent( source );
+
+            for ( int i = 0; i < 8; ++i )
+            {
+                auto sink = std::make_shared<Sink>();
+                circuit->AddComponent( sink );
+                circuit->ConnectOutToIn( source, 0, sink, 0 );
+            }
+
+            return [circuit]() { circuit->Tick(); };
+        } );
+    }
+}
+
+// Macro benchmarks
+// ================
+
+static void AddSerialChainBenchmarks( Registry& registry )
+{
+    for ( int bufferCount : { 0, 4, 8, 16 } )
+    {
+        registry.Add( "SerialChain/1000/Buffers" + std::to_string( bufferCount ), [bufferCount] {
+            auto circuit = std::make_shared<Circuit>();
+
+            Component::SPtr previous = std::make_shared<Counter>();
+            circuit->AddComponent( previous );
+
+            for ( int i = 0; i < 1000; ++i )
+            {
+                auto incrementer = std::make_shared<Incrementer>();
+                circuit->AddComponent( incrementer );
+                circuit->ConnectOutToIn( previous, 0, incrementer, 0 );
+                previous = incrementer;
+            }
+
+            auto sink = std::make_shared<Sink>();
+            circuit->AddComponent( sink );
+            circuit->ConnectOutToIn( previous, 0, sink, 0 );
+
+            circuit->SetBufferCount( bufferCount );
+
+            return [circuit]() { circuit->Tick(); };
+        } );
+    }
+
+    // the same chain (unbuffered), emplaced into the circuit's arena
+    registry.Add( "SerialChain/1000/Emplaced", [] {
+        auto circuit = std::make_shared<Circuit>();
+
+        Component::SPtr previous = circuit->Emplace<Counter>();
+
+        for ( int i = 0; i < 1000; ++i )
+        {
+            auto incrementer = circuit->Emplace<Incrementer>();
+            circuit->ConnectOutToIn( previous, 0, incrementer, 0 );
+            previous = incrementer;
+        }
+
+        auto sink = circuit->Emplace<Sink>();
+        circuit->ConnectOutToIn( previous, 0, sink, 0 );
+
+        return [circuit]() { circuit->Tick(); };
+    } );
+
+    // the same chain (unbuffered), allocated individually with its runtime state compacted into tick order
+    registry.Add( "SerialChain/1000/Compacted", [] {
+        auto circuit = std::make_shared<Circuit>();
+
+        Component::SPtr previous = std::make_shared<Counter>();
+        circuit->AddComponent( previous );
+
+        for ( int i = 0; i < 1000; ++i )
+        {
+            auto incrementer = std::make_shared<Incrementer>();
+            circuit->AddComponent( incrementer );
+            circuit->ConnectOutToIn( previous, 0, incrementer, 0 );
+            previous = incrementer;
+        }
+
+        auto sink = std::make_shared<Sink>();
+        circuit->AddComponent( sink );
+        circuit->ConnectOutToIn( previous, 0, sink, 0 );
+
+        circuit->SetCompactionEnabled( true );
+
+        return [circuit]() { circuit->Tick(); };
+    } );
+}
+
+static void AddStateLayoutBenchmarks( Registry& registry )
+{
+    // 16 layers of 8 nodes, each node reading every node of the layer before: lots of per-buffer state (signals, reference
+    // counters and gathers) touched by the buffers' threads each tick
+    for ( int bufferCount : { 4, 8, 16 } )
+    {
+        registry.Add( "StateLayout/16x8Mesh/Buffers" + std::to_string( bufferCount ), [bufferCount] {
+            auto circuit = std::make_shared<Circuit>();
+
+            std::vector<Component::SPtr> layer;
+
+            for ( int i = 0; i < 8; ++i )
+            {
+                layer.emplace_back( std::make_shared<SyntheticNode>( 0, SyntheticNode::Cost::None, 0 ) );
+                circuit->AddComponent( layer.back() );
+            }
+
+            for ( int depth = 1; depth < 16; ++depth )
+            {
+                std::vector<Component::SPtr> nextLayer;
+
+                for ( int i = 0; i < 8; ++i )
+                {
+                    nextLayer.emplace_back( std::make_shared<SyntheticNode>( 8, SyntheticNode::Cost::None, 0 ) );
+                    circuit->AddComponent( nextLayer.back() );
+
+                    for ( int j = 0; j < 8; ++j )
+                    {
+                        circuit->ConnectOutToIn( layer[j], 0, nextLayer.back(), j );
+                    }
+                }
+
+                layer = std::move( nextLayer );
+            }
+
+            circuit->SetBufferCount( bufferCount );
+
+            return [circuit]() { circuit->Tick(); };
+        } );
+    }
+}
+
+static void AddWideParallelBenchmarks( Registry& registry )
+{
+    // 64 parallel branches of 8 incrementers each, converging on a single sink
+    for ( int threadCount : { 0, 2, 4 } )
+    {
+        registry.Add( "WideParallel/64x8/Threads" + std::to_string( threadCount ), [threadCount] {
+            auto circuit = std::make_shared<Circuit>();
+
+            auto source = std::make_shared<Counter>();
+            auto sink = std::make_shared<Sink>( 64 );
+
+            circuit->AddComponent( source );
+            circuit->AddComponent( sink );
+
+            for ( int i = 0; i < 64; ++i )
+            {
+                Component::SPtr previous = source;
+
+                for ( int j = 0; j < 8; ++j )
+                {
+                    auto incrementer = std::make_shared<Incrementer>();
+                    circuit->AddComponent( incrementer );
+                    circuit->ConnectOutToIn( previous, 0, incrementer, 0 );
+                    previous = incrementer;
+                }
+
+                circuit->ConnectOutToIn( previous, 0, sink, i );
+            }
+
+            circuit->SetThreadCount( threadCount );
+
+            return [circuit]() { circuit->Tick(); };
+        } );
+    }
+}
+
+static void AddCallerRunsBenchmarks( Registry& registry )
+{
+    // a small parallel graph (4 branches of 2 incrementers), where per-tick thread hand-off dominates
+    for ( const std::string mode : { "Workers", "CallerRuns", "LowLatency" } )
+    {
+        registry.Add( "SmallParallel/4x2/Threads2/" + mode, [mode] {
+            auto circuit = std::make_shared<Circuit>();
+
+            auto source = std::make_shared<Counter>();
+            auto sink = std::make_shared<Sink>( 4 );
+
+            circuit->AddComponent( source );
+            circuit->AddComponent( sink );
+
+            for ( int i = 0; i < 4; ++i )
+            {
+                Component::SPtr previous = source;
+
+                for ( int j = 0; j < 2; ++j )
+                {
+                    auto incrementer = std::make_shared<Incrementer>();
+                    circuit->AddComponent( incrementer );
+                    circuit->ConnectOutToIn( previous, 0, incrementer, 0 );
+                    previous = incrementer;
+                }
+
+                circuit->ConnectOutToIn( previous, 0, sink, i );
+            }
+
+            circuit->SetThreadCount( 2 );
+            circuit->SetCallerRunsEnabled( mode == "CallerRuns" );
+            circuit->SetLowLatencyEnabled( mode == "LowLatency" );
+
+            // sync each tick, so that both modes are timed to tick completion
+            return [circuit]() {
+                circuit->Tick();
+                circuit->Sync();
+            };
+        } );
+    }
+}
+
+static void AddClockDividerBenchmarks( Registry& registry )
+{
+    // 8 control-rate chains of 4 incrementers, each feeding an audio-rate sink
+    for ( int clockDivider : { 1, 64 } )
+    {
+        registry.Add( "ControlRate/8x4/Divider" + std::to_string( clockDivider ), [clockDivider] {
+            auto circuit = std::make_shared<Circuit>();
+
+            auto source = std::make_shared<Counter>();
+            auto sink = std::make_shared<Sink>( 8 );
+
+            circuit->AddComponent( source );
+            circuit->AddComponent( sink );
+            circuit->SetClockDivider( source, clockDivider );
+
+            for ( int i = 0; i < 8; ++i )
+            {
+                Component::SPtr previous = source;
+
+                for ( int j = 0; j < 4; ++j )
+                {
+                    auto incrementer = std::make_shared<Incrementer>();
+                    circuit->AddComponent( incrementer );
+                    circuit->ConnectOutToIn( previous, 0, incrementer, 0 );
+                    circuit->SetClockDivider( incrementer, clockDivider );
+                    previous = incrementer;
+                }
+
+                circuit->ConnectOutToIn( previous, 0, sink, i );
+            }
+
+            return [circuit]() { circuit->Tick(); };
+        } );
+    }
+}
+
+static void AddOrderedSinkBenchmarks( Registry& registry )
+{
+    // 16 independent branches of a stateless 2us node feeding an in-order sink, over 4 buffers
+    for ( bool reordering : { false, true } )
+    {
+        registry.Add( std::string( "OrderedSink/16x2us/Buffers4/" ) + ( reordering ? "Reordering" : "InOrder" ), [reordering] {
+            auto circuit = std::make_shared<Circuit>();
+
+            for ( int i = 0; i < 16; ++i )
+            {
+                auto node = std::make_shared<SyntheticNode>( 0, SyntheticNode::Cost::Spin, 2000 );
+                auto sink = std::make_shared<Sink>();
+
+                circuit->AddComponent( node );
+                circuit->AddComponent( sink );
+                circuit->ConnectOutToIn( node, 0, sink, 0 );
+            }
+
+            circuit->SetBufferCount( 4 );
+            circuit->SetReorderingEnabled( reordering );
+
+            return [circuit]() { circuit->Tick(); };
+        } );
+    }
+}
+
+static void AddFeedbackBenchmarks( Registry& registry )
+{
+    // an adder that adds a counter to its own previous output, via 8 incrementers
+    for ( int bufferCount : { 0, 4 } )
+    {
+        registry.Add( "Feedback/8/Buffers" + std::to_string( bufferCount ), [bufferCount] {
+            auto circuit = std::make_shared<Circuit>();
+
+            auto counter = std::make_shared<Counter>();
+            auto adder = std::make_shared<Adder>();
+            auto sink = std::make_shared<Sink>();
+
+            circuit->AddComponent( counter );
+            circuit->AddComponent( adder );
+            circuit->AddComponent( sink );
+
+            circuit->ConnectOutToIn( counter, 0, adder, 0 );
+            circuit->ConnectOutToIn( adder, 0, sink, 0 );
+
+            Component::SPtr previous = adder;
+            for ( int i = 0; i < 8; ++i )
+            {
+                auto incrementer = std::make_shared<Incrementer>();
+                circuit->AddComponent( incrementer );
+                circuit->ConnectOutToIn( previous, 0, incrementer, 0 );
+                previous = incrementer;
+            }
+
+            circuit->ConnectOutToIn( previous, 0, adder, 1 );
+
+            circuit->SetBufferCount( bufferCount );
+
+            return [circuit]() { circuit->Tick(); };
+        } );
+    }
+}
+
+static void AddRewiringBenchmarks( Registry& registry )
+{
+    // rewire the input of a 100 component chain back and forth between 2 sources, while auto-ticking
+    for ( int bufferCount : { 0, 4 } )
+    {
+        registry.Add( "Rewiring/AutoTick/Buffers" + std::to_string( bufferCount ), [bufferCount] {
+            auto circuit = std::make_shared<Circuit>();
+
+            auto sources = std::vector<Component::SPtr>{ std::make_shared<Counter>(), std::make_shared<Counter>() };
+            circuit->AddComponent( sources[0] );
+            circuit->AddComponent( sources[1] );
+
+            auto first = std::make_shared<Incrementer>();
+            circuit->AddComponent( first );
+
+            Component::SPtr previous = first;
+            for ( int i = 0; i < 100; ++i )
+            {
+                auto incrementer = std::make_shared<Incrementer>();
+                circuit->AddComponent( incrementer );
+                circuit->ConnectOutToIn( previous, 0, incrementer, 0 );
+                previous = incrementer;
+            }
+
+            auto sink = std::make_shared<Sink>();
+            circuit->AddComponent( sink );
+            circuit->ConnectOutToIn( previous, 0, sink, 0 );
+
+            circuit->SetBufferCount( bufferCount );
+            circuit->StartAutoTick();
+
+            // the circuit (and hence its auto-tick thread) is released along with the operation
+            return [circuit, sources, first, i = 0]() mutable {
+                circuit->ConnectOutToIn( sources[++i % 2], 0, first, 0 );
+                circuit->Optimize();
+            };
+        } );
+    }
+}
+
+static void AddChurnBenchmarks( Registry& registry )
+{
+    // 100 chains of 100 components, returning each incrementer and its source
+    auto build = []( std::vector<std::pair<Component::SPtr, Component::SPtr>>& wires ) {
+        auto circuit = std::make_shared<Circuit>();
+
+        for ( int i = 0; i < 100; ++i )
+        {
+            Component::SPtr previous = std::make_shared<Counter>();
+            circuit->AddComponent( previous );
+
+            for ( int j = 0; j < 99; ++j )
+            {
+                auto incrementer = std::make_shared<Incrementer>();
+                circuit->AddComponent( incrementer );
+                circuit->ConnectOutToIn( previous, 0, incrementer, 0 );
+                wires.emplace_back( previous, incrementer );
+                previous = incrementer;
+            }
+        }
+
+        return circuit;
+    };
+
+    // remove and re-add a component
+    registry.Add( "Churn/RemoveAdd/10000", [build] {
+        std::vector<std::pair<Component::SPtr, Component::SPtr>> wires;
+        auto circuit = build( wires );
+
+        return [circuit, wires, i = 0]() mutable {
+            const auto& component = wires[( i++ * 7919 ) % wires.size()].second;
+
+            circuit->RemoveComponent( component );
+            circuit->AddComponent( component );
+        };
+    } );
+
+    // reconnect a wire, addressing its components by Component::SPtr vs by ComponentId
+    registry.Add( "Churn/Reconnect/10000", [build] {
+        std::vector<std::pair<Component::SPtr, Component::SPtr>> wires;
+        auto circuit = build( wires );
+
+        return [circuit, wires, i = 0]() mutable {
+            const auto& wire = wires[( i++ * 7919 ) % wires.size()];
+
+            circuit->ConnectOutToIn( wire.first, 0, wire.second, 0 );
+        };
+    } );
+
+    registry.Add( "Churn/ReconnectById/10000", [build] {
+        std::vector<std::pair<Component::SPtr, Component::SPtr>> wires;
+        auto circuit = build( wires );
+
+        std::vector<std::pair<ComponentId, ComponentId>> wireIds;
+        for ( const auto& wire : wires )
+        {
+            wireIds.emplace_back( circuit->GetComponentId( wire.first ), circuit->GetComponentId( wire.second ) );
+        }
+
+        return [circuit, wireIds, i = 0]() mutable {
+            const auto& wire = wireIds[( i++ * 7919 ) % wireIds.size()];
+
+            circuit->ConnectOutToIn( wire.first, 0, wire.second, 0 );
+        };
+    } );
+}
+
+static void AddStartupBenchmarks( Registry& registry )
+{
+    // build a 2000 component chain via AddComponent() / ConnectOutToIn() (in a single edit or not), vs loading its saved topology
+    auto build = []( bool edit = false ) {
+        auto circuit = std::make_shared<Circuit>();
+
+        if ( edit )
+        {
+            circuit->BeginEdit();
+        }
+
+        Component::SPtr previous = std::make_shared<Counter>();
+        circuit->AddComponent( previous );
+
+        for ( int i = 0; i < 2000; ++i )
+        {
+            auto incrementer = std::make_shared<Incrementer>();
+            circuit->AddComponent( incrementer );
+            circuit->ConnectOutToIn( previous, 0, incrementer, 0 );
+            previous = incrementer;
+        }
+
+        if ( edit )
+        {
+            circuit->Commit();
+        }
+
+        circuit->SetBufferCount( 4 );
+        circuit->Optimize();
+
+        return circuit;
+    };
+
+    registry.Add( "Startup/Build/2000", [build] { return [build]() { build(); }; } );
+    registry.Add( "Startup/Edit/2000", [build] { return [build]() { build( true ); }; } );
+
+    registry.Add( "Startup/Load/2000", [build] {
+        std::stringstream stream;
+        build()->SaveTopology( stream );
+
+        auto factory = std::make_shared<ComponentFactory>();
+        factory->Register<Counter>();
+        factory->Register<Incrementer>();
+
+        return [topology = stream.str(), factory]() {
+            std::stringstream stream( topology );
+            std::vector<Component::SPtr> components;
+
+            std::make_shared<Circuit>()->LoadTopology( stream, *factory, components );
+        };
+    } );
+}
+
+int main( int argc, char* argv[] )
+{
+    Options options;
+
+    if ( !ParseOptions( argc, argv, options ) )
+    {
+        std::cerr << "Usage: Benchmarks [--filter <substring>] [--warmups <count>] [--repetitions <count>]\n"
+                  << "                  [--min-sample-ms <ms>] [--json <path>] [--csv <path>]" << std::endl;
+        return 1;
+    }
+
+    Registry registry;
+
+    AddSignalBusBenchmarks( registry );
+    AddFanOutBenchmarks( registry );
+    AddSerialChainBenchmarks( registry );
+    AddStateLayoutBenchmarks( registry );
+    AddWideParallelBenchmarks( registry );
+    AddCallerRunsBenchmarks( registry );
+    AddClockDividerBenchmarks( registry );
+    AddOrderedSinkBenchmarks( registry );
+    AddFeedbackBenchmarks( registry );
+    AddRewiringBenchmarks( registry );
+    AddChurnBenchmarks( registry );
+    AddStartupBenchmarks( registry );
+
+    auto results = registry.Run( options );
+
+    PrintResults( results, std::cout );
+
+    if ( !options.jsonPath.empty() && !WriteJson( results, options.jsonPath ) )
+    {
+        std::cerr << "Failed to write " << options.jsonPath << std::endl;
+        return 1;
+    }
+
+    if ( !options.csvPath.empty() && !WriteCsv( results, options.csvPath ) )
+    {
+        std::cerr << "Failed to write " << options.csvPath << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
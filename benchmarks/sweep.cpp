@@ -0,0 +1,390 @@
+/******************************************************************************
+DSPatch - The Refreshingly Simple C++ Dataflow Framework
+Copyright (c) 2025, Marcus Tomlinson
+
+BSD 2-Clause License
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+// Sweeps synthetic graphs (see GraphGenerator.h) across component, buffer and thread counts, recording the throughput and
+// per-tick latency distribution of each configuration.
+
+#include "GraphGenerator.h"
+
+#include <DSPatch.h>
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+using namespace DSPatch;
+using namespace DSPatch::Benchmarks;
+
+namespace
+{
+
+struct SweepOptions final
+{
+    std::vector<int> componentCounts = { 10, 100, 1000, 10000, 100000, 1000000 };
+    std::vector<int> bufferCounts = { 0, 4 };
+    std::vector<int> threadCounts = { 0, 2, 4 };
+
+    GraphSpec spec;
+
+    int warmUpTicks = 10;
+    int maxTicks = 100000;
+    double durationMs = 1000.0;
+
+    std::string jsonPath;
+    std::string csvPath;
+};
+
+struct SweepResult final
+{
+    int componentCount;
+    int width;
+    int depth;
+    int bufferCount;
+    int threadCount;
+
+    int64_t ticks;
+    double ticksPerSecond;
+    double componentTicksPerSecond;
+
+    Histogram tickTime;  // ns between successive Tick() returns
+};
+
+std::vector<int> ParseList( const std::string& value )
+{
+    std::vector<int> result;
+    std::stringstream stream( value );
+
+    for ( std::string item; std::getline( stream, item, ',' ); )
+    {
+        result.emplace_back( std::stoi( item ) );
+    }
+
+    return result;
+}
+
+bool ParseOptions( int argc, char* argv[], SweepOptions& options )
+{
+    for ( int i = 1; i < argc; ++i )
+    {
+        const std::string arg = argv[i];
+
+        if ( arg == "--help" )
+        {
+            return false;
+        }
+
+        if ( i + 1 == argc )
+        {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+
+        const std::string value = argv[++i];
+
+        if ( arg == "--components" )
+        {
+            options.componentCounts = ParseList( value );
+        }
+        else if ( arg == "--buffers" )
+        {
+            options.bufferCounts = ParseList( value );
+        }
+        else if ( arg == "--threads" )
+        {
+            options.threadCounts = ParseList( value );
+        }
+        else if ( arg == "--width" )
+        {
+            options.spec.width = std::stoi( value );
+        }
+        else if ( arg == "--fan-in" )
+        {
+            options.spec.fanIn = std::max( 1, std::stoi( value ) );
+        }
+        else if ( arg == "--fan-out" )
+        {
+            options.spec.fanOut = std::max( 1, std::stoi( value ) );
+        }
+        else if ( arg == "--feedback" )
+        {
+            options.spec.feedbackEdges = std::stoi( value );
+        }
+        else if ( arg == "--cost" )
+        {
+            if ( value == "none" )
+            {
+                options.spec.cost = SyntheticNode::Cost::None;
+            }
+            else if ( value == "spin" )
+            {
+                options.spec.cost = SyntheticNode::Cost::Spin;
+            }
+            else if ( value == "memory" )
+            {
+                options.spec.cost = SyntheticNode::Cost::Memory;
+            }
+            else
+            {
+                std::cerr << "Unknown cost: " << value << std::endl;
+                return false;
+            }
+        }
+        else if ( arg == "--cost-amount" )
+        {
+            options.spec.costAmount = std::stoll( value );
+        }
+        else if ( arg == "--distribution" )
+        {
+            if ( value == "fixed" )
+            {
+                options.spec.distribution = GraphSpec::Distribution::Fixed;
+            }
+            else if ( value == "uniform" )
+            {
+                options.spec.distribution = GraphSpec::Distribution::Uniform;
+            }
+            else if ( value == "exponential" )
+            {
+                options.spec.distribution = GraphSpec::Distribution::Exponential;
+            }
+            else
+            {
+                std::cerr << "Unknown distribution: " << value << std::endl;
+                return false;
+            }
+        }
+        else if ( arg == "--seed" )
+        {
+            options.spec.seed = (unsigned)std::stoul( value );
+        }
+        else if ( arg == "--warmup-ticks" )
+        {
+            options.warmUpTicks = std::stoi( value );
+        }
+        else if ( arg == "--max-ticks" )
+        {
+            options.maxTicks = std::max( 1, std::stoi( value ) );
+        }
+        else if ( arg == "--duration-ms" )
+        {
+            options.durationMs = std::stod( value );
+        }
+        else if ( arg == "--json" )
+        {
+            options.jsonPath = value;
+        }
+        else if ( arg == "--csv" )
+        {
+            options.csvPath = value;
+        }
+        else
+        {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Run( const SweepOptions& options, int componentCount, std::vector<SweepResult>& results )
+{
+    auto spec = options.spec;
+    spec.componentCount = componentCount;
+
+    std::cerr << "Generating " << componentCount << " components..." << std::endl;
+
+    auto circuit = std::make_shared<Circuit>();
+    const auto graph = GenerateGraph( spec, *circuit );
+
+    for ( auto bufferCount : options.bufferCounts )
+    {
+        for ( auto threadCount : options.threadCounts )
+        {
+            if ( spec.feedbackEdges > 0 && threadCount > 0 )
+            {
+                continue;  // feedback loops are not supported in multi-threaded circuits
+            }
+
+            std::cerr << "Running " << componentCount << " components, " << bufferCount << " buffers, " << threadCount
+                      << " threads..." << std::endl;
+
+            circuit->SetBufferCount( bufferCount );
+            circuit->SetThreadCount( threadCount );
+
+            for ( int i = 0; i < options.warmUpTicks; ++i )
+            {
+                circuit->Tick();
+            }
+            circuit->Sync();
+
+            SweepResult result{ componentCount, graph.GetWidth(), graph.GetDepth(), bufferCount, threadCount, 0, 0.0, 0.0, {} };
+
+            const auto begin = std::chrono::steady_clock::now();
+            auto last = begin;
+
+            while ( result.ticks < options.maxTicks &&
+                    std::chrono::duration<double, std::milli>( last - begin ).count() < options.durationMs )
+            {
+                circuit->Tick();
+
+                const auto now = std::chrono::steady_clock::now();
+                result.tickTime.Record( (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>( now - last ).count() );
+                last = now;
+
+                ++result.ticks;
+            }
+
+            // include ticks still in flight on buffer threads
+            circuit->Sync();
+
+            const auto seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - begin ).count();
+            result.ticksPerSecond = (double)result.ticks / seconds;
+            result.componentTicksPerSecond = result.ticksPerSecond * componentCount;
+
+            results.emplace_back( std::move( result ) );
+        }
+    }
+}
+
+void Print( const std::vector<SweepResult>& results, std::ostream& stream )
+{
+    stream << std::setw( 10 ) << "components" << std::setw( 8 ) << "buffers" << std::setw( 8 ) << "threads" << std::setw( 10 )
+           << "ticks" << std::setw( 14 ) << "ticks/s" << std::setw( 14 ) << "comp-ticks/s" << std::setw( 12 ) << "p50 (ns)"
+           << std::setw( 12 ) << "p99 (ns)" << std::setw( 12 ) << "p99.9 (ns)" << std::setw( 12 ) << "max (ns)" << std::endl;
+
+    stream << std::fixed << std::setprecision( 0 );
+    for ( const auto& result : results )
+    {
+        stream << std::setw( 10 ) << result.componentCount << std::setw( 8 ) << result.bufferCount << std::setw( 8 )
+               << result.threadCount << std::setw( 10 ) << result.ticks << std::setw( 14 ) << result.ticksPerSecond
+               << std::setw( 14 ) << result.componentTicksPerSecond << std::setw( 12 ) << result.tickTime.GetPercentile( 50.0 )
+               << std::setw( 12 ) << result.tickTime.GetPercentile( 99.0 ) << std::setw( 12 )
+               << result.tickTime.GetPercentile( 99.9 ) << std::setw( 12 ) << result.tickTime.GetMax() << std::endl;
+    }
+}
+
+bool WriteJson( const std::vector<SweepResult>& results, const std::string& path )
+{
+    std::ofstream stream( path );
+
+    if ( !stream )
+    {
+        return false;
+    }
+
+    stream << std::setprecision( 17 );
+    stream << "{\n  \"unit\": \"ns\",\n  \"sweep\": [";
+
+    for ( size_t i = 0; i < results.size(); ++i )
+    {
+        const auto& result = results[i];
+
+        stream << ( i == 0 ? "\n" : ",\n" );
+        stream << "    { \"components\": " << result.componentCount << ", \"width\": " << result.width
+               << ", \"depth\": " << result.depth << ", \"buffers\": " << result.bufferCount
+               << ", \"threads\": " << result.threadCount << ", \"ticks\": " << result.ticks
+               << ", \"ticksPerSecond\": " << result.ticksPerSecond
+               << ", \"componentTicksPerSecond\": " << result.componentTicksPerSecond
+               << ", \"mean\": " << result.tickTime.GetMean() << ", \"p50\": " << result.tickTime.GetPercentile( 50.0 )
+               << ", \"p90\": " << result.tickTime.GetPercentile( 90.0 ) << ", \"p99\": " << result.tickTime.GetPercentile( 99.0 )
+               << ", \"p999\": " << result.tickTime.GetPercentile( 99.9 ) << ", \"max\": " << result.tickTime.GetMax() << " }";
+    }
+
+    stream << "\n  ]\n}\n";
+
+    return (bool)stream;
+}
+
+bool WriteCsv( const std::vector<SweepResult>& results, const std::string& path )
+{
+    std::ofstream stream( path );
+
+    if ( !stream )
+    {
+        return false;
+    }
+
+    stream << std::setprecision( 17 );
+    stream << "components,width,depth,buffers,threads,ticks,ticksPerSecond,componentTicksPerSecond,mean,p50,p90,p99,p999,max\n";
+
+    for ( const auto& result : results )
+    {
+        stream << result.componentCount << ',' << result.width << ',' << result.depth << ',' << result.bufferCount << ','
+               << result.threadCount << ',' << result.ticks << ',' << result.ticksPerSecond << ','
+               << result.componentTicksPerSecond << ',' << result.tickTime.GetMean() << ','
+               << result.tickTime.GetPercentile( 50.0 ) << ',' << result.tickTime.GetPercentile( 90.0 ) << ','
+               << result.tickTime.GetPercentile( 99.0 ) << ',' << result.tickTime.GetPercentile( 99.9 ) << ','
+               << result.tickTime.GetMax() << '\n';
+    }
+
+    return (bool)stream;
+}
+
+}  // namespace
+
+int main( int argc, char* argv[] )
+{
+    SweepOptions options;
+
+    if ( !ParseOptions( argc, argv, options ) )
+    {
+        std::cerr << "Usage: GraphSweep [--components <n,...>] [--buffers <n,...>] [--threads <n,...>]\n"
+                  << "                  [--width <n>] [--fan-in <n>] [--fan-out <n>] [--feedback <edges>]\n"
+                  << "                  [--cost none|spin|memory] [--cost-amount <ns|bytes>]\n"
+                  << "                  [--distribution fixed|uniform|exponential] [--seed <n>]\n"
+                  << "                  [--warmup-ticks <n>] [--max-ticks <n>] [--duration-ms <ms>]\n"
+                  << "                  [--json <path>] [--csv <path>]" << std::endl;
+        return 1;
+    }
+
+    std::vector<SweepResult> results;
+
+    for ( auto componentCount : options.componentCounts )
+    {
+        Run( options, componentCount, results );
+    }
+
+    Print( results, std::cout );
+
+    if ( !options.jsonPath.empty() && !WriteJson( results, options.jsonPath ) )
+    {
+        std::cerr << "Failed to write " << options.jsonPath << std::endl;
+        return 1;
+    }
+
+    if ( !options.csvPath.empty() && !WriteCsv( results, options.csvPath ) )
+    {
+        std::cerr << "Failed to write " << options.csvPath << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
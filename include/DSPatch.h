@@ -73,6 +73,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     into previous component inputs (supported in multi-buffered circuits but not multi-threaded).
     - <b>Optimised signal transfers</b> - Wherever possible, data between components is transferred
     via move rather than copy.
+    - <b>Vectorized block processing</b> - Process streams of samples via aligned Block signals and
+    runtime-dispatched SSE2 / AVX2 / AVX-512 kernels (see DSPatch::Block and DSPatch::Kernels). As
+    these pull in the SIMD intrinsics headers, they are opt-in: include dspatch/BlockComponents.h.
     - <b>Run-time adaptive signal types</b> - Component inputs can accept values of run-time
     varying types allowing you to create more flexible, multi-purpose component processes.
     - <b>Run-time circuit wiring</b> - Connect and disconnect wires on the fly whilst maintaining
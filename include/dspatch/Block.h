@@ -0,0 +1,290 @@
+/******************************************************************************
+DSPatch - The Refreshingly Simple C++ Dataflow Framework
+Copyright (c) 2025, Marcus Tomlinson
+
+BSD 2-Clause License
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include "SignalBus.h"
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace DSPatch
+{
+
+/// Aligned, fixed-capacity block of samples
+
+/**
+A Block is a signal type for sample and vector processing. Its storage is allocated once on construction, aligned to a 64-byte
+boundary (the width of a cache line, and of an AVX-512 register), and holds up to GetCapacity() elements of type T. The number of
+valid elements in a block (GetSize()) can vary from tick to tick up to this capacity, without reallocating.
+
+A circuit's block size (the capacity with which its source components should create blocks) is configured via
+Circuit::SetBlockSize(), and made available to each of its components via Component::GetBlockSize().
+
+Within Process_(), components should obtain their output blocks via Acquire(). This reuses the block already held by the output
+signal (I.E. the one returned to it by the signal swap in SignalBus::MoveSignal()) whenever its capacity matches, so that in a
+steady stream of ticks no allocations take place. Likewise, copying a block into another of the same capacity reuses the target's
+storage.
+
+The vectorized kernels in the Kernels namespace operate directly on block data via GetData().
+*/
+
+template <typename T>
+class Block final
+{
+public:
+    static_assert( std::is_trivially_copyable<T>::value, "Block elements must be trivially copyable" );
+
+    static constexpr int alignment = 64;
+
+    Block();
+    explicit Block( int capacity );
+    Block( const Block& other );
+    Block( Block&& other ) noexcept;
+    ~Block();
+
+    Block& operator=( const Block& other );
+    Block& operator=( Block&& other ) noexcept;
+
+    static Block& Acquire( SignalBus& signalBus, int signalIndex, int capacity );
+
+    int GetCapacity() const;
+
+    void SetSize( int size );
+    int GetSize() const;
+
+    T* GetData();
+    const T* GetData() const;
+
+    T& operator[]( int index );
+    const T& operator[]( int index ) const;
+
+    T* begin();
+    T* end();
+    const T* begin() const;
+    const T* end() const;
+
+private:
+    void _Allocate( int capacity );
+    void _Free();
+
+    char* _memory = nullptr;
+    T* _data = nullptr;
+
+    int _capacity = 0;
+    int _size = 0;
+};
+
+template <typename T>
+inline Block<T>::Block() = default;
+
+template <typename T>
+inline Block<T>::Block( int capacity )
+{
+    _Allocate( capacity );
+    _size = _capacity;
+}
+
+template <typename T>
+inline Block<T>::Block( const Block& other )
+{
+    _Allocate( other._capacity );
+    _size = other._size;
+
+    std::memcpy( _data, other._data, _size * sizeof( T ) );
+}
+
+template <typename T>
+inline Block<T>::Block( Block&& other ) noexcept
+    : _memory( other._memory )
+    , _data( other._data )
+    , _capacity( other._capacity )
+    , _size( other._size )
+{
+    other._memory = nullptr;
+    other._data = nullptr;
+    other._capacity = 0;
+    other._size = 0;
+}
+
+template <typename T>
+inline Block<T>::~Block()
+{
+    _Free();
+}
+
+template <typename T>
+inline Block<T>& Block<T>::operator=( const Block& other )
+{
+    if ( this != &other )
+    {
+        // reuse our storage wherever possible
+        if ( _capacity != other._capacity )
+        {
+            _Free();
+            _Allocate( other._capacity );
+        }
+
+        _size = other._size;
+
+        std::memcpy( _data, other._data, _size * sizeof( T ) );
+    }
+
+    return *this;
+}
+
+template <typename T>
+inline Block<T>& Block<T>::operator=( Block&& other ) noexcept
+{
+    if ( this != &other )
+    {
+        std::swap( _memory, other._memory );
+        std::swap( _data, other._data );
+        std::swap( _capacity, other._capacity );
+        std::swap( _size, other._size );
+    }
+
+    return *this;
+}
+
+template <typename T>
+inline Block<T>& Block<T>::Acquire( SignalBus& signalBus, int signalIndex, int capacity )
+{
+    auto block = signalBus.GetValue<Block<T>>( signalIndex );
+
+    if ( !block || block->_capacity != capacity )
+    {
+        signalBus.MoveValue( signalIndex, Block<T>( capacity ) );
+        block = signalBus.GetValue<Block<T>>( signalIndex );
+    }
+
+    return *block;
+}
+
+template <typename T>
+inline int Block<T>::GetCapacity() const
+{
+    return _capacity;
+}
+
+template <typename T>
+inline void Block<T>::SetSize( int size )
+{
+    _size = size < 0 ? 0 : ( size > _capacity ? _capacity : size );
+}
+
+template <typename T>
+inline int Block<T>::GetSize() const
+{
+    return _size;
+}
+
+template <typename T>
+inline T* Block<T>::GetData()
+{
+    return _data;
+}
+
+template <typename T>
+inline const T* Block<T>::GetData() const
+{
+    return _data;
+}
+
+template <typename T>
+inline T& Block<T>::operator[]( int index )
+{
+    return _data[index];
+}
+
+template <typename T>
+inline const T& Block<T>::operator[]( int index ) const
+{
+    return _data[index];
+}
+
+template <typename T>
+inline T* Block<T>::begin()
+{
+    return _data;
+}
+
+template <typename T>
+inline T* Block<T>::end()
+{
+    return _data + _size;
+}
+
+template <typename T>
+inline const T* Block<T>::begin() const
+{
+    return _data;
+}
+
+template <typename T>
+inline const T* Block<T>::end() const
+{
+    return _data + _size;
+}
+
+template <typename T>
+inline void Block<T>::_Allocate( int capacity )
+{
+    _capacity = capacity < 0 ? 0 : capacity;
+
+    if ( _capacity == 0 )
+    {
+        return;
+    }
+
+    // You might be thinking: Why not use aligned operator new here?
+
+    // Aligned allocation functions are not available on all of the platforms we support (E.g. macOS
+    // prior to 10.14), so instead we over-allocate by alignment - 1 bytes and align the data pointer
+    // within that allocation ourselves.
+
+    _memory = new char[_capacity * sizeof( T ) + alignment - 1];
+
+    const auto address = reinterpret_cast<std::uintptr_t>( _memory );
+    _data = reinterpret_cast<T*>( ( address + alignment - 1 ) & ~(std::uintptr_t)( alignment - 1 ) );
+}
+
+template <typename T>
+inline void Block<T>::_Free()
+{
+    delete[] _memory;
+
+    _memory = nullptr;
+    _data = nullptr;
+    _capacity = 0;
+    _size = 0;
+}
+
+}  // namespace DSPatch
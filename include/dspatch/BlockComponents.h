@@ -0,0 +1,280 @@
+/******************************************************************************
+DSPatch - The Refreshingly Simple C++ Dataflow Framework
+Copyright (c) 2025, Marcus Tomlinson
+
+BSD 2-Clause License
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include "Block.h"
+#include "Component.h"
+#include "Kernels.h"
+
+namespace DSPatch
+{
+
+/// Reference components for processing blocks of samples
+
+/**
+The following components process Block<float> signals using the vectorized kernels in the Kernels namespace. As they hold no state
+between ticks, they are constructed with ProcessOrder::OutOfOrder, allowing them to process multiple buffers in parallel.
+
+Each component writes its output into the block already held by its output signal (see Block::Acquire()), so a steady stream of
+equally sized blocks is processed without allocation. If a required input is missing (or is not a Block<float>), the output is
+cleared. Where inputs differ in size, only the overlapping elements are processed.
+
+- BlockAdd: out = in0 + in1
+- BlockMultiply: out = in0 * in1
+- BlockMin: out = min( in0, in1 )
+- BlockMax: out = max( in0, in1 )
+- BlockMultiplyAdd: out = in0 * in1 + in2
+- BlockMix: out = in0 * gain0 + in1 * gain1
+- BlockAbs: out = |in0|
+- BlockSum: out = sum of in0 (float)
+- BlockMinValue: out = minimum of in0 (float)
+- BlockMaxValue: out = maximum of in0 (float)
+- BlockToFloat: converts a Block<int16_t> of PCM samples to a Block<float> in the range [-1, 1)
+- BlockToInt16: converts a Block<float> in the range [-1, 1) to a Block<int16_t> of PCM samples (saturating)
+*/
+
+namespace internal
+{
+
+template <void ( *Kernel )( const float*, const float*, float*, int )>
+class BlockBinary : public Component
+{
+public:
+    BlockBinary()
+        : Component( ProcessOrder::OutOfOrder )
+    {
+        SetInputCount_( 2, { "in0", "in1" } );
+        SetOutputCount_( 1, { "out" } );
+    }
+
+protected:
+    void Process_( SignalBus& inputs, SignalBus& outputs ) override
+    {
+        const auto in0 = inputs.GetValue<Block<float>>( 0 );
+        const auto in1 = inputs.GetValue<Block<float>>( 1 );
+
+        if ( !in0 || !in1 )
+        {
+            outputs.ClearValue( 0 );
+            return;
+        }
+
+        auto& out = Block<float>::Acquire( outputs, 0, in0->GetCapacity() );
+        out.SetSize( std::min( in0->GetSize(), in1->GetSize() ) );
+
+        Kernel( in0->GetData(), in1->GetData(), out.GetData(), out.GetSize() );
+    }
+};
+
+template <float ( *Kernel )( const float*, int )>
+class BlockReduce : public Component
+{
+public:
+    BlockReduce()
+        : Component( ProcessOrder::OutOfOrder )
+    {
+        SetInputCount_( 1, { "in" } );
+        SetOutputCount_( 1, { "out" } );
+    }
+
+protected:
+    void Process_( SignalBus& inputs, SignalBus& outputs ) override
+    {
+        if ( const auto in = inputs.GetValue<Block<float>>( 0 ) )
+        {
+            outputs.SetValue( 0, Kernel( in->GetData(), in->GetSize() ) );
+        }
+        else
+        {
+            outputs.ClearValue( 0 );
+        }
+    }
+};
+
+template <typename FromType, typename ToType>
+class BlockConvert : public Component
+{
+public:
+    BlockConvert()
+        : Component( ProcessOrder::OutOfOrder )
+    {
+        SetInputCount_( 1, { "in" } );
+        SetOutputCount_( 1, { "out" } );
+    }
+
+protected:
+    void Process_( SignalBus& inputs, SignalBus& outputs ) override
+    {
+        const auto in = inputs.GetValue<Block<FromType>>( 0 );
+
+        if ( !in )
+        {
+            outputs.ClearValue( 0 );
+            return;
+        }
+
+        auto& out = Block<ToType>::Acquire( outputs, 0, in->GetCapacity() );
+        out.SetSize( in->GetSize() );
+
+        Kernels::Convert( in->GetData(), out.GetData(), out.GetSize() );
+    }
+};
+
+}  // namespace internal
+
+class BlockAdd final : public internal::BlockBinary<Kernels::Add>
+{
+};
+
+class BlockMultiply final : public internal::BlockBinary<Kernels::Multiply>
+{
+};
+
+class BlockMin final : public internal::BlockBinary<Kernels::Min>
+{
+};
+
+class BlockMax final : public internal::BlockBinary<Kernels::Max>
+{
+};
+
+class BlockSum final : public internal::BlockReduce<Kernels::Sum>
+{
+};
+
+class BlockMinValue final : public internal::BlockReduce<Kernels::MinValue>
+{
+};
+
+class BlockMaxValue final : public internal::BlockReduce<Kernels::MaxValue>
+{
+};
+
+class BlockToFloat final : public internal::BlockConvert<std::int16_t, float>
+{
+};
+
+class BlockToInt16 final : public internal::BlockConvert<float, std::int16_t>
+{
+};
+
+class BlockMultiplyAdd final : public Component
+{
+public:
+    BlockMultiplyAdd()
+        : Component( ProcessOrder::OutOfOrder )
+    {
+        SetInputCount_( 3, { "in0", "in1", "in2" } );
+        SetOutputCount_( 1, { "out" } );
+    }
+
+protected:
+    void Process_( SignalBus& inputs, SignalBus& outputs ) override
+    {
+        const auto in0 = inputs.GetValue<Block<float>>( 0 );
+        const auto in1 = inputs.GetValue<Block<float>>( 1 );
+        const auto in2 = inputs.GetValue<Block<float>>( 2 );
+
+        if ( !in0 || !in1 || !in2 )
+        {
+            outputs.ClearValue( 0 );
+            return;
+        }
+
+        auto& out = Block<float>::Acquire( outputs, 0, in0->GetCapacity() );
+        out.SetSize( std::min( std::min( in0->GetSize(), in1->GetSize() ), in2->GetSize() ) );
+
+        Kernels::MultiplyAdd( in0->GetData(), in1->GetData(), in2->GetData(), out.GetData(), out.GetSize() );
+    }
+};
+
+class BlockMix final : public Component
+{
+public:
+    explicit BlockMix( float gain0 = 0.5f, float gain1 = 0.5f )
+        : Component( ProcessOrder::OutOfOrder )
+        , _gain0( gain0 )
+        , _gain1( gain1 )
+    {
+        SetInputCount_( 2, { "in0", "in1" } );
+        SetOutputCount_( 1, { "out" } );
+    }
+
+protected:
+    void Process_( SignalBus& inputs, SignalBus& outputs ) override
+    {
+        const auto in0 = inputs.GetValue<Block<float>>( 0 );
+        const auto in1 = inputs.GetValue<Block<float>>( 1 );
+
+        if ( !in0 || !in1 )
+        {
+            outputs.ClearValue( 0 );
+            return;
+        }
+
+        auto& out = Block<float>::Acquire( outputs, 0, in0->GetCapacity() );
+        out.SetSize( std::min( in0->GetSize(), in1->GetSize() ) );
+
+        Kernels::Mix( in0->GetData(), _gain0, in1->GetData(), _gain1, out.GetData(), out.GetSize() );
+    }
+
+private:
+    const float _gain0;
+    const float _gain1;
+};
+
+class BlockAbs final : public Component
+{
+public:
+    BlockAbs()
+        : Component( ProcessOrder::OutOfOrder )
+    {
+        SetInputCount_( 1, { "in" } );
+        SetOutputCount_( 1, { "out" } );
+    }
+
+protected:
+    void Process_( SignalBus& inputs, SignalBus& outputs ) override
+    {
+        const auto in = inputs.GetValue<Block<float>>( 0 );
+
+        if ( !in )
+        {
+            outputs.ClearValue( 0 );
+            return;
+        }
+
+        auto& out = Block<float>::Acquire( outputs, 0, in->GetCapacity() );
+        out.SetSize( in->GetSize() );
+
+        Kernels::Abs( in->GetData(), out.GetData(), out.GetSize() );
+    }
+};
+
+}  // namespace DSPatch
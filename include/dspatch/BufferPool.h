@@ -0,0 +1,346 @@
+/******************************************************************************
+DSPatch - The Refreshingly Simple C++ Dataflow Framework
+Copyright (c) 2025, Marcus Tomlinson
+
+BSD 2-Clause License
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace DSPatch
+{
+
+/// Recyclable typed object pool for large signal payloads
+
+/**
+A BufferPool hands out shared buffers of type T that return to the pool automatically once the last reference to them is
+released. This allows components that emit large payloads (E.g. audio blocks, image frames) to reuse the same few allocations
+tick after tick, rather than allocating a fresh container whenever a signal is moved out from under them.
+
+A circuit keeps one pool per payload type, accessible via Circuit::GetBufferPool(). Producers typically retain the pool from
+construction and Acquire() a buffer from within Process_(), writing it to their output bus via SignalBus::SetValue(). As the
+signal value is a shared pointer, fan-out copies between components are reference counted rather than deep copied.
+
+<b>NOTE:</b> A buffer acquired from a pool is not reset. It contains whatever data it was last released with, so producers should
+overwrite (or resize) its contents before use. Once a buffer has been emitted, consumers should treat it as read-only, as it may
+be shared with other consumers.
+
+Pool statistics are exposed via GetSize() (total buffers allocated), GetAvailableCount() (buffers idle in the pool),
+GetInUseCount() (buffers currently referenced elsewhere), and GetHighWaterCount() (the most buffers ever in use at once). Each
+is kept up to date as buffers are acquired and released, so reading them costs no more than acquiring a buffer. Acquired buffers
+may outlive their pool, in which case they are freed on release.
+*/
+
+template <typename T>
+class BufferPool final
+{
+public:
+    BufferPool( const BufferPool& ) = delete;
+    BufferPool& operator=( const BufferPool& ) = delete;
+
+    using SPtr = std::shared_ptr<BufferPool<T>>;
+    using Buffer = std::shared_ptr<T>;
+
+    BufferPool();
+    ~BufferPool();
+
+    template <typename... Args>
+    Buffer Acquire( const Args&... args );
+
+    template <typename... Args>
+    void Reserve( int bufferCount, const Args&... args );
+
+    void Trim();
+
+    int GetSize() const;
+    int GetAvailableCount() const;
+    int GetInUseCount() const;
+    int GetHighWaterCount() const;
+
+private:
+    // state shared with acquired buffers, which return themselves to it on release (even after the pool is destroyed)
+    struct State final
+    {
+        ~State();
+
+        std::mutex mutex;
+
+        std::vector<std::unique_ptr<T>> freeBuffers;
+        std::vector<void*> freeControlBlocks;  // buffers' shared_ptr control blocks (all of the same size)
+
+        int inUseCount = 0;
+        int highWaterCount = 0;
+        int controlBlockCount = 0;
+    };
+
+    // returns a released buffer to the pool
+    class Releaser final
+    {
+    public:
+        explicit Releaser( const std::shared_ptr<State>& state );
+
+        void operator()( T* buffer ) const;
+
+    private:
+        std::shared_ptr<State> _state;
+    };
+
+    // recycles the control blocks of acquired buffers
+    template <typename U>
+    class ControlBlockAllocator  // (not final, as std::shared_ptr may derive from its allocator)
+    {
+    public:
+        using value_type = U;
+
+        explicit ControlBlockAllocator( const std::shared_ptr<State>& state );
+
+        template <typename V>
+        ControlBlockAllocator( const ControlBlockAllocator<V>& other );
+
+        U* allocate( size_t count );
+        void deallocate( U* block, size_t count );
+
+        template <typename V>
+        bool operator==( const ControlBlockAllocator<V>& other ) const;
+
+        template <typename V>
+        bool operator!=( const ControlBlockAllocator<V>& other ) const;
+
+        std::shared_ptr<State> state;
+    };
+
+    std::shared_ptr<State> _state;
+};
+
+template <typename T>
+inline BufferPool<T>::BufferPool()
+    : _state( std::make_shared<State>() )
+{
+}
+
+template <typename T>
+inline BufferPool<T>::~BufferPool() = default;
+
+template <typename T>
+template <typename... Args>
+inline typename BufferPool<T>::Buffer BufferPool<T>::Acquire( const Args&... args )
+{
+    // You might be thinking: Why not just hand out shared_ptrs held by the pool, and scan for unshared ones?
+
+    // Finding a free buffer that way takes a scan over the pool, as does counting the buffers in use. Instead, each buffer is
+    // handed out with a deleter that returns it to a free list, so both take constant time. Its control block is recycled via
+    // the pool too, so once the pool has warmed up, Acquire() allocates nothing. The most recently released buffer is reused
+    // first, as its contents are the most likely to still be in cache.
+
+    std::unique_ptr<T> buffer;
+
+    {
+        std::lock_guard<std::mutex> lock( _state->mutex );
+
+        if ( !_state->freeBuffers.empty() )
+        {
+            buffer = std::move( _state->freeBuffers.back() );
+            _state->freeBuffers.pop_back();
+        }
+        else
+        {
+            // make room for every buffer to be released at once, so that releasing one never allocates
+            _state->freeBuffers.reserve( _state->inUseCount + 1 );
+        }
+
+        ++_state->inUseCount;
+        _state->highWaterCount = std::max( _state->highWaterCount, _state->inUseCount );
+    }
+
+    if ( !buffer )
+    {
+        // every buffer is in use, grow the pool
+        try
+        {
+            buffer = std::make_unique<T>( args... );
+        }
+        catch ( ... )
+        {
+            std::lock_guard<std::mutex> lock( _state->mutex );
+            --_state->inUseCount;
+            throw;
+        }
+    }
+
+    // (should allocating the control block throw, the buffer is returned to the pool via its Releaser)
+    return Buffer( buffer.release(), Releaser( _state ), ControlBlockAllocator<T>( _state ) );
+}
+
+template <typename T>
+template <typename... Args>
+inline void BufferPool<T>::Reserve( int bufferCount, const Args&... args )
+{
+    std::lock_guard<std::mutex> lock( _state->mutex );
+
+    while ( (int)_state->freeBuffers.size() + _state->inUseCount < bufferCount )
+    {
+        _state->freeBuffers.emplace_back( std::make_unique<T>( args... ) );
+    }
+}
+
+template <typename T>
+inline void BufferPool<T>::Trim()
+{
+    std::lock_guard<std::mutex> lock( _state->mutex );
+
+    // drop all idle buffers (in-use buffers are returned to the pool by their final external reference)
+    _state->freeBuffers.clear();
+}
+
+template <typename T>
+inline int BufferPool<T>::GetSize() const
+{
+    std::lock_guard<std::mutex> lock( _state->mutex );
+
+    return (int)_state->freeBuffers.size() + _state->inUseCount;
+}
+
+template <typename T>
+inline int BufferPool<T>::GetAvailableCount() const
+{
+    std::lock_guard<std::mutex> lock( _state->mutex );
+
+    return (int)_state->freeBuffers.size();
+}
+
+template <typename T>
+inline int BufferPool<T>::GetInUseCount() const
+{
+    std::lock_guard<std::mutex> lock( _state->mutex );
+
+    return _state->inUseCount;
+}
+
+template <typename T>
+inline int BufferPool<T>::GetHighWaterCount() const
+{
+    std::lock_guard<std::mutex> lock( _state->mutex );
+
+    return _state->highWaterCount;
+}
+
+template <typename T>
+inline BufferPool<T>::State::~State()
+{
+    for ( auto block : freeControlBlocks )
+    {
+        ::operator delete( block );
+    }
+}
+
+template <typename T>
+inline BufferPool<T>::Releaser::Releaser( const std::shared_ptr<State>& state )
+    : _state( state )
+{
+}
+
+template <typename T>
+inline void BufferPool<T>::Releaser::operator()( T* buffer ) const
+{
+    std::lock_guard<std::mutex> lock( _state->mutex );
+
+    // (room was reserved on Acquire(), so this never throws)
+    _state->freeBuffers.emplace_back( buffer );
+    --_state->inUseCount;
+}
+
+template <typename T>
+template <typename U>
+inline BufferPool<T>::ControlBlockAllocator<U>::ControlBlockAllocator( const std::shared_ptr<State>& state )
+    : state( state )
+{
+}
+
+template <typename T>
+template <typename U>
+template <typename V>
+inline BufferPool<T>::ControlBlockAllocator<U>::ControlBlockAllocator( const ControlBlockAllocator<V>& other )
+    : state( other.state )
+{
+}
+
+template <typename T>
+template <typename U>
+inline U* BufferPool<T>::ControlBlockAllocator<U>::allocate( size_t count )
+{
+    {
+        std::lock_guard<std::mutex> lock( state->mutex );
+
+        if ( count == 1 && !state->freeControlBlocks.empty() )
+        {
+            auto block = state->freeControlBlocks.back();
+            state->freeControlBlocks.pop_back();
+            return static_cast<U*>( block );
+        }
+
+        // make room for every control block to be released at once, so that releasing one never allocates
+        state->freeControlBlocks.reserve( ++state->controlBlockCount );
+    }
+
+    return static_cast<U*>( ::operator new( count * sizeof( U ) ) );
+}
+
+template <typename T>
+template <typename U>
+inline void BufferPool<T>::ControlBlockAllocator<U>::deallocate( U* block, size_t count )
+{
+    std::lock_guard<std::mutex> lock( state->mutex );
+
+    if ( count != 1 )
+    {
+        --state->controlBlockCount;
+        ::operator delete( block );
+        return;
+    }
+
+    state->freeControlBlocks.emplace_back( block );
+}
+
+template <typename T>
+template <typename U>
+template <typename V>
+inline bool BufferPool<T>::ControlBlockAllocator<U>::operator==( const ControlBlockAllocator<V>& other ) const
+{
+    return state == other.state;
+}
+
+template <typename T>
+template <typename U>
+template <typename V>
+inline bool BufferPool<T>::ControlBlockAllocator<U>::operator!=( const ControlBlockAllocator<V>& other ) const
+{
+    return state != other.state;
+}
+
+}  // namespace DSPatch
@@ -28,7 +28,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #pragma once
 
+#include "BufferPool.h"
 #include "Component.h"
+#include "ComponentArena.h"
+#include "ComponentFactory.h"
 
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
@@ -38,12 +41,56 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <algorithm>
 #include <condition_variable>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <sstream>
 #include <thread>
-#include <unordered_set>
+#include <typeindex>
+#include <unordered_map>
+
+#ifndef DSPATCH_SPIN_BUDGET
+#define DSPATCH_SPIN_BUDGET 100000  // ns a low-latency worker spins for the next tick before parking
+#endif
+
+#ifndef DSPATCH_SHARD_BACKLOG
+#define DSPATCH_SHARD_BACKLOG 16  // most ticks a sharded thread may have queued before Tick() waits for it
+#endif
+
+#ifndef DSPATCH_CLOCK_PERIOD_LIMIT
+#define DSPATCH_CLOCK_PERIOD_LIMIT 4096  // longest combined clock divider period planned tick by tick
+#endif
 
 namespace DSPatch
 {
 
+/// Lightweight handle to a component within a circuit
+
+/**
+A ComponentId is a generation-checked index into its circuit's component slot table. Unlike a Component::SPtr, it can be
+copied, stored and compared without touching a reference count, and it doesn't keep its component alive. Each slot's
+generation is incremented when its component is removed, so a ComponentId of a removed component is rejected rather than
+addressing whichever component reuses the slot. A default constructed ComponentId is invalid.
+*/
+
+struct ComponentId final
+{
+    uint32_t index = std::numeric_limits<uint32_t>::max();
+    uint32_t generation = 0;
+
+    bool operator==( const ComponentId& other ) const
+    {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool operator!=( const ComponentId& other ) const
+    {
+        return !( *this == other );
+    }
+};
+
 /// Workspace for adding and routing components
 
 /**
@@ -67,6 +114,11 @@ thread will spawn, automatically calling Tick() continuously until PauseAutoTick
 The Circuit Optimize() method rearranges components such that they process in the most optimal order during Tick(). This
 optimization will occur automatically during the first Tick() proceeding any connection / disconnection, however, if you'd like to
 pre-order components before the next Tick() is processed, you can call Optimize() manually.
+
+How a circuit schedules and lays out its ticks can be tuned to its workload (see SetReorderingEnabled(), SetCallerRunsEnabled(),
+SetLowLatencyEnabled(), SetShardingEnabled(), SetCompactionEnabled() and SetClockDivider()), and it can be measured at runtime
+(see GetStats(), GetLatencyStats(), SetFlightRecorderEnabled() and ExportDot()). Large circuits can be edited in bulk (see
+BeginEdit()), and saved and reloaded (see SaveTopology()).
 */
 
 class Circuit final
@@ -79,23 +131,125 @@ public:
     ~Circuit();
 
     bool AddComponent( const Component::SPtr& component );
+    bool AddComponent( const Component::SPtr& component, ComponentId& id );
+
+    // Rather than allocating a component individually (E.g. via std::make_shared()) and adding it, Emplace() constructs it
+    // directly in the circuit's ComponentArena, then adds it. Components emplaced one after the other sit side by side in
+    // memory, so when a circuit is built in dataflow order, the components it ticks in sequence are also close together in
+    // memory.
+    template <typename T, typename... Args>
+    std::shared_ptr<T> Emplace( Args&&... args );
 
     bool RemoveComponent( const Component::SPtr& component );
+    bool RemoveComponent( ComponentId id );
     void RemoveAllComponents();
 
     int GetComponentCount() const;
 
+    // Components can also be addressed by ComponentId, as returned by AddComponent() or GetComponentId(). Each ComponentId
+    // overload indexes straight into the circuit's component slot table (the Component::SPtr overloads look up the
+    // component's slot by address, then do the same). GetComponent() returns the component behind a ComponentId, or
+    // nullptr if it has since been removed. While editing, AddComponent() can't assign a ComponentId (the component is
+    // added on Commit()), so it sets an invalid one; call GetComponentId() after Commit() instead.
+    ComponentId GetComponentId( const Component::SPtr& component ) const;
+    Component::SPtr GetComponent( ComponentId id ) const;
+
     bool ConnectOutToIn( const Component::SPtr& fromComponent, int fromOutput, const Component::SPtr& toComponent, int toInput );
+    bool ConnectOutToIn( ComponentId fromComponent, int fromOutput, ComponentId toComponent, int toInput );
 
     bool DisconnectComponent( const Component::SPtr& component );
+    bool DisconnectComponent( ComponentId id );
     void DisconnectAllComponents();
 
+    // Each AddComponent(), RemoveComponent(), ConnectOutToIn() and DisconnectComponent() call pauses (and syncs) the
+    // circuit, and each change to its wiring is followed by a full Optimize(). To build or rewire large circuits in bulk,
+    // call BeginEdit() first. Until the matching Commit(), these calls are queued rather than applied (returning true).
+    // Commit() then validates the queued edits in order, in one pass, and applies them all under a single pause, followed
+    // by a single Optimize(). If any queued edit is invalid (E.g. connecting a component that isn't in the circuit, or
+    // wasn't added earlier in the edit), Commit() discards every queued edit and returns false, leaving the circuit
+    // untouched. BeginEdit() / Commit() pairs may be nested, in which case the edits are applied by the outermost
+    // Commit().
+    void BeginEdit();
+    bool Commit();
+
     void SetBufferCount( int bufferCount );
     int GetBufferCount() const;
 
+    // Configures how each in-order component's buffers wait for their turn to process (see Component::WaitStrategy).
+    void SetWaitStrategy( Component::WaitStrategy waitStrategy );
+    Component::WaitStrategy GetWaitStrategy() const;
+
+    // In a multi-buffered circuit, a buffer thread that reaches an in-order component before that component's previous
+    // buffer has been processed would otherwise stall there, along with all the work after it. Reordering lets buffer
+    // threads defer such components (and anything downstream of them) until the rest of their tick has been processed, so
+    // that independent out-of-order work carries on meanwhile. Deferred components still process their buffers in order,
+    // and within each buffer, every component still processes after its inputs. Reordering is ignored for circuits with
+    // feedback wires, and for circuits with threads.
+    void SetReorderingEnabled( bool enabled );
+    bool GetReorderingEnabled() const;
+
     void SetThreadCount( int threadCount );
     int GetThreadCount() const;
 
+    // By default, Tick() in a circuit with threads hands the whole tick to its threads and returns, leaving the calling
+    // thread idle until the next Tick(). For latency-sensitive single-buffered circuits, caller-runs mode instead has the
+    // calling thread process the first thread's share of each tick itself, then wait for the other threads to finish
+    // theirs before returning. This saves a thread wake-up per tick, and means each tick is complete by the time Tick()
+    // returns.
+    void SetCallerRunsEnabled( bool enabled );
+    bool GetCallerRunsEnabled() const;
+
+    // For ticks of only a few microseconds, parking and waking threads via condition variables can cost more than the tick
+    // itself. Low-latency mode keeps a circuit's threads hot between ticks instead: each spins on its buffer's shared tick
+    // generation counter for up to DSPATCH_SPIN_BUDGET nanoseconds (default: 100μs) before parking, and the last thread to
+    // finish a tick releases Sync() via a sense-reversing barrier. This lets small parallel graphs benefit from threads,
+    // at the cost of keeping their cores busy while the circuit is ticking. Low-latency threads run at normal priority (so
+    // that their spinning yields to other threads), and should not outnumber the available cores.
+    void SetLowLatencyEnabled( bool enabled );
+    bool GetLowLatencyEnabled() const;
+
+    // By default, a circuit's threads share out its components level by level, syncing with each other wherever a wire
+    // crosses threads. When a circuit hosts several independent subgraphs (E.g. one per channel), sharding instead has
+    // Optimize() split it into its weakly connected components ("shards"), and deal whole shards out to its threads. Each
+    // thread then ticks its shards serially, without waiting on any other thread: rather than syncing all threads each
+    // tick, Tick() queues the tick on each thread, and only waits for a thread that already has DSPATCH_SHARD_BACKLOG
+    // ticks (default: 16) queued. A slow shard therefore only holds back the shards sharing its thread, as long as it
+    // catches up within the backlog. Sync() still waits for every queued tick. (Latency stats, the flight recorder,
+    // caller-runs and low-latency modes time or share out each tick as a whole, so with any of these enabled, each tick is
+    // synced as without sharding.)
+    void SetShardingEnabled( bool enabled );
+    bool GetShardingEnabled() const;
+
+    // What's touched most each tick is not the component objects themselves but their runtime state: each buffer's buses,
+    // reference counters and resolved input wires. Compaction has Optimize() finish by relocating every component's
+    // runtime state into a fresh ComponentArena in tick order (however its components were allocated), so that ticking the
+    // circuit walks forward through memory. Each pass costs a copy of the circuit's runtime state, and is repeated
+    // whenever the circuit is re-optimized.
+    void SetCompactionEnabled( bool enabled );
+    bool GetCompactionEnabled() const;
+
+    // Components that only need to process every Nth tick (E.g. control-rate envelopes and parameter smoothers) can be
+    // given a clock divider. Optimize() folds the circuit's dividers into a clock plan: one list of components per phase
+    // of the dividers' combined period, so each Tick() runs through just the components due that tick. Should that period
+    // (the least common multiple of the dividers) exceed DSPATCH_CLOCK_PERIOD_LIMIT ticks (default: 4096), Tick() checks
+    // each component's divider against the tick sequence number instead. Consumers of an idle component's outputs see them
+    // held at their last values, or absent (see Component::IdleOutput).
+    //
+    // Clock dividers apply to circuits that tick each tick's components in series on one buffer (a buffer count of 0 or 1,
+    // and no threads), so this returns false (leaving the divider as it was) for a multi-buffered or multi-threaded
+    // circuit. Should such a circuit already have dividers (E.g. it was clocked before SetBufferCount() /
+    // SetThreadCount(), or its components were given dividers before being added), they are suspended until the circuit
+    // returns to a single buffer and no threads.
+    bool SetClockDivider( const Component::SPtr& component,
+                          int clockDivider,
+                          Component::IdleOutput idleOutput = Component::IdleOutput::Hold );
+    bool SetClockDivider( ComponentId id, int clockDivider, Component::IdleOutput idleOutput = Component::IdleOutput::Hold );
+
+    // For sample and vector processing circuits, configures the capacity with which components should create their Block
+    // signals (default: 256).
+    void SetBlockSize( int blockSize );
+    int GetBlockSize() const;
+
     void Tick();
     void Sync();
 
@@ -106,6 +260,76 @@ public:
 
     void Optimize();
 
+    // Components that emit large payloads can recycle them via the circuit's typed buffer pools. Returns the circuit's
+    // BufferPool for a given payload type (creating it on first request), from which producers can acquire buffers in
+    // Process_().
+    template <typename T>
+    typename BufferPool<T>::SPtr GetBufferPool();
+
+    // When DSPatch is compiled with DSPATCH_ENABLE_STATS defined, returns a snapshot of the time spent per tick, as well
+    // as the time each component spent gathering inputs, waiting, and processing (see CircuitStats). Stats are recorded
+    // lock-free by the threads doing the work, so this can be called while the circuit is auto-ticking. Stats also count
+    // how the signals gathered by each component input were delivered (moved, copied or null), and how many bytes were
+    // copied (see WireStats and SetSignalSizeHook()). Likewise, with DSPATCH_ENABLE_TRACE defined, the circuit's thread
+    // syncs / resumes and auto-tick pauses / resumes are recorded as timeline events (see StartTrace()), and with
+    // DSPATCH_ENABLE_PROBES defined, USDT probes are compiled in (see Probes.h).
+    CircuitStats GetStats() const;
+    void ResetStats();
+
+    // Unlike stats, end-to-end tick latency is measured at runtime, and is cheap enough to leave enabled in production.
+    // Once enabled, GetLatencyStats() returns histograms of the time each buffer waited for its circuit thread(s) to pick
+    // it up, and the time from submission (in Tick()) until all of its components finished processing (see LatencyStats).
+    // This shows the latency cost of multi-buffering alongside its throughput gain.
+    void SetLatencyStatsEnabled( bool enabled );
+    bool GetLatencyStatsEnabled() const;
+
+    LatencyStats GetLatencyStats() const;
+    void ResetLatencyStats();
+
+    // The flight recorder is also cheap enough to leave running in production. Once enabled, every thread ticking the
+    // circuit logs its last DSPATCH_FLIGHT_RECORDER_CAPACITY component executions (with timestamps, buffer and thread)
+    // into a fixed-size ring, without locks or allocation. SetFlightRecorderTrigger() dumps them automatically (see
+    // DumpFlightRecord()) whenever a buffer's tick takes longer than a given threshold, capturing what led up to the
+    // anomaly. Each dump overwrites the last, and further triggers are ignored until DSPATCH_FLIGHT_RECORDER_CAPACITY more
+    // ticks have passed, so sustained slowness can't flood the disk.
+    void SetFlightRecorderEnabled( bool enabled );
+    bool GetFlightRecorderEnabled() const;
+
+    void SetFlightRecorderTrigger( uint64_t tickTimeThreshold, const std::string& filePath );
+    int GetFlightRecorderDumpCount() const;
+
+    std::vector<FlightRecord> GetFlightRecord() const;
+
+    // Writes the recorded executions in a compact binary form (in host byte order): the 8 byte magic "DSPFLTR1"; uint64
+    // trigger threshold and tick time (0 if dumped on demand); int32 trigger buffer (-1 if dumped on demand); uint32
+    // component count, followed by each component's type name (uint32 length + characters) in process order; uint32 record
+    // count, followed by each FlightRecord as int32 componentIndex, int32 bufferNo, int32 threadNo, uint64 startTime and
+    // uint64 endTime, ordered by startTime.
+    void DumpFlightRecord( std::ostream& stream ) const;
+    bool DumpFlightRecord( const std::string& filePath ) const;
+
+    // Writes the circuit's topology (as a Graphviz DOT graph, or as JSON) with a performance overlay. Each component is
+    // annotated with its parallel level (the depth at which SetThreadCount() threads can process it), the circuit thread
+    // it's assigned to (-1 if not multi-threaded), and whether it's on the critical path: the chain of wires with the
+    // highest total Process_() time, which bounds how fast a tick can be processed however many threads are used. With
+    // DSPATCH_ENABLE_STATS defined, components are also annotated with their Process_() times, and wires with their signal
+    // traffic (fan-out wires that copy are highlighted), and the critical path is weighted by mean Process_() time
+    // (without stats, it's simply the longest chain). Feedback wires are marked, and ignored by the critical path.
+    void ExportDot( std::ostream& stream );
+    void ExportJson( std::ostream& stream );
+
+    // Large circuits can be saved and reloaded much faster than they can be rebuilt component by component. SaveTopology()
+    // writes the circuit's components (by type id, see ComponentFactory), wires, buffer / thread counts, block size and
+    // optimized processing order in a compact binary form. LoadTopology() replaces the circuit's contents with a saved
+    // topology in a single pass, creating its components via a ComponentFactory, and without re-scanning the processing
+    // order. SaveTopologyJson() writes the same topology as JSON (for inspection and diffing, it can't be loaded).
+    //
+    // Only topology is saved. Component state (E.g. parameters) should be restored via the components returned by
+    // LoadTopology(), which are in the order they were saved: processing order.
+    void SaveTopology( std::ostream& stream );
+    void SaveTopologyJson( std::ostream& stream );
+    bool LoadTopology( std::istream& stream, const ComponentFactory& factory, std::vector<Component::SPtr>& components );
+
 private:
     class AutoTickThread final
     {
@@ -152,6 +376,8 @@ private:
         {
             if ( !_stopped && ++pauseCount == 1 )
             {
+                DSPATCH_TRACE( internal::TraceScope traceScope( "PauseAutoTick" ); )
+
                 std::unique_lock<std::mutex> lock( _resumeMutex );
                 _pause = true;
                 _pauseCondt.wait( lock );  // wait for pause
@@ -162,6 +388,8 @@ private:
         {
             if ( _pause && --pauseCount == 0 )
             {
+                DSPATCH_TRACE( internal::TraceInstant( "ResumeAutoTick" ); )
+
                 _pause = false;
                 _resumeCondt.notify_all();
                 std::this_thread::yield();
@@ -171,6 +399,8 @@ private:
     private:
         inline void _Run()
         {
+            DSPATCH_TRACE( internal::SetTraceThreadName( "AutoTickThread" ); )
+
             if ( _circuit )
             {
                 while ( true )
@@ -229,6 +459,8 @@ private:
             _bufferNo = bufferNo;
             _loneBuffer = bufferCount <= 1;
 
+            _clockPhases = nullptr;
+
             _stop = false;
             _gotSync = false;
 
@@ -249,6 +481,8 @@ private:
 
         inline void Sync()
         {
+            DSPATCH_TRACE( internal::TraceScope traceScope( "Sync", _bufferNo ); )
+
             std::unique_lock<std::mutex> lock( _syncMutex );
 
             if ( !_gotSync )  // if haven't already got sync
@@ -259,17 +493,93 @@ private:
 
         inline void Resume()
         {
+            DSPATCH_TRACE( internal::TraceInstant( "Resume", _bufferNo ); )
+
             _gotSync = false;  // reset the sync flag
             _resumeCondt.notify_all();
             std::this_thread::yield();
         }
 
+        inline void Submit( uint64_t submitTime )
+        {
+            // time the next tick (must be followed by a Resume())
+            _submitTime = submitTime;
+            _timed = true;
+        }
+
+        inline bool CollectLatency( uint64_t& submitTime, uint64_t& startTime, uint64_t& endTime )
+        {
+            // must follow a Sync()
+            if ( !_timed )
+            {
+                return false;
+            }
+
+            _timed = false;
+
+            submitTime = _submitTime;
+            startTime = _startTime;
+            endTime = _endTime;
+
+            return true;
+        }
+
+        inline bool CollectTickSpan( uint64_t& startTime, uint64_t& endTime )
+        {
+            // must follow a Sync()
+            if ( !_spanned )
+            {
+                return false;
+            }
+
+            _spanned = false;
+
+            startTime = _startTime;
+            endTime = _endTime;
+
+            return true;
+        }
+
+        inline void SetFlightRing( internal::FlightRing* flightRing )
+        {
+            // must follow a Sync() (takes effect from the next tick)
+            _flightRing = flightRing;
+        }
+
+        inline void SetComponentSources( const std::vector<std::vector<int>>* componentSources )
+        {
+            // must follow a Sync() (takes effect from the next tick, nullptr disables reordering)
+            _componentSources = componentSources;
+        }
+
+        inline void SetClockPlan( const std::vector<std::vector<DSPatch::Component*>>* clockPhases,
+                                  const std::vector<int>* clockPhaseIndices,
+                                  uint64_t tickSequence )
+        {
+            // must follow a Sync() (takes effect from the next tick, nullptr ticks every component every tick)
+            _clockPhases = clockPhases;
+            _clockPhaseIndices = clockPhaseIndices;
+            _clockSequence = tickSequence;
+        }
+
         inline void SyncAndResume()
         {
             Sync();
             Resume();
         }
 
+#ifdef DSPATCH_ENABLE_STATS
+        inline const internal::AtomicHistogram& GetTickTime() const
+        {
+            return _tickTime;
+        }
+
+        inline void ResetTickTime()
+        {
+            _tickTime.Reset();
+        }
+#endif
+
     private:
         inline void _Run()
         {
@@ -281,6 +591,8 @@ private:
             pthread_setschedparam( pthread_self(), SCHED_RR, &sch_params );
 #endif
 
+            DSPATCH_TRACE( internal::SetTraceThreadName( "CircuitThread " + std::to_string( _bufferNo ) ); )
+
             if ( _components )
             {
                 while ( true )
@@ -298,6 +610,13 @@ private:
                         break;
                     }
 
+                    internal::GetThreadFlightRing() = _flightRing;
+
+                    if ( _timed || _flightRing )
+                    {
+                        _startTime = internal::StatsNow();
+                    }
+
                     // You might be thinking: Can't we have each thread start on a different component?
 
                     // Well no. In order to maintain synchronisation within the circuit, when a component
@@ -307,13 +626,27 @@ private:
 
                     // E.g. 1,2,3 and 1,2,3. Not 1,2,3 and 2,3,1,2,3.
 
+                    DSPATCH_STATS( const auto startTime = internal::StatsClock::now(); )
+
                     if ( _loneBuffer )
                     {
-                        for ( auto component : *_components )
+                        if ( _clockPhases )
+                        {
+                            // a lone buffer processes every tick, so it can keep its own place in the clock plan
+                            Circuit::_TickClocked( *_clockPhases, *_clockPhaseIndices, _clockSequence++ );
+                        }
+                        else
                         {
-                            component->Tick();
+                            for ( auto component : *_components )
+                            {
+                                component->Tick();
+                            }
                         }
                     }
+                    else if ( _componentSources )
+                    {
+                        _TickReordered();
+                    }
                     else
                     {
                         for ( auto component : *_components )
@@ -321,18 +654,229 @@ private:
                             component->Tick( _bufferNo );
                         }
                     }
+
+                    DSPATCH_STATS( _tickTime.Record( internal::StatsElapsed( startTime, internal::StatsClock::now() ) ); )
+
+                    if ( _timed || _flightRing )
+                    {
+                        _endTime = internal::StatsNow();
+                        _spanned = _flightRing != nullptr;
+                    }
+                }
+            }
+        }
+
+        inline void _TickReordered()
+        {
+            const auto& components = *_components;
+            const auto& componentSources = *_componentSources;
+
+            _deferred.resize( components.size() );
+
+            for ( size_t i = 0; i < components.size(); ++i )
+            {
+                // defer in-order components still waiting on their previous buffer, and anything downstream of those
+                auto defer = !components[i]->IsBufferReleased( _bufferNo );
+
+                if ( !defer && !_deferredComponents.empty() )
+                {
+                    for ( auto source : componentSources[i] )
+                    {
+                        if ( _deferred[source] )
+                        {
+                            defer = true;
+                            break;
+                        }
+                    }
+                }
+
+                if ( defer )
+                {
+                    _deferred[i] = true;
+                    _deferredComponents.emplace_back( (int)i );
+                }
+                else
+                {
+                    components[i]->Tick( _bufferNo );
                 }
             }
+
+            // now process the deferred components, in order (waiting for their turns as usual)
+            for ( auto i : _deferredComponents )
+            {
+                components[i]->Tick( _bufferNo );
+                _deferred[i] = false;
+            }
+
+            _deferredComponents.clear();
         }
 
         std::thread _thread;
         std::vector<DSPatch::Component*>* _components = nullptr;
+        const std::vector<std::vector<int>>* _componentSources = nullptr;  // see Circuit::_UpdateReorderPlan()
+        const std::vector<std::vector<DSPatch::Component*>>* _clockPhases = nullptr;  // see Circuit::_UpdateClockPlan()
+        const std::vector<int>* _clockPhaseIndices = nullptr;
+        uint64_t _clockSequence = 0;
+        std::vector<char> _deferred;                                       // per component: deferred this tick
+        std::vector<int> _deferredComponents;
         int _bufferNo = 0;
         bool _loneBuffer = false;
         bool _stop = false;
         bool _gotSync = false;
         std::mutex _syncMutex;
         std::condition_variable _resumeCondt, _syncCondt;
+
+        bool _timed = false;
+        uint64_t _submitTime = 0;
+        uint64_t _startTime = 0;
+        uint64_t _endTime = 0;
+
+        internal::FlightRing* _flightRing = nullptr;
+        bool _spanned = false;
+
+        DSPATCH_STATS( internal::AtomicHistogram _tickTime; )
+    };
+
+    class SpinGroup final
+    {
+    public:
+        SpinGroup( const SpinGroup& ) = delete;
+        SpinGroup& operator=( const SpinGroup& ) = delete;
+
+        inline explicit SpinGroup( int workerCount )
+            : _workerCount( workerCount )
+            , _remaining( workerCount )
+        {
+        }
+
+        inline uint64_t GetGeneration() const
+        {
+            return _generation.load( std::memory_order_relaxed );
+        }
+
+        inline void Release()
+        {
+            if ( _workerCount == 0 )
+            {
+                return;
+            }
+
+            // start the next tick (seq_cst, so that either we see a worker parking, or it sees this increment)
+            _generation.fetch_add( 1 );
+
+            if ( _parkedCount.load() != 0 )
+            {
+                std::lock_guard<std::mutex> lock( _mutex );
+                _condt.notify_all();
+            }
+        }
+
+        inline void Wait() const
+        {
+            if ( _workerCount == 0 )
+            {
+                return;
+            }
+
+            DSPATCH_TRACE( internal::TraceScope traceScope( "Sync" ); )
+
+            // You might be thinking: Why flip a sense flag rather than wait for a count to reach 0?
+
+            // The count is reset for the next tick by the last worker to finish this one, before it flips the
+            // sense. So by the time we see the sense flip, the count is ready for the next Release(), and no
+            // worker can be confused by a count left over from the previous tick.
+
+            const auto sense = ( GetGeneration() & 1 ) != 0;
+
+            int spinCount = 0;
+
+            while ( _sense.load( std::memory_order_acquire ) != sense )
+            {
+                if ( ++spinCount % 64 == 0 )
+                {
+                    std::this_thread::yield();
+                }
+                else
+                {
+                    internal::CpuRelax();
+                }
+            }
+        }
+
+        inline bool WaitForRelease( uint64_t& generation, const std::atomic<bool>& stop )
+        {
+            // spin for the next tick, parking if it doesn't come within our spin budget
+            const auto spinEnd = internal::StatsNow() + DSPATCH_SPIN_BUDGET;
+
+            int spinCount = 0;
+
+            while ( _generation.load( std::memory_order_acquire ) == generation && !stop )
+            {
+                if ( ++spinCount % 64 != 0 )
+                {
+                    internal::CpuRelax();
+                }
+                else if ( internal::StatsNow() < spinEnd )
+                {
+                    std::this_thread::yield();
+                }
+                else
+                {
+                    std::unique_lock<std::mutex> lock( _mutex );
+
+                    _parkedCount.fetch_add( 1 );
+                    _condt.wait( lock, [&] { return _generation.load() != generation || stop; } );
+                    _parkedCount.fetch_sub( 1 );
+                }
+            }
+
+            if ( stop )
+            {
+                return false;
+            }
+
+            ++generation;
+            return true;
+        }
+
+        inline void Arrive( uint64_t generation )
+        {
+            if ( _remaining.fetch_sub( 1, std::memory_order_acq_rel ) == 1 )
+            {
+                // we're the last to finish this tick: reset the count, then release Wait()
+                _remaining.store( _workerCount, std::memory_order_relaxed );
+                _sense.store( ( generation & 1 ) != 0, std::memory_order_release );
+            }
+        }
+
+        inline void Wake()
+        {
+            std::lock_guard<std::mutex> lock( _mutex );
+            _condt.notify_all();
+        }
+
+    private:
+        // You might be thinking: Why pad these members apart rather than align them to cache lines?
+
+        // An over-aligned SpinGroup would need aligned operator new, which we avoid (see Block::_Allocate()).
+        // Padding each group of members by a cache line keeps them from sharing one wherever we're allocated.
+
+        [[maybe_unused]] char _padding0[64];
+
+        const int _workerCount;
+
+        std::atomic<uint64_t> _generation = 0;  // incremented by Release() to start each tick
+        std::atomic<int> _parkedCount = 0;
+
+        [[maybe_unused]] char _padding1[64];
+
+        std::atomic<int> _remaining;       // workers yet to finish the current tick
+        std::atomic<bool> _sense = false;  // flipped by the last worker to finish each tick
+
+        [[maybe_unused]] char _padding2[64];
+
+        std::mutex _mutex;
+        std::condition_variable _condt;
     };
 
     class CircuitThreadParallel final
@@ -353,26 +897,59 @@ private:
             Stop();
         }
 
-        inline void Start(
-            std::vector<DSPatch::Component*>* components, int bufferNo, int bufferCount, int threadNo, int threadCount )
+        inline void Start( std::vector<DSPatch::Component*>* components,
+                           int bufferNo,
+                           int bufferCount,
+                           int threadNo,
+                           int threadCount,
+                           bool callerRuns = false,
+                           SpinGroup* spinGroup = nullptr )
         {
             _components = components;
             _bufferNo = bufferNo;
             _loneBuffer = bufferCount <= 1;
             _threadNo = threadNo;
             _threadCount = threadCount;
+            _callerRuns = callerRuns && threadNo == 0;
+
+            // You might be thinking: Why not raise our priority when the caller is one of the workers?
+
+            // Workers spin (yielding) on each other's outputs. A real-time thread's yield only gives way to
+            // threads of equal priority, so a raised worker waiting on the caller's share could starve the
+            // caller of its core altogether.
+
+            _raisePriority = !callerRuns && !spinGroup;
+
+            _spinGroup = spinGroup;
+            _generation = spinGroup ? spinGroup->GetGeneration() : 0;
+
+            _shard = nullptr;
 
             _stop = false;
-            _gotSync = false;
 
-            _thread = std::thread( &CircuitThreadParallel::_Run, this );
+            // (a caller-runs worker has no thread of its own, its share is processed via Run() instead)
+            _resumedCount = 0;
+            _tickedCount = 0;
+
+            if ( !_callerRuns )
+            {
+                _thread = std::thread( &CircuitThreadParallel::_Run, this );
+            }
         }
 
         inline void Stop()
         {
             _stop = true;
 
-            Resume();
+            if ( _spinGroup )
+            {
+                _spinGroup->Wake();
+            }
+            else
+            {
+                std::lock_guard<std::mutex> lock( _syncMutex );
+                _resumeCondt.notify_all();
+            }
 
             if ( _thread.joinable() )
             {
@@ -380,98 +957,382 @@ private:
             }
         }
 
-        inline void Sync()
+        inline void Sync( uint64_t backlog = 0 )
         {
-            std::unique_lock<std::mutex> lock( _syncMutex );
-
-            if ( !_gotSync )  // if haven't already got sync
+            if ( _spinGroup )
             {
-                _syncCondt.wait( lock );  // wait for sync
+                _spinGroup->Wait();  // wait for the whole group (see Circuit::Tick())
+                return;
             }
+
+            DSPATCH_TRACE( internal::TraceScope traceScope( "Sync", _bufferNo ); )
+
+            // wait for all but backlog of our resumed ticks to be processed (see Circuit::Tick())
+            std::unique_lock<std::mutex> lock( _syncMutex );
+            _syncCondt.wait( lock, [this, backlog] { return _resumedCount - _tickedCount <= backlog; } );
         }
 
         inline void Resume()
         {
-            _gotSync = false;  // reset the sync flag
+            if ( _callerRuns || _spinGroup )
+            {
+                return;  // caller-runs workers are processed via Run(), spinning workers are released via their group
+            }
+
+            DSPATCH_TRACE( internal::TraceInstant( "Resume", _bufferNo ); )
+
+            {
+                std::lock_guard<std::mutex> lock( _syncMutex );
+                ++_resumedCount;  // queue a tick
+            }
+
             _resumeCondt.notify_all();
             std::this_thread::yield();
         }
 
-    private:
-        inline void _Run()
+        inline void Submit( uint64_t submitTime )
         {
-#ifdef _WIN32
-            SetThreadPriority( GetCurrentThread(), THREAD_PRIORITY_HIGHEST );
-#else
-            sched_param sch_params;
-            sch_params.sched_priority = sched_get_priority_max( SCHED_RR );
-            pthread_setschedparam( pthread_self(), SCHED_RR, &sch_params );
-#endif
+            // time the next tick (must be followed by a Resume())
+            _submitTime = submitTime;
+            _timed = true;
+        }
 
-            if ( _components )
-            {
-                while ( true )
-                {
-                    {
-                        std::unique_lock<std::mutex> lock( _syncMutex );
+        inline void Run()
+        {
+            // process this worker's share of the tick on the calling thread (caller-runs workers only)
+            auto& threadFlightRing = internal::GetThreadFlightRing();
+            const auto callerFlightRing = threadFlightRing;
 
-                        _gotSync = true;  // set the sync flag
-                        _syncCondt.notify_all();
-                        _resumeCondt.wait( lock );  // wait for resume
-                    }
+            _Tick();
 
-                    if ( _stop )
-                    {
-                        break;
-                    }
+            threadFlightRing = callerFlightRing;
+        }
 
-                    if ( _loneBuffer )
-                    {
-                        for ( auto it = _components->begin() + _threadNo; it < _components->end(); it += _threadCount )
-                        {
-                            ( *it )->TickParallel();
-                        }
-                    }
-                    else
-                    {
-                        for ( auto it = _components->begin() + _threadNo; it < _components->end(); it += _threadCount )
-                        {
-                            ( *it )->TickParallel( _bufferNo );
-                        }
-                    }
-                }
-            }
+        inline bool GetCallerRuns() const
+        {
+            return _callerRuns;
         }
 
-        std::thread _thread;
+        inline bool CollectLatency( uint64_t& submitTime, uint64_t& startTime, uint64_t& endTime )
+        {
+            // must follow a Sync()
+            if ( !_timed )
+            {
+                return false;
+            }
+
+            _timed = false;
+
+            submitTime = _submitTime;
+            startTime = _startTime;
+            endTime = _endTime;
+
+            return true;
+        }
+
+        inline bool CollectTickSpan( uint64_t& startTime, uint64_t& endTime )
+        {
+            // must follow a Sync()
+            if ( !_spanned )
+            {
+                return false;
+            }
+
+            _spanned = false;
+
+            startTime = _startTime;
+            endTime = _endTime;
+
+            return true;
+        }
+
+        inline void SetFlightRing( internal::FlightRing* flightRing )
+        {
+            // must follow a Sync() (takes effect from the next tick)
+            _flightRing = flightRing;
+        }
+
+        inline void SetShard( const std::vector<DSPatch::Component*>* shard )
+        {
+            // must follow a Sync() (takes effect from the next tick, nullptr to share out _components instead)
+            _shard = shard;
+        }
+
+#ifdef DSPATCH_ENABLE_STATS
+        inline const internal::AtomicHistogram& GetTickTime() const
+        {
+            return _tickTime;
+        }
+
+        inline void ResetTickTime()
+        {
+            _tickTime.Reset();
+        }
+#endif
+
+    private:
+        inline void _Run()
+        {
+            if ( _raisePriority )
+            {
+#ifdef _WIN32
+                SetThreadPriority( GetCurrentThread(), THREAD_PRIORITY_HIGHEST );
+#else
+                sched_param sch_params;
+                sch_params.sched_priority = sched_get_priority_max( SCHED_RR );
+                pthread_setschedparam( pthread_self(), SCHED_RR, &sch_params );
+#endif
+            }
+
+            DSPATCH_TRACE( internal::SetTraceThreadName( "CircuitThread " + std::to_string( _bufferNo ) + "." +
+                                                         std::to_string( _threadNo ) ); )
+
+            if ( _components && _spinGroup )
+            {
+                while ( _spinGroup->WaitForRelease( _generation, _stop ) )
+                {
+                    _Tick();
+                    _spinGroup->Arrive( _generation );
+                }
+            }
+            else if ( _components )
+            {
+                uint64_t tickedCount = 0;
+
+                while ( true )
+                {
+                    {
+                        std::unique_lock<std::mutex> lock( _syncMutex );
+
+                        _tickedCount = tickedCount;
+                        _syncCondt.notify_all();
+                        _resumeCondt.wait( lock, [this] { return _stop || _resumedCount != _tickedCount; } );  // wait for resume
+                    }
+
+                    if ( _stop )
+                    {
+                        break;
+                    }
+
+                    _Tick();
+                    ++tickedCount;
+                }
+            }
+        }
+
+        inline void _Tick()
+        {
+            internal::GetThreadFlightRing() = _flightRing;
+
+            if ( _timed || _flightRing )
+            {
+                _startTime = internal::StatsNow();
+            }
+
+            DSPATCH_STATS( const auto startTime = internal::StatsClock::now(); )
+
+            if ( _shard )
+            {
+                // our shards have no wires to any other thread's, so there's nothing to wait on mid-tick
+                if ( _loneBuffer )
+                {
+                    for ( auto component : *_shard )
+                    {
+                        component->Tick();
+                    }
+                }
+                else
+                {
+                    for ( auto component : *_shard )
+                    {
+                        component->Tick( _bufferNo );
+                    }
+                }
+            }
+            else if ( _loneBuffer )
+            {
+                for ( auto it = _components->begin() + _threadNo; it < _components->end(); it += _threadCount )
+                {
+                    ( *it )->TickParallel();
+                }
+            }
+            else
+            {
+                for ( auto it = _components->begin() + _threadNo; it < _components->end(); it += _threadCount )
+                {
+                    ( *it )->TickParallel( _bufferNo );
+                }
+            }
+
+            DSPATCH_STATS( _tickTime.Record( internal::StatsElapsed( startTime, internal::StatsClock::now() ) ); )
+
+            if ( _timed || _flightRing )
+            {
+                _endTime = internal::StatsNow();
+                _spanned = _flightRing != nullptr;
+            }
+        }
+
+        std::thread _thread;
         std::vector<DSPatch::Component*>* _components = nullptr;
+        const std::vector<DSPatch::Component*>* _shard = nullptr;  // see Circuit::_UpdateShards()
         int _bufferNo = 0;
         bool _loneBuffer = false;
         int _threadNo = 0;
         int _threadCount = 0;
-        bool _stop = false;
-        bool _gotSync = false;
+        bool _callerRuns = false;  // this worker is processed on the caller's thread
+        bool _raisePriority = true;
+        SpinGroup* _spinGroup = nullptr;  // shared by the workers of our buffer in low-latency mode
+        uint64_t _generation = 0;
+        std::atomic<bool> _stop = false;
+        uint64_t _resumedCount = 0;  // ticks queued by Resume()
+        uint64_t _tickedCount = 0;   // ticks processed by _Run()
         std::mutex _syncMutex;
         std::condition_variable _resumeCondt, _syncCondt;
+
+        bool _timed = false;
+        uint64_t _submitTime = 0;
+        uint64_t _startTime = 0;
+        uint64_t _endTime = 0;
+
+        internal::FlightRing* _flightRing = nullptr;
+        bool _spanned = false;
+
+        DSPATCH_STATS( internal::AtomicHistogram _tickTime; )
+    };
+
+    struct Edit final
+    {
+        enum class Type
+        {
+            Add,
+            Remove,
+            Connect,
+            Disconnect
+        };
+
+        Type type;
+        DSPatch::Component::SPtr component;  // the "from" component of a Connect
+        int fromOutput = 0;
+        DSPatch::Component::SPtr toComponent;
+        int toInput = 0;
+    };
+
+    bool _ValidateEdits() const;
+
+    struct Slot final
+    {
+        DSPatch::Component::SPtr component;  // nullptr if free
+        uint32_t generation = 0;
+        size_t index = 0;  // index of the component in _components
     };
 
+    const Slot* _GetSlot( ComponentId id ) const;
+    int _GetComponentIndex( const DSPatch::Component* component ) const;
+
+    ComponentId _AddComponent( const Component::SPtr& component );
+    void _RemoveComponent( uint32_t slotIndex );
+    void _DisconnectComponent( DSPatch::Component* component );
+
     void _Optimize();
+    void _UpdateReorderPlan();
+    void _UpdateShards();
+    void _ClearShards();
+    void _UpdateClockPlan();
+    void _CompactState();
+    void _PlanGathers();
+
+    static void _TickClocked( const std::vector<std::vector<DSPatch::Component*>>& clockPhases,
+                              const std::vector<int>& clockPhaseIndices,
+                              uint64_t tickSequence );
+
+    void _CollectLatency( int bufferNo );
+
+    void _UpdateFlightRings();
+    void _CheckFlightRecorder( int bufferNo );
+    void _TriggerFlightRecorder( uint64_t tickTime, int bufferNo );
+    void _DumpFlightRecord( std::ostream& stream, uint64_t tickTime, int bufferNo ) const;
+
+    struct GraphNode final
+    {
+        const DSPatch::Component* component = nullptr;
+        ComponentStats stats;
+        int level = 0;
+        int thread = -1;
+        bool critical = false;
+    };
+
+    struct GraphEdge final
+    {
+        int from = 0;
+        int fromOutput = 0;
+        int to = 0;
+        int toInput = 0;
+        bool feedback = false;
+        bool critical = false;
+    };
+
+    void _BuildGraph( std::vector<GraphNode>& nodes, std::vector<GraphEdge>& edges );
+    void _GetTopology( std::vector<int>& parallelOrder, std::vector<GraphEdge>& wires ) const;
+
+    static std::string _Quote( const std::string& string );
 
     int _bufferCount = 0;
     int _threadCount = 0;
     int _currentBuffer = 0;
+    int _blockSize = 256;
+
+    uint64_t _tickSequence = 0;  // sequence number of the next tick
+
+    Component::WaitStrategy _waitStrategy = Component::WaitStrategy::Yield;
+
+    bool _reorderingEnabled = false;
+    bool _callerRunsEnabled = false;
+    bool _lowLatencyEnabled = false;
+    bool _shardingEnabled = false;
+    bool _compactionEnabled = false;
+    std::vector<std::vector<int>> _componentSources;  // per component, the indices of the components feeding its inputs
 
     AutoTickThread _autoTickThread;
 
-    std::unordered_set<DSPatch::Component::SPtr> _componentsSet;
+    ComponentArena::SPtr _arena;
+    ComponentArena::SPtr _stateArena;  // arena the components' runtime state was last compacted into (see _CompactState())
+
+    std::vector<Slot> _slots;
+    std::vector<uint32_t> _freeSlots;
+    std::unordered_map<const DSPatch::Component*, uint32_t> _slotIndices;  // slot of each component
 
     std::vector<DSPatch::Component*> _components;
     std::vector<DSPatch::Component*> _componentsParallel;
+    std::vector<std::vector<DSPatch::Component*>> _shardedComponents;  // per thread, its shards' components (when sharding)
+
+    std::vector<std::vector<DSPatch::Component*>> _clockPhases;  // per distinct phase, the components it ticks (when clocked)
+    std::vector<int> _clockPhaseIndices;                         // per tick of the clock period, its _clockPhases index
 
     std::vector<CircuitThread> _circuitThreads;
+    std::vector<std::unique_ptr<SpinGroup>> _spinGroups;  // per buffer, in low-latency mode (outlives the threads using it)
     std::vector<std::vector<CircuitThreadParallel>> _circuitThreadsParallel;
 
     bool _circuitDirty = false;
+
+    int _editDepth = 0;
+    std::vector<Edit> _edits;
+
+    std::mutex _bufferPoolsMutex;
+    std::unordered_map<std::type_index, std::shared_ptr<void>> _bufferPools;
+
+    DSPATCH_STATS( internal::AtomicHistogram _tickTime; )  // ticks processed on the caller's thread
+
+    bool _latencyStatsEnabled = false;
+    std::vector<internal::AtomicHistogram> _queueTimes;       // AtomicHistogram per buffer
+    std::vector<internal::AtomicHistogram> _completionTimes;  // AtomicHistogram per buffer
+
+    bool _flightRecorderEnabled = false;
+    std::vector<std::unique_ptr<internal::FlightRing>> _flightRings;  // caller's thread, then each circuit thread
+    uint64_t _flightRecorderThreshold = 0;
+    std::string _flightRecorderPath;
+    std::atomic<int> _flightRecorderDumpCount = 0;
+    int _flightRecorderHoldoff = 0;
 };
 
 inline Circuit::Circuit() = default;
@@ -484,49 +1345,77 @@ inline Circuit::~Circuit()
 
 inline bool Circuit::AddComponent( const Component::SPtr& component )
 {
-    if ( !component || _componentsSet.find( component ) != _componentsSet.end() )
+    ComponentId id;
+    return AddComponent( component, id );
+}
+
+inline bool Circuit::AddComponent( const Component::SPtr& component, ComponentId& id )
+{
+    id = ComponentId();
+
+    if ( _editDepth != 0 )
     {
-        return false;
+        _edits.emplace_back( Edit{ Edit::Type::Add, component, 0, nullptr, 0 } );
+        return true;
     }
 
-    // components within the circuit need to have as many buffers as there are threads in the circuit
-    component->SetBufferCount( _bufferCount, _currentBuffer );
+    if ( !component || _slotIndices.find( component.get() ) != _slotIndices.end() )
+    {
+        return false;
+    }
 
     PauseAutoTick();
-    _components.emplace_back( component.get() );
-    _componentsParallel.emplace_back( component.get() );
+    id = _AddComponent( component );
     ResumeAutoTick();
 
-    _componentsSet.emplace( component );
-
     return true;
 }
 
-inline bool Circuit::RemoveComponent( const Component::SPtr& component )
+template <typename T, typename... Args>
+inline std::shared_ptr<T> Circuit::Emplace( Args&&... args )
 {
-    if ( _componentsSet.find( component ) == _componentsSet.end() )
+    if ( !_arena )
     {
-        return false;
+        _arena = std::make_shared<ComponentArena>();
     }
 
-    auto findFn = [&component]( auto comp ) { return comp == component.get(); };
+    // the component and its control block are allocated together, from the arena
+    auto component = std::allocate_shared<T>( internal::ArenaAllocator<T>( _arena ), std::forward<Args>( args )... );
 
-    if ( auto it = std::find_if( _components.begin(), _components.end(), findFn ); it != _components.end() )
-    {
-        PauseAutoTick();
+    AddComponent( component );
 
-        DisconnectComponent( component );
-
-        _components.erase( it );
+    return component;
+}
 
-        ResumeAutoTick();
+inline bool Circuit::RemoveComponent( const Component::SPtr& component )
+{
+    if ( _editDepth != 0 )
+    {
+        _edits.emplace_back( Edit{ Edit::Type::Remove, component, 0, nullptr, 0 } );
+        return true;
+    }
 
-        _componentsSet.erase( component );
+    return RemoveComponent( GetComponentId( component ) );
+}
 
+inline bool Circuit::RemoveComponent( ComponentId id )
+{
+    if ( _editDepth != 0 )
+    {
+        _edits.emplace_back( Edit{ Edit::Type::Remove, GetComponent( id ), 0, nullptr, 0 } );
         return true;
     }
 
-    return false;
+    if ( !_GetSlot( id ) )
+    {
+        return false;
+    }
+
+    PauseAutoTick();
+    _RemoveComponent( id.index );
+    ResumeAutoTick();
+
+    return true;
 }
 
 // cppcheck-suppress unusedFunction
@@ -536,12 +1425,39 @@ inline void Circuit::RemoveAllComponents()
 
     DisconnectAllComponents();
 
+    for ( auto component : _components )
+    {
+        // the component is no longer ticked on our clock
+        component->SetClocked( false, _tickSequence );
+    }
+
     _components.clear();
     _componentsParallel.clear();
+    _ClearShards();
+
+    // drop the clock plan's pointers to the removed components (Optimize() plans for any components added later)
+    _clockPhases.clear();
+    _clockPhaseIndices.clear();
+
+    for ( auto& circuitThread : _circuitThreads )
+    {
+        circuitThread.SetClockPlan( nullptr, &_clockPhaseIndices, _tickSequence );
+    }
 
     ResumeAutoTick();
 
-    _componentsSet.clear();
+    // free every slot (invalidating their ComponentIds)
+    for ( uint32_t i = 0; i < (uint32_t)_slots.size(); ++i )
+    {
+        if ( _slots[i].component )
+        {
+            _slots[i].component = nullptr;
+            ++_slots[i].generation;
+            _freeSlots.emplace_back( i );
+        }
+    }
+
+    _slotIndices.clear();
 }
 
 inline int Circuit::GetComponentCount() const
@@ -549,20 +1465,60 @@ inline int Circuit::GetComponentCount() const
     return (int)_components.size();
 }
 
+inline ComponentId Circuit::GetComponentId( const Component::SPtr& component ) const
+{
+    if ( auto it = _slotIndices.find( component.get() ); it != _slotIndices.end() )
+    {
+        return ComponentId{ it->second, _slots[it->second].generation };
+    }
+
+    return ComponentId();
+}
+
+inline Component::SPtr Circuit::GetComponent( ComponentId id ) const
+{
+    if ( auto slot = _GetSlot( id ) )
+    {
+        return slot->component;
+    }
+
+    return nullptr;
+}
+
 inline bool Circuit::ConnectOutToIn( const Component::SPtr& fromComponent,
                                      int fromOutput,
                                      const Component::SPtr& toComponent,
                                      int toInput )
 {
-    if ( _componentsSet.find( fromComponent ) == _componentsSet.end() ||
-         _componentsSet.find( toComponent ) == _componentsSet.end() )
+    if ( _editDepth != 0 )
+    {
+        _edits.emplace_back( Edit{ Edit::Type::Connect, fromComponent, fromOutput, toComponent, toInput } );
+        return true;
+    }
+
+    return ConnectOutToIn( GetComponentId( fromComponent ), fromOutput, GetComponentId( toComponent ), toInput );
+}
+
+inline bool Circuit::ConnectOutToIn( ComponentId fromComponent, int fromOutput, ComponentId toComponent, int toInput )
+{
+    if ( _editDepth != 0 )
+    {
+        _edits.emplace_back(
+            Edit{ Edit::Type::Connect, GetComponent( fromComponent ), fromOutput, GetComponent( toComponent ), toInput } );
+        return true;
+    }
+
+    auto fromSlot = _GetSlot( fromComponent );
+    auto toSlot = _GetSlot( toComponent );
+
+    if ( !fromSlot || !toSlot )
     {
         return false;
     }
 
     PauseAutoTick();
 
-    bool result = toComponent->ConnectInput( fromComponent, fromOutput, toInput );
+    bool result = toSlot->component->ConnectInput( fromSlot->component, fromOutput, toInput );
 
     _circuitDirty = result;
 
@@ -573,23 +1529,32 @@ inline bool Circuit::ConnectOutToIn( const Component::SPtr& fromComponent,
 
 inline bool Circuit::DisconnectComponent( const Component::SPtr& component )
 {
-    if ( _componentsSet.find( component ) == _componentsSet.end() )
+    if ( _editDepth != 0 )
     {
-        return false;
+        _edits.emplace_back( Edit{ Edit::Type::Disconnect, component, 0, nullptr, 0 } );
+        return true;
     }
 
-    PauseAutoTick();
-
-    component->DisconnectAllInputs();
+    return DisconnectComponent( GetComponentId( component ) );
+}
 
-    // remove any connections this component has to other components
-    for ( auto comp : _components )
+inline bool Circuit::DisconnectComponent( ComponentId id )
+{
+    if ( _editDepth != 0 )
     {
-        comp->DisconnectInput( component );
+        _edits.emplace_back( Edit{ Edit::Type::Disconnect, GetComponent( id ), 0, nullptr, 0 } );
+        return true;
     }
 
-    _circuitDirty = true;
+    auto slot = _GetSlot( id );
+
+    if ( !slot )
+    {
+        return false;
+    }
 
+    PauseAutoTick();
+    _DisconnectComponent( slot->component.get() );
     ResumeAutoTick();
 
     return true;
@@ -607,12 +1572,71 @@ inline void Circuit::DisconnectAllComponents()
     ResumeAutoTick();
 }
 
+inline void Circuit::BeginEdit()
+{
+    ++_editDepth;
+}
+
+inline bool Circuit::Commit()
+{
+    if ( _editDepth == 0 )
+    {
+        return false;
+    }
+
+    if ( --_editDepth != 0 )
+    {
+        return true;  // the outermost Commit() applies the edits
+    }
+
+    const auto valid = _ValidateEdits();
+
+    if ( valid && !_edits.empty() )
+    {
+        PauseAutoTick();
+
+        for ( const auto& edit : _edits )
+        {
+            switch ( edit.type )
+            {
+                case Edit::Type::Add:
+                    _AddComponent( edit.component );
+                    break;
+                case Edit::Type::Remove:
+                    _RemoveComponent( _slotIndices.find( edit.component.get() )->second );  // (validated above)
+                    break;
+                case Edit::Type::Connect:
+                    edit.toComponent->ConnectInput( edit.component, edit.fromOutput, edit.toInput );
+                    break;
+                case Edit::Type::Disconnect:
+                    _DisconnectComponent( edit.component.get() );
+                    break;
+            }
+        }
+
+        _Optimize();
+
+        ResumeAutoTick();
+    }
+
+    _edits.clear();
+
+    return valid;
+}
+
 inline void Circuit::SetBufferCount( int bufferCount )
 {
     PauseAutoTick();
 
     _bufferCount = bufferCount;
 
+    if ( _latencyStatsEnabled )
+    {
+        // ensure there is a histogram per buffer
+        _queueTimes.resize( std::max( _bufferCount, 1 ) );
+        _completionTimes.resize( std::max( _bufferCount, 1 ) );
+    }
+
     // stop all threads
     for ( auto& circuitThread : _circuitThreads )
     {
@@ -644,7 +1668,17 @@ inline void Circuit::SetBufferCount( int bufferCount )
     // set all components to the new buffer count
     for ( auto component : _components )
     {
-        component->SetBufferCount( _bufferCount, _currentBuffer );
+        component->SetBufferCount( _bufferCount, _currentBuffer, _tickSequence );
+    }
+
+    _UpdateReorderPlan();
+    _UpdateClockPlan();
+    _CompactState();
+    _PlanGathers();
+
+    if ( _flightRecorderEnabled )
+    {
+        _UpdateFlightRings();
     }
 
     ResumeAutoTick();
@@ -655,11 +1689,47 @@ inline int Circuit::GetBufferCount() const
     return _bufferCount;
 }
 
-inline void Circuit::SetThreadCount( int threadCount )
+inline void Circuit::SetWaitStrategy( Component::WaitStrategy waitStrategy )
 {
     PauseAutoTick();
 
-    if ( _threadCount == 0 && threadCount != 0 )
+    _waitStrategy = waitStrategy;
+
+    // set all components to the new wait strategy
+    for ( auto component : _components )
+    {
+        component->SetWaitStrategy( _waitStrategy );
+    }
+
+    ResumeAutoTick();
+}
+
+inline Component::WaitStrategy Circuit::GetWaitStrategy() const
+{
+    return _waitStrategy;
+}
+
+inline void Circuit::SetReorderingEnabled( bool enabled )
+{
+    PauseAutoTick();
+
+    _reorderingEnabled = enabled;
+
+    _UpdateReorderPlan();
+
+    ResumeAutoTick();
+}
+
+inline bool Circuit::GetReorderingEnabled() const
+{
+    return _reorderingEnabled;
+}
+
+inline void Circuit::SetThreadCount( int threadCount )
+{
+    PauseAutoTick();
+
+    if ( _threadCount == 0 && threadCount != 0 )
     {
         _circuitDirty = true;
     }
@@ -679,6 +1749,7 @@ inline void Circuit::SetThreadCount( int threadCount )
     if ( _threadCount == 0 )
     {
         _circuitThreadsParallel.resize( 0 );
+        _spinGroups.clear();
         SetBufferCount( _bufferCount );
     }
     else
@@ -689,17 +1760,38 @@ inline void Circuit::SetThreadCount( int threadCount )
             circuitThread.resize( _threadCount );
         }
 
+        // with caller-runs, the ticking thread acts as each tick's first worker (single buffered circuits only)
+        const auto callerRuns = _callerRunsEnabled && _bufferCount <= 1;
+
+        _spinGroups.clear();
+
         // initialise and start all threads
         int i = 0;
         for ( auto& circuitThreads : _circuitThreadsParallel )
         {
+            SpinGroup* spinGroup = nullptr;
+            if ( _lowLatencyEnabled )
+            {
+                _spinGroups.emplace_back( std::make_unique<SpinGroup>( callerRuns ? _threadCount - 1 : _threadCount ) );
+                spinGroup = _spinGroups.back().get();
+            }
+
             int j = 0;
             for ( auto& circuitThread : circuitThreads )
             {
-                circuitThread.Start( &_componentsParallel, i, _bufferCount, j++, _threadCount );
+                circuitThread.Start( &_componentsParallel, i, _bufferCount, j++, _threadCount, callerRuns, spinGroup );
             }
             ++i;
         }
+
+        _UpdateShards();
+        _UpdateClockPlan();
+        _PlanGathers();
+    }
+
+    if ( _flightRecorderEnabled )
+    {
+        _UpdateFlightRings();
     }
 
     ResumeAutoTick();
@@ -711,8 +1803,133 @@ inline int Circuit::GetThreadCount() const
     return _threadCount;
 }
 
+inline void Circuit::SetCallerRunsEnabled( bool enabled )
+{
+    PauseAutoTick();
+
+    _callerRunsEnabled = enabled;
+
+    // restart our threads, with (or without) the caller as each tick's first worker
+    SetThreadCount( _threadCount );
+
+    ResumeAutoTick();
+}
+
+inline bool Circuit::GetCallerRunsEnabled() const
+{
+    return _callerRunsEnabled;
+}
+
+inline void Circuit::SetLowLatencyEnabled( bool enabled )
+{
+    PauseAutoTick();
+
+    _lowLatencyEnabled = enabled;
+
+    // restart our threads, spinning (or not) between ticks
+    SetThreadCount( _threadCount );
+
+    ResumeAutoTick();
+}
+
+inline bool Circuit::GetLowLatencyEnabled() const
+{
+    return _lowLatencyEnabled;
+}
+
+inline void Circuit::SetShardingEnabled( bool enabled )
+{
+    PauseAutoTick();
+
+    _shardingEnabled = enabled;
+
+    _UpdateShards();
+
+    ResumeAutoTick();
+}
+
+inline bool Circuit::GetShardingEnabled() const
+{
+    return _shardingEnabled;
+}
+
+inline void Circuit::SetCompactionEnabled( bool enabled )
+{
+    PauseAutoTick();
+
+    _compactionEnabled = enabled;
+
+    if ( !_circuitDirty )
+    {
+        // otherwise, _Optimize() will
+        _CompactState();
+        _PlanGathers();
+    }
+
+    ResumeAutoTick();
+}
+
+// cppcheck-suppress unusedFunction
+inline bool Circuit::GetCompactionEnabled() const
+{
+    return _compactionEnabled;
+}
+
+inline bool Circuit::SetClockDivider( const Component::SPtr& component, int clockDivider, Component::IdleOutput idleOutput )
+{
+    return SetClockDivider( GetComponentId( component ), clockDivider, idleOutput );
+}
+
+inline bool Circuit::SetClockDivider( ComponentId id, int clockDivider, Component::IdleOutput idleOutput )
+{
+    auto slot = _GetSlot( id );
+
+    if ( !slot )
+    {
+        return false;
+    }
+
+    if ( clockDivider > 1 && ( _bufferCount > 1 || _threadCount != 0 ) )
+    {
+        return false;  // clock dividers only apply to circuits ticking in series, on one buffer
+    }
+
+    PauseAutoTick();
+
+    slot->component->SetClockDivider( clockDivider, idleOutput );
+
+    // the clock plan is rebuilt by _Optimize()
+    _circuitDirty = true;
+
+    ResumeAutoTick();
+
+    return true;
+}
+
+inline void Circuit::SetBlockSize( int blockSize )
+{
+    PauseAutoTick();
+
+    _blockSize = blockSize;
+
+    // set all components to the new block size
+    for ( auto component : _components )
+    {
+        component->SetBlockSize( _blockSize );
+    }
+
+    ResumeAutoTick();
+}
+
+inline int Circuit::GetBlockSize() const
+{
+    return _blockSize;
+}
+
 inline void Circuit::Tick()
 {
+    DSPATCH_PROBE2( circuit_tick_begin, this, _currentBuffer );
+
     if ( _circuitDirty )
     {
         _Optimize();
@@ -724,32 +1941,132 @@ inline void Circuit::Tick()
     {
         auto& circuitThreads = _circuitThreadsParallel[_currentBuffer];
 
+        // You might be thinking: Why not always wait for the last tick on this buffer to finish first?
+
+        // Sharded, no thread's components are wired to any other's, so a thread can be left to work through its ticks at its
+        // own pace (up to a backlog), rather than every thread waiting on the slowest. Modes that time or share out each tick
+        // as a whole need it finished first, as without sharding.
+
+        const auto independent = !_shardedComponents.empty() && _spinGroups.empty() && !_callerRunsEnabled &&
+                                 !_latencyStatsEnabled && !_flightRecorderEnabled;
+
         for ( auto& circuitThread : circuitThreads )
         {
-            circuitThread.Sync();
+            circuitThread.Sync( independent ? std::max( DSPATCH_SHARD_BACKLOG, 1 ) - 1 : 0 );
+        }
+
+        if ( _latencyStatsEnabled )
+        {
+            _CollectLatency( _currentBuffer );
+
+            const auto submitTime = internal::StatsNow();
+            for ( auto& circuitThread : circuitThreads )
+            {
+                circuitThread.Submit( submitTime );
+            }
+        }
+
+        if ( _flightRecorderEnabled )
+        {
+            _CheckFlightRecorder( _currentBuffer );
         }
+
         for ( auto& circuitThread : circuitThreads )
         {
             circuitThread.Resume();
         }
+
+        if ( !_spinGroups.empty() )
+        {
+            _spinGroups[_currentBuffer]->Release();
+        }
+
+        if ( circuitThreads.front().GetCallerRuns() )
+        {
+            // process our share of the tick, then wait for the other workers to finish theirs
+            circuitThreads.front().Run();
+
+            for ( auto& circuitThread : circuitThreads )
+            {
+                circuitThread.Sync();
+            }
+        }
     }
     // process in a single thread if this circuit has no threads
     // =========================================================
     else if ( _bufferCount == 0 )
     {
-        // tick all internal components
-        for ( auto component : _components )
+        DSPATCH_STATS( const auto startTime = internal::StatsClock::now(); )
+
+        const auto submitTime = _latencyStatsEnabled || _flightRecorderEnabled ? internal::StatsNow() : 0;
+
+        // record into the caller's ring (restored after, in case the caller also ticks other circuits)
+        auto& threadFlightRing = internal::GetThreadFlightRing();
+        const auto callerFlightRing = threadFlightRing;
+        threadFlightRing = _flightRecorderEnabled ? _flightRings.front().get() : nullptr;
+
+        // tick all internal components (or just those due this tick, when clocked)
+        if ( _clockPhases.empty() )
         {
-            component->Tick();
+            for ( auto component : _components )
+            {
+                component->Tick();
+            }
+        }
+        else
+        {
+            _TickClocked( _clockPhases, _clockPhaseIndices, _tickSequence );
+        }
+
+        threadFlightRing = callerFlightRing;
+
+        DSPATCH_STATS( _tickTime.Record( internal::StatsElapsed( startTime, internal::StatsClock::now() ) ); )
+
+        if ( _latencyStatsEnabled )
+        {
+            _queueTimes.front().Record( 0 );
+            _completionTimes.front().Record( internal::StatsNow() - submitTime );
+        }
+
+        if ( _flightRecorderEnabled )
+        {
+            _TriggerFlightRecorder( internal::StatsNow() - submitTime, 0 );
         }
 
+        DSPATCH_PROBE2( circuit_tick_end, this, _currentBuffer );
+
+        ++_tickSequence;
+
         return;
     }
+    else if ( _latencyStatsEnabled || _flightRecorderEnabled )
+    {
+        auto& circuitThread = _circuitThreads[_currentBuffer];
+
+        circuitThread.Sync();
+
+        if ( _latencyStatsEnabled )
+        {
+            _CollectLatency( _currentBuffer );
+            circuitThread.Submit( internal::StatsNow() );
+        }
+
+        if ( _flightRecorderEnabled )
+        {
+            _CheckFlightRecorder( _currentBuffer );
+        }
+
+        circuitThread.Resume();
+    }
     else
     {
         _circuitThreads[_currentBuffer].SyncAndResume();  // sync and resume thread x
     }
 
+    DSPATCH_PROBE2( circuit_tick_end, this, _currentBuffer );
+
+    ++_tickSequence;
+
     if ( _bufferCount != 0 && ++_currentBuffer == _bufferCount )
     {
         _currentBuffer = 0;
@@ -770,6 +2087,15 @@ inline void Circuit::Sync()
             circuitThread.Sync();
         }
     }
+
+    if ( _latencyStatsEnabled )
+    {
+        // collect the latencies of all buffers that completed since their last sync
+        for ( int i = 0; i < (int)_queueTimes.size(); ++i )
+        {
+            _CollectLatency( i );
+        }
+    }
 }
 
 inline void Circuit::StartAutoTick()
@@ -804,49 +2130,1495 @@ inline void Circuit::Optimize()
     }
 }
 
-inline void Circuit::_Optimize()
+template <typename T>
+inline typename BufferPool<T>::SPtr Circuit::GetBufferPool()
 {
-    // scan for optimal series order -> update _components
-    std::vector<DSPatch::Component*> orderedComponents;
-    orderedComponents.reserve( _components.size() );
+    std::lock_guard<std::mutex> lock( _bufferPoolsMutex );
 
-    for ( auto component : _components )
+    auto& bufferPool = _bufferPools[typeid( T )];
+
+    if ( !bufferPool )
     {
-        component->Scan( orderedComponents );
+        bufferPool = std::make_shared<BufferPool<T>>();
+    }
+
+    return std::static_pointer_cast<BufferPool<T>>( bufferPool );
+}
+
+inline CircuitStats Circuit::GetStats() const
+{
+    CircuitStats stats;
+
+#ifdef DSPATCH_ENABLE_STATS
+    stats.enabled = true;
+
+    // merge the tick times of all threads
+    _tickTime.MergeInto( stats.tickTime );
+
+    for ( const auto& circuitThread : _circuitThreads )
+    {
+        circuitThread.GetTickTime().MergeInto( stats.tickTime );
+    }
+    for ( const auto& circuitThreads : _circuitThreadsParallel )
+    {
+        for ( const auto& circuitThread : circuitThreads )
+        {
+            circuitThread.GetTickTime().MergeInto( stats.tickTime );
+        }
     }
+
+    stats.components.reserve( _components.size() );
     for ( auto component : _components )
     {
-        component->EndScan();
+        stats.components.emplace_back( component->GetStats() );
     }
+#endif
 
-    _components = std::move( orderedComponents );
+    return stats;
+}
 
-    // scan for optimal parallel order -> update _componentsParallel
-    if ( _threadCount != 0 )
-    {
-        std::vector<std::vector<DSPatch::Component*>> componentsMap;
-        componentsMap.reserve( _components.size() );
+inline void Circuit::ResetStats()
+{
+    PauseAutoTick();
 
-        int scanPosition;
-        for ( auto component : _components )
-        {
-            component->ScanParallel( componentsMap, scanPosition );
-        }
-        for ( auto component : _components )
-        {
-            component->EndScan();
-        }
+#ifdef DSPATCH_ENABLE_STATS
+    _tickTime.Reset();
 
-        _componentsParallel.clear();
-        _componentsParallel.reserve( _components.size() );
-        for ( auto& componentsMapEntry : componentsMap )
+    for ( auto& circuitThread : _circuitThreads )
+    {
+        circuitThread.ResetTickTime();
+    }
+    for ( auto& circuitThreads : _circuitThreadsParallel )
+    {
+        for ( auto& circuitThread : circuitThreads )
         {
-            _componentsParallel.insert( _componentsParallel.end(), componentsMapEntry.begin(), componentsMapEntry.end() );
+            circuitThread.ResetTickTime();
         }
     }
 
-    // clear _circuitDirty flag
-    _circuitDirty = false;
+    for ( auto component : _components )
+    {
+        component->ResetStats();
+    }
+#endif
+
+    ResumeAutoTick();
+}
+
+inline void Circuit::SetLatencyStatsEnabled( bool enabled )
+{
+    PauseAutoTick();
+
+    _latencyStatsEnabled = enabled;
+
+    // ensure there is a histogram per buffer
+    _queueTimes.resize( std::max( _bufferCount, 1 ) );
+    _completionTimes.resize( std::max( _bufferCount, 1 ) );
+
+    ResumeAutoTick();
+}
+
+inline bool Circuit::GetLatencyStatsEnabled() const
+{
+    return _latencyStatsEnabled;
+}
+
+inline LatencyStats Circuit::GetLatencyStats() const
+{
+    LatencyStats stats;
+    stats.enabled = _latencyStatsEnabled;
+
+    for ( const auto& queueTime : _queueTimes )
+    {
+        queueTime.MergeInto( stats.queueTime );
+    }
+
+    for ( const auto& completionTime : _completionTimes )
+    {
+        stats.bufferCompletionTimes.emplace_back();
+        completionTime.MergeInto( stats.bufferCompletionTimes.back() );
+        completionTime.MergeInto( stats.completionTime );
+    }
+
+    return stats;
+}
+
+inline void Circuit::ResetLatencyStats()
+{
+    PauseAutoTick();
+
+    for ( auto& queueTime : _queueTimes )
+    {
+        queueTime.Reset();
+    }
+    for ( auto& completionTime : _completionTimes )
+    {
+        completionTime.Reset();
+    }
+
+    ResumeAutoTick();
+}
+
+inline void Circuit::SetFlightRecorderEnabled( bool enabled )
+{
+    PauseAutoTick();
+
+    _flightRecorderEnabled = enabled;
+    _flightRecorderHoldoff = 0;
+
+    // (re)allocate a ring per thread (or free them all)
+    _UpdateFlightRings();
+
+    ResumeAutoTick();
+}
+
+inline bool Circuit::GetFlightRecorderEnabled() const
+{
+    return _flightRecorderEnabled;
+}
+
+inline void Circuit::SetFlightRecorderTrigger( uint64_t tickTimeThreshold, const std::string& filePath )
+{
+    PauseAutoTick();
+
+    _flightRecorderThreshold = tickTimeThreshold;
+    _flightRecorderPath = filePath;
+    _flightRecorderHoldoff = 0;
+
+    ResumeAutoTick();
+}
+
+inline int Circuit::GetFlightRecorderDumpCount() const
+{
+    return _flightRecorderDumpCount;
+}
+
+inline std::vector<FlightRecord> Circuit::GetFlightRecord() const
+{
+    std::vector<FlightRecord> records;
+
+    for ( const auto& flightRing : _flightRings )
+    {
+        flightRing->Read( records );
+    }
+
+    std::sort( records.begin(), records.end(), []( const auto& a, const auto& b ) { return a.startTime < b.startTime; } );
+
+    // resolve each component's position in the process order
+    std::unordered_map<const Component*, int> componentIndices;
+    for ( int i = 0; i < (int)_components.size(); ++i )
+    {
+        componentIndices.emplace( _components[i], i );
+    }
+
+    for ( auto& record : records )
+    {
+        if ( auto it = componentIndices.find( record.component ); it != componentIndices.end() )
+        {
+            record.componentIndex = it->second;
+        }
+    }
+
+    return records;
+}
+
+inline void Circuit::DumpFlightRecord( std::ostream& stream ) const
+{
+    _DumpFlightRecord( stream, 0, -1 );
+}
+
+inline bool Circuit::DumpFlightRecord( const std::string& filePath ) const
+{
+    std::ofstream stream( filePath, std::ios::binary );
+    if ( !stream )
+    {
+        return false;
+    }
+
+    _DumpFlightRecord( stream, 0, -1 );
+
+    return (bool)stream;
+}
+
+inline void Circuit::ExportDot( std::ostream& stream )
+{
+    std::vector<GraphNode> nodes;
+    std::vector<GraphEdge> edges;
+    _BuildGraph( nodes, edges );
+
+    stream << "digraph DSPatch\n{\n    node [shape=box];\n";
+
+    for ( int i = 0; i < (int)nodes.size(); ++i )
+    {
+        const auto& node = nodes[i];
+
+        std::string label = std::to_string( i ) + ": " + internal::DemangleTypeName( typeid( *node.component ) ) +
+                            "\nlevel: " + std::to_string( node.level ) + ", thread: " + std::to_string( node.thread );
+
+#ifdef DSPATCH_ENABLE_STATS
+        std::ostringstream processTime;
+        processTime << "\nprocess: " << node.stats.processTime.GetMean() / 1000.0 << "us mean, "
+                    << (double)node.stats.processTime.GetPercentile( 99.0 ) / 1000.0 << "us p99";
+        label += processTime.str();
+#endif
+
+        stream << "    c" << i << " [label=" << _Quote( label ) << ( node.critical ? ", penwidth=3" : "" ) << "];\n";
+    }
+
+    for ( const auto& edge : edges )
+    {
+        const auto outputName = nodes[edge.from].component->GetOutputName( edge.fromOutput );
+        const auto inputName = nodes[edge.to].component->GetInputName( edge.toInput );
+
+        std::string label = ( outputName.empty() ? std::to_string( edge.fromOutput ) : outputName ) + " -> " +
+                            ( inputName.empty() ? std::to_string( edge.toInput ) : inputName );
+        std::string attributes = edge.feedback ? ", style=dashed" : "";
+
+#ifdef DSPATCH_ENABLE_STATS
+        const auto& wireStats = nodes[edge.to].stats.inputs[edge.toInput];
+
+        label += "\nmoves: " + std::to_string( wireStats.moves ) + "\ncopies: " + std::to_string( wireStats.copies ) +
+                 "\nnulls: " + std::to_string( wireStats.nulls ) + "\nbytes copied: " + std::to_string( wireStats.bytesCopied );
+
+        if ( wireStats.copies != 0 )
+        {
+            attributes += ", color=\"red\", fontcolor=\"red\"";
+        }
+#endif
+
+        stream << "    c" << edge.from << " -> c" << edge.to << " [label=" << _Quote( label ) << attributes
+               << ( edge.critical ? ", penwidth=3" : "" ) << "];\n";
+    }
+
+    stream << "}\n";
+}
+
+inline void Circuit::ExportJson( std::ostream& stream )
+{
+    std::vector<GraphNode> nodes;
+    std::vector<GraphEdge> edges;
+    _BuildGraph( nodes, edges );
+
+    auto writeNames = [&stream]( const Component* component, int count, bool inputs ) {
+        stream << "[";
+        for ( int i = 0; i < count; ++i )
+        {
+            stream << ( i == 0 ? "" : "," )
+                   << _Quote( inputs ? component->GetInputName( i ) : component->GetOutputName( i ) );
+        }
+        stream << "]";
+    };
+
+#ifdef DSPATCH_ENABLE_STATS
+    stream << "{\"stats\":true";
+#else
+    stream << "{\"stats\":false";
+#endif
+
+    stream << ",\"bufferCount\":" << _bufferCount << ",\"threadCount\":" << _threadCount << ",\"nodes\":[";
+
+    for ( int i = 0; i < (int)nodes.size(); ++i )
+    {
+        const auto& node = nodes[i];
+
+        stream << ( i == 0 ? "" : "," ) << "\n{\"id\":" << i
+               << ",\"type\":" << _Quote( internal::DemangleTypeName( typeid( *node.component ) ) ) << ",\"inputs\":";
+        writeNames( node.component, node.component->GetInputCount(), true );
+        stream << ",\"outputs\":";
+        writeNames( node.component, node.component->GetOutputCount(), false );
+        stream << ",\"level\":" << node.level << ",\"thread\":" << node.thread
+               << ",\"critical\":" << ( node.critical ? "true" : "false" );
+
+#ifdef DSPATCH_ENABLE_STATS
+        const auto& processTime = node.stats.processTime;
+        stream << ",\"processTime\":{\"count\":" << processTime.GetCount() << ",\"mean\":" << processTime.GetMean()
+               << ",\"p50\":" << processTime.GetPercentile( 50.0 ) << ",\"p99\":" << processTime.GetPercentile( 99.0 )
+               << ",\"max\":" << processTime.GetMax() << "}";
+#endif
+
+        stream << "}";
+    }
+
+    stream << "],\"edges\":[";
+
+    for ( int i = 0; i < (int)edges.size(); ++i )
+    {
+        const auto& edge = edges[i];
+
+        stream << ( i == 0 ? "" : "," ) << "\n{\"from\":" << edge.from << ",\"fromOutput\":" << edge.fromOutput
+               << ",\"to\":" << edge.to << ",\"toInput\":" << edge.toInput
+               << ",\"feedback\":" << ( edge.feedback ? "true" : "false" )
+               << ",\"critical\":" << ( edge.critical ? "true" : "false" );
+
+#ifdef DSPATCH_ENABLE_STATS
+        const auto& wireStats = nodes[edge.to].stats.inputs[edge.toInput];
+        stream << ",\"moves\":" << wireStats.moves << ",\"copies\":" << wireStats.copies << ",\"nulls\":" << wireStats.nulls
+               << ",\"bytesCopied\":" << wireStats.bytesCopied;
+#endif
+
+        stream << "}";
+    }
+
+    stream << "]}\n";
+}
+
+inline void Circuit::SaveTopology( std::ostream& stream )
+{
+    // save components in their optimized order, so that loading needn't re-scan them
+    Optimize();
+
+    std::vector<int> parallelOrder;
+    std::vector<GraphEdge> wires;
+    _GetTopology( parallelOrder, wires );
+
+    auto write = [&stream]( const auto& value ) { stream.write( reinterpret_cast<const char*>( &value ), sizeof( value ) ); };
+
+    stream.write( "DSPTOPO1", 8 );
+
+    write( (int32_t)_bufferCount );
+    write( (int32_t)_threadCount );
+    write( (int32_t)_blockSize );
+
+    write( (uint32_t)_components.size() );
+    for ( auto component : _components )
+    {
+        const auto typeId = ComponentFactory::GetTypeId( *component );
+        write( (uint32_t)typeId.size() );
+        stream.write( typeId.data(), (std::streamsize)typeId.size() );
+    }
+
+    for ( auto index : parallelOrder )
+    {
+        write( (uint32_t)index );
+    }
+
+    write( (uint32_t)wires.size() );
+    for ( const auto& wire : wires )
+    {
+        write( (uint32_t)wire.from );
+        write( (int32_t)wire.fromOutput );
+        write( (uint32_t)wire.to );
+        write( (int32_t)wire.toInput );
+    }
+}
+
+inline void Circuit::SaveTopologyJson( std::ostream& stream )
+{
+    Optimize();
+
+    std::vector<int> parallelOrder;
+    std::vector<GraphEdge> wires;
+    _GetTopology( parallelOrder, wires );
+
+    stream << "{\"bufferCount\":" << _bufferCount << ",\"threadCount\":" << _threadCount << ",\"blockSize\":" << _blockSize
+           << ",\"components\":[";
+
+    for ( size_t i = 0; i < _components.size(); ++i )
+    {
+        stream << ( i == 0 ? "" : "," ) << _Quote( ComponentFactory::GetTypeId( *_components[i] ) );
+    }
+
+    stream << "],\"parallelOrder\":[";
+
+    for ( size_t i = 0; i < parallelOrder.size(); ++i )
+    {
+        stream << ( i == 0 ? "" : "," ) << parallelOrder[i];
+    }
+
+    stream << "],\"wires\":[";
+
+    for ( size_t i = 0; i < wires.size(); ++i )
+    {
+        stream << ( i == 0 ? "" : "," ) << "{\"from\":" << wires[i].from << ",\"fromOutput\":" << wires[i].fromOutput
+               << ",\"to\":" << wires[i].to << ",\"toInput\":" << wires[i].toInput << "}";
+    }
+
+    stream << "]}\n";
+}
+
+inline bool Circuit::LoadTopology( std::istream& stream,
+                                   const ComponentFactory& factory,
+                                   std::vector<Component::SPtr>& components )
+{
+    auto read = [&stream]( auto& value ) { return (bool)stream.read( reinterpret_cast<char*>( &value ), sizeof( value ) ); };
+
+    char magic[8];
+    int32_t bufferCount, threadCount, blockSize;
+    uint32_t componentCount;
+
+    if ( !stream.read( magic, 8 ) || std::string( magic, 8 ) != "DSPTOPO1" || !read( bufferCount ) || !read( threadCount ) ||
+         !read( blockSize ) || !read( componentCount ) || bufferCount < 0 || threadCount < 0 || blockSize <= 0 )
+    {
+        return false;
+    }
+
+    // You might be thinking: Why not size the containers below from the counts read?
+
+    // The counts come from the stream, so a corrupt or truncated one could ask for gigabytes. Reading elements one at a
+    // time (and strings a chunk at a time) instead only ever allocates for what the stream actually holds.
+
+    // create and check everything up front, so that this circuit is left untouched if the topology can't be loaded
+    std::vector<Component::SPtr> loadedComponents;
+
+    for ( uint32_t i = 0; i < componentCount; ++i )
+    {
+        uint32_t typeIdSize;
+        if ( !read( typeIdSize ) )
+        {
+            return false;
+        }
+
+        std::string typeId;
+        while ( typeId.size() < typeIdSize )
+        {
+            char chunk[256];
+            const auto chunkSize = std::min<size_t>( sizeof( chunk ), typeIdSize - typeId.size() );
+
+            if ( !stream.read( chunk, (std::streamsize)chunkSize ) )
+            {
+                return false;
+            }
+            typeId.append( chunk, chunkSize );
+        }
+
+        auto component = factory.Create( typeId );
+        if ( !component )
+        {
+            return false;  // type not registered
+        }
+
+        loadedComponents.emplace_back( std::move( component ) );
+    }
+
+    std::vector<DSPatch::Component*> componentsParallel;
+    componentsParallel.reserve( componentCount );
+
+    std::vector<bool> ordered( componentCount, false );
+    for ( uint32_t i = 0; i < componentCount; ++i )
+    {
+        uint32_t index;
+        if ( !read( index ) || index >= componentCount || ordered[index] )
+        {
+            return false;
+        }
+
+        ordered[index] = true;
+        componentsParallel.emplace_back( loadedComponents[index].get() );
+    }
+
+    uint32_t wireCount;
+    if ( !read( wireCount ) )
+    {
+        return false;
+    }
+
+    std::vector<GraphEdge> wires;
+    for ( uint32_t i = 0; i < wireCount; ++i )
+    {
+        uint32_t from, to;
+        int32_t fromOutput, toInput;
+
+        if ( !read( from ) || !read( fromOutput ) || !read( to ) || !read( toInput ) || from >= componentCount ||
+             to >= componentCount || fromOutput < 0 || fromOutput >= loadedComponents[from]->GetOutputCount() || toInput < 0 ||
+             toInput >= loadedComponents[to]->GetInputCount() )
+        {
+            return false;
+        }
+
+        GraphEdge wire;
+        wire.from = (int)from;
+        wire.fromOutput = fromOutput;
+        wire.to = (int)to;
+        wire.toInput = toInput;
+
+        wires.emplace_back( wire );
+    }
+
+    // replace this circuit's contents in one pass
+    RemoveAllComponents();
+
+    PauseAutoTick();
+
+    SetBufferCount( bufferCount );
+    SetThreadCount( threadCount );
+
+    _blockSize = blockSize;
+
+    _components.reserve( componentCount );
+    _slots.reserve( componentCount );
+    _slotIndices.reserve( componentCount );
+
+    for ( const auto& component : loadedComponents )
+    {
+        _AddComponent( component );
+    }
+
+    _componentsParallel = std::move( componentsParallel );
+
+    for ( const auto& wire : wires )
+    {
+        loadedComponents[wire.to]->ConnectInput( loadedComponents[wire.from], wire.fromOutput, wire.toInput );
+    }
+
+    // the saved order is already optimized, so just plan around it
+    _circuitDirty = false;
+
+    _UpdateReorderPlan();
+    _UpdateShards();
+    _UpdateClockPlan();
+    _CompactState();
+    _PlanGathers();
+
+    ResumeAutoTick();
+
+    components = std::move( loadedComponents );
+
+    return true;
+}
+
+inline bool Circuit::_ValidateEdits() const
+{
+    // components added / removed by earlier edits (overriding _slotIndices)
+    std::unordered_map<const DSPatch::Component*, bool> staged;
+
+    auto contains = [this, &staged]( const Component::SPtr& component ) {
+        if ( auto it = staged.find( component.get() ); it != staged.end() )
+        {
+            return it->second;
+        }
+        return _slotIndices.find( component.get() ) != _slotIndices.end();
+    };
+
+    for ( const auto& edit : _edits )
+    {
+        if ( !edit.component )
+        {
+            return false;
+        }
+
+        switch ( edit.type )
+        {
+            case Edit::Type::Add:
+                if ( contains( edit.component ) )
+                {
+                    return false;
+                }
+                staged[edit.component.get()] = true;
+                break;
+            case Edit::Type::Remove:
+                if ( !contains( edit.component ) )
+                {
+                    return false;
+                }
+                staged[edit.component.get()] = false;
+                break;
+            case Edit::Type::Connect:
+                if ( !edit.toComponent || !contains( edit.component ) || !contains( edit.toComponent ) || edit.fromOutput < 0 ||
+                     edit.fromOutput >= edit.component->GetOutputCount() || edit.toInput < 0 ||
+                     edit.toInput >= edit.toComponent->GetInputCount() )
+                {
+                    return false;
+                }
+                break;
+            case Edit::Type::Disconnect:
+                if ( !contains( edit.component ) )
+                {
+                    return false;
+                }
+                break;
+        }
+    }
+
+    return true;
+}
+
+inline const Circuit::Slot* Circuit::_GetSlot( ComponentId id ) const
+{
+    if ( id.index >= _slots.size() || !_slots[id.index].component || _slots[id.index].generation != id.generation )
+    {
+        return nullptr;
+    }
+
+    return &_slots[id.index];
+}
+
+inline int Circuit::_GetComponentIndex( const DSPatch::Component* component ) const
+{
+    // (components can be wired from producers outside the circuit via Component::ConnectInput(), so these have no index)
+    if ( auto it = _slotIndices.find( component ); it != _slotIndices.end() )
+    {
+        return (int)_slots[it->second].index;
+    }
+
+    return -1;
+}
+
+inline ComponentId Circuit::_AddComponent( const Component::SPtr& component )
+{
+    // components within the circuit need to have as many buffers as there are threads in the circuit
+    component->SetBufferCount( _bufferCount, _currentBuffer, _tickSequence );
+    component->SetBlockSize( _blockSize );
+    component->SetWaitStrategy( _waitStrategy );
+
+    uint32_t slotIndex;
+    if ( !_freeSlots.empty() )
+    {
+        slotIndex = _freeSlots.back();
+        _freeSlots.pop_back();
+    }
+    else
+    {
+        slotIndex = (uint32_t)_slots.size();
+        _slots.emplace_back();
+    }
+
+    auto& slot = _slots[slotIndex];
+    slot.component = component;
+    slot.index = _components.size();
+
+    _slotIndices.emplace( component.get(), slotIndex );
+
+    _components.emplace_back( component.get() );
+    _componentsParallel.emplace_back( component.get() );
+
+    return ComponentId{ slotIndex, slot.generation };
+}
+
+inline void Circuit::_RemoveComponent( uint32_t slotIndex )
+{
+    auto& slot = _slots[slotIndex];
+
+    _DisconnectComponent( slot.component.get() );
+
+    // You might be thinking: Doesn't moving the last component into the gap break the processing order?
+
+    // It does, but so does removing the component's wires, and _DisconnectComponent() has already
+    // flagged the circuit for re-optimization. _Optimize() rebuilds both processing orders before the
+    // next tick, so until then _componentsParallel is simply cleared rather than searched.
+
+    const auto index = slot.index;
+
+    if ( index != _components.size() - 1 )
+    {
+        _components[index] = _components.back();
+        _slots[_slotIndices.find( _components[index] )->second].index = index;
+    }
+    _components.pop_back();
+
+    _componentsParallel.clear();
+    _clockPhases.clear();
+    _clockPhaseIndices.clear();
+    _ClearShards();
+
+    // the component is no longer ticked on our clock
+    slot.component->SetClocked( false, _tickSequence );
+
+    // free the slot (invalidating its ComponentId)
+    _slotIndices.erase( slot.component.get() );
+
+    slot.component = nullptr;
+    ++slot.generation;
+    _freeSlots.emplace_back( slotIndex );
+}
+
+inline void Circuit::_DisconnectComponent( DSPatch::Component* component )
+{
+    // remove this component's wires in both directions (each component tracks its consumers)
+    component->DisconnectAllInputs();
+    component->DisconnectAllOutputs();
+
+    _circuitDirty = true;
+}
+
+inline void Circuit::_Optimize()
+{
+    DSPATCH_PROBE2( optimize_begin, this, (int)_components.size() );
+
+    // scan for optimal series order -> update _components
+    std::vector<DSPatch::Component*> orderedComponents;
+    orderedComponents.reserve( _components.size() );
+
+    // You might be thinking: Why disconnect wires from producers outside the circuit, rather than just skip them?
+
+    // Component::ConnectInput() is public, so a component can be wired from a producer we don't tick. Its consumer
+    // would then wait forever on its output in a threaded circuit, and our scans and plans would have no index for it.
+
+    for ( auto component : _components )
+    {
+        for ( int i = 0; i < component->GetInputCount(); ++i )
+        {
+            const DSPatch::Component* fromComponent;
+            int fromOutput;
+
+            if ( component->GetInputWire( i, fromComponent, fromOutput ) && _GetComponentIndex( fromComponent ) == -1 )
+            {
+                component->DisconnectInput( i );
+            }
+        }
+    }
+
+    for ( auto component : _components )
+    {
+        component->Scan( orderedComponents );
+    }
+    for ( auto component : _components )
+    {
+        component->EndScan();
+    }
+
+    _components = std::move( orderedComponents );
+
+    for ( size_t i = 0; i < _components.size(); ++i )
+    {
+        _slots[_slotIndices.find( _components[i] )->second].index = i;
+    }
+
+    // scan for optimal parallel order -> update _componentsParallel
+    if ( _threadCount != 0 )
+    {
+        std::vector<std::vector<DSPatch::Component*>> componentsMap;
+        componentsMap.reserve( _components.size() );
+
+        int scanPosition;
+        for ( auto component : _components )
+        {
+            component->ScanParallel( componentsMap, scanPosition );
+        }
+        for ( auto component : _components )
+        {
+            component->EndScan();
+        }
+
+        _componentsParallel.clear();
+        _componentsParallel.reserve( _components.size() );
+        for ( auto& componentsMapEntry : componentsMap )
+        {
+            _componentsParallel.insert( _componentsParallel.end(), componentsMapEntry.begin(), componentsMapEntry.end() );
+        }
+    }
+    else
+    {
+        _componentsParallel = _components;
+    }
+
+    // clear _circuitDirty flag
+    _circuitDirty = false;
+
+    _UpdateReorderPlan();
+    _UpdateShards();
+    _UpdateClockPlan();
+    _CompactState();
+    _PlanGathers();
+
+    DSPATCH_PROBE2( optimize_end, this, (int)_components.size() );
+}
+
+inline void Circuit::_UpdateReorderPlan()
+{
+    if ( _circuitDirty )
+    {
+        return;  // _Optimize() will update the plan for the new component order
+    }
+
+    // reordering only applies to buffer threads (with more than one buffer to reorder)
+    auto reorder = _reorderingEnabled && _threadCount == 0 && _bufferCount > 1;
+
+    if ( reorder )
+    {
+        _componentSources.resize( _components.size() );
+
+        for ( size_t i = 0; i < _components.size() && reorder; ++i )
+        {
+            auto component = _components[i];
+
+            _componentSources[i].clear();
+
+            for ( int j = 0; j < component->GetInputCount(); ++j )
+            {
+                const DSPatch::Component* fromComponent;
+                int fromOutput;
+
+                if ( !component->GetInputWire( j, fromComponent, fromOutput ) )
+                {
+                    continue;
+                }
+
+                const auto fromIndex = _GetComponentIndex( fromComponent );
+
+                if ( fromIndex == -1 )
+                {
+                    continue;  // wired from outside the circuit since _Optimize() (see there)
+                }
+
+                // You might be thinking: Why not reorder around feedback wires too?
+
+                // A feedback wire runs backwards, delivering its source's output from the previous tick. Were
+                // the component at its end deferred until after its source, it would receive the current
+                // tick's output instead.
+
+                if ( fromIndex >= (int)i )
+                {
+                    reorder = false;
+                    break;
+                }
+
+                _componentSources[i].emplace_back( fromIndex );
+            }
+        }
+    }
+
+    for ( auto& circuitThread : _circuitThreads )
+    {
+        circuitThread.SetComponentSources( reorder ? &_componentSources : nullptr );
+    }
+}
+
+inline void Circuit::_UpdateShards()
+{
+    if ( _circuitDirty )
+    {
+        return;  // _Optimize() will update the shards for the new component order
+    }
+
+    _shardedComponents.clear();
+
+    if ( _shardingEnabled && _threadCount > 1 )
+    {
+        // find each component's shard (weakly connected component) by merging the shards at either end of each wire
+        std::vector<int> parents( _components.size() );
+        for ( int i = 0; i < (int)parents.size(); ++i )
+        {
+            parents[i] = i;
+        }
+
+        const auto findShard = [&parents]( int i ) {
+            while ( parents[i] != i )
+            {
+                i = parents[i] = parents[parents[i]];
+            }
+            return i;
+        };
+
+        for ( int i = 0; i < (int)_components.size(); ++i )
+        {
+            for ( int j = 0; j < _components[i]->GetInputCount(); ++j )
+            {
+                const DSPatch::Component* fromComponent;
+                int fromOutput;
+
+                // (producers wired from outside the circuit since _Optimize() belong to no shard)
+                if ( _components[i]->GetInputWire( j, fromComponent, fromOutput ) )
+                {
+                    if ( const auto fromIndex = _GetComponentIndex( fromComponent ); fromIndex != -1 )
+                    {
+                        parents[findShard( i )] = findShard( fromIndex );
+                    }
+                }
+            }
+        }
+
+        // gather each shard's components (in series order)
+        std::vector<std::vector<DSPatch::Component*>> shards;
+        std::vector<int> shardIndices( _components.size(), -1 );
+
+        for ( int i = 0; i < (int)_components.size(); ++i )
+        {
+            auto& shardIndex = shardIndices[findShard( i )];
+            if ( shardIndex == -1 )
+            {
+                shardIndex = (int)shards.size();
+                shards.emplace_back();
+            }
+            shards[shardIndex].emplace_back( _components[i] );
+        }
+
+        if ( shards.size() > 1 )
+        {
+            // deal out the largest shards first, each to the thread with the fewest components so far
+            std::stable_sort( shards.begin(), shards.end(), []( const auto& a, const auto& b ) { return a.size() > b.size(); } );
+
+            _shardedComponents.resize( _threadCount );
+            for ( const auto& shard : shards )
+            {
+                auto& threadComponents = *std::min_element( _shardedComponents.begin(),
+                                                            _shardedComponents.end(),
+                                                            []( const auto& a, const auto& b ) { return a.size() < b.size(); } );
+
+                threadComponents.insert( threadComponents.end(), shard.begin(), shard.end() );
+            }
+        }
+    }
+
+    for ( auto& circuitThreads : _circuitThreadsParallel )
+    {
+        for ( size_t i = 0; i < circuitThreads.size(); ++i )
+        {
+            circuitThreads[i].SetShard( _shardedComponents.empty() ? nullptr : &_shardedComponents[i] );
+        }
+    }
+}
+
+inline void Circuit::_ClearShards()
+{
+    // drop the shards' pointers to removed components (Optimize() re-shards whatever components remain)
+    _shardedComponents.clear();
+
+    for ( auto& circuitThreads : _circuitThreadsParallel )
+    {
+        for ( auto& circuitThread : circuitThreads )
+        {
+            circuitThread.SetShard( nullptr );
+        }
+    }
+}
+
+inline void Circuit::_UpdateClockPlan()
+{
+    if ( _circuitDirty )
+    {
+        return;  // _Optimize() will update the plan for the new component order
+    }
+
+    // clock dividers only apply to circuits ticking each tick's components in series, on one buffer
+    auto clocked = _threadCount == 0 && _bufferCount <= 1 &&
+                   std::any_of( _components.begin(), _components.end(), []( auto c ) { return c->GetClockDivider() != 1; } );
+
+    _clockPhases.clear();
+    _clockPhaseIndices.clear();
+
+    for ( auto component : _components )
+    {
+        component->SetClocked( clocked, _tickSequence );
+    }
+
+    if ( clocked )
+    {
+        // You might be thinking: Why a list of components per phase, rather than skip idle components as we go?
+
+        // Checking each component's divider against the tick sequence number would cost a branch (and a
+        // division) per component per tick. Phases share lists wherever the same dividers are due, so
+        // e.g. dividers of 1 and 64 need just 2 lists, however long their combined period.
+
+        std::vector<int> clockDividers;
+        uint64_t clockPeriod = 1;
+
+        for ( auto component : _components )
+        {
+            const auto clockDivider = component->GetClockDivider();
+
+            if ( std::find( clockDividers.begin(), clockDividers.end(), clockDivider ) == clockDividers.end() )
+            {
+                clockDividers.emplace_back( clockDivider );
+
+                // stop at the limit (so that the period can't overflow either)
+                if ( clockPeriod <= DSPATCH_CLOCK_PERIOD_LIMIT )
+                {
+                    clockPeriod = std::lcm( clockPeriod, (uint64_t)clockDivider );
+                }
+            }
+        }
+
+        if ( clockPeriod > DSPATCH_CLOCK_PERIOD_LIMIT )
+        {
+            // too long a period to plan tick by tick, so plan one list of every component, checked as it's ticked
+            clockPeriod = 0;
+            _clockPhases.emplace_back( _components );
+        }
+
+        std::map<std::vector<bool>, int> phases;  // _clockPhases index per set of dividers due
+
+        _clockPhaseIndices.reserve( clockPeriod );
+
+        for ( uint64_t phase = 0; phase < clockPeriod; ++phase )
+        {
+            std::vector<bool> due( clockDividers.size() );
+            for ( size_t i = 0; i < clockDividers.size(); ++i )
+            {
+                due[i] = phase % clockDividers[i] == 0;
+            }
+
+            auto it = phases.find( due );
+
+            if ( it == phases.end() )
+            {
+                it = phases.emplace( due, (int)_clockPhases.size() ).first;
+
+                // components due this phase, in processing order
+                _clockPhases.emplace_back();
+                for ( auto component : _components )
+                {
+                    if ( phase % component->GetClockDivider() == 0 )
+                    {
+                        _clockPhases.back().emplace_back( component );
+                    }
+                }
+            }
+
+            _clockPhaseIndices.emplace_back( it->second );
+        }
+    }
+
+    for ( auto& circuitThread : _circuitThreads )
+    {
+        circuitThread.SetClockPlan( clocked ? &_clockPhases : nullptr, &_clockPhaseIndices, _tickSequence );
+    }
+}
+
+inline void Circuit::_TickClocked( const std::vector<std::vector<DSPatch::Component*>>& clockPhases,
+                                   const std::vector<int>& clockPhaseIndices,
+                                   uint64_t tickSequence )
+{
+    if ( !clockPhaseIndices.empty() )
+    {
+        // tick this phase's components
+        for ( auto component : clockPhases[clockPhaseIndices[tickSequence % clockPhaseIndices.size()]] )
+        {
+            component->Tick();
+        }
+    }
+    else
+    {
+        // the clock period exceeds DSPATCH_CLOCK_PERIOD_LIMIT, so tick whichever components are due
+        for ( auto component : clockPhases.front() )
+        {
+            if ( tickSequence % component->GetClockDivider() == 0 )
+            {
+                component->Tick();
+            }
+        }
+    }
+}
+
+inline void Circuit::_CompactState()
+{
+    if ( !_compactionEnabled && !_stateArena )
+    {
+        return;  // nothing compacted to undo
+    }
+
+    // You might be thinking: Why a fresh arena each pass, rather than reusing the last one?
+
+    // Blocks released back to an arena are reused by size, not position, so relocating into the last arena would scatter the
+    // state over its free blocks. A fresh arena lays it out strictly in tick order, and the last one is released along with
+    // the last of the state in it (each component holds a reference to its state's arena).
+
+    _stateArena = _compactionEnabled ? std::make_shared<ComponentArena>() : nullptr;
+
+    for ( auto component : _components )
+    {
+        component->RelocateState( _stateArena );
+    }
+}
+
+inline void Circuit::_PlanGathers()
+{
+    if ( _circuitDirty )
+    {
+        return;  // _Optimize() will plan around the new wiring
+    }
+
+    // You might be thinking: Why not leave each component to plan its gathers on its next tick?
+
+    // Whatever re-plans the circuit (E.g. re-wiring, or a new buffer or thread count) dirties the gather plans of every
+    // component it touches, so each would be rebuilt on its next tick, by the thread ticking it. Planning them all here
+    // instead keeps that work off the tick path, and (with compaction) lays them out in the circuit's arena in tick order.
+
+    for ( auto component : _components )
+    {
+        component->PlanGathers();
+    }
+}
+
+inline void Circuit::_BuildGraph( std::vector<GraphNode>& nodes, std::vector<GraphEdge>& edges )
+{
+    // stop the auto-tick thread from re-optimizing the circuit while we read it
+    _autoTickThread.Pause();
+
+    // You might be thinking: Why not just Scan() / ScanParallel() the components, as _Optimize() does?
+
+    // Scanning marks each component as it goes, and this only reads the circuit. Walking the input
+    // wires with our own bookkeeping leaves the components untouched, so exporting the graph can't upset
+    // a concurrent _Optimize(), nor leave a component marked as scanned.
+
+    // order components as _Optimize() would (so that wires run forward, except for feedback), and find their parallel levels
+    std::vector<const DSPatch::Component*> orderedComponents;
+    orderedComponents.reserve( _components.size() );
+
+    std::unordered_map<const Component*, int> levels;  // parallel level per component (0 while its inputs are being scanned)
+
+    const auto forEachSource = [this]( const Component* component, const auto& fn ) {
+        for ( int i = 0; i < component->GetInputCount(); ++i )
+        {
+            const Component* fromComponent = nullptr;
+            int fromOutput = -1;
+
+            if ( component->GetInputWire( i, fromComponent, fromOutput ) &&
+                 _slotIndices.find( fromComponent ) != _slotIndices.end() )
+            {
+                fn( fromComponent );
+            }
+        }
+    };
+
+    std::function<void( const Component* )> scan = [&]( const Component* component ) {
+        if ( levels.find( component ) != levels.end() )
+        {
+            return;  // already scanned
+        }
+
+        levels.emplace( component, 0 );
+        forEachSource( component, scan );
+        orderedComponents.emplace_back( component );
+    };
+
+    std::function<int( const Component* )> scanLevel = [&]( const Component* component ) {
+        if ( auto it = levels.find( component ); it != levels.end() )
+        {
+            return it->second;  // already scanned (or still scanning, for feedback wires)
+        }
+
+        // (unordered_map references survive rehashing, so level stays valid as our sources are added)
+        auto& level = levels.emplace( component, 0 ).first->second;
+        forEachSource( component,
+                       [&]( const Component* fromComponent ) { level = std::max( level, scanLevel( fromComponent ) + 1 ); } );
+        return level;
+    };
+
+    for ( auto component : _components )
+    {
+        scan( component );
+    }
+
+    levels.clear();
+
+    for ( auto component : orderedComponents )
+    {
+        scanLevel( component );
+    }
+
+    std::unordered_map<const Component*, int> nodeIndices;
+
+    nodes.resize( orderedComponents.size() );
+    for ( int i = 0; i < (int)nodes.size(); ++i )
+    {
+        nodes[i].component = orderedComponents[i];
+        nodes[i].stats = orderedComponents[i]->GetStats();
+        nodes[i].level = levels[orderedComponents[i]];
+        nodeIndices.emplace( orderedComponents[i], i );
+    }
+
+    if ( !_shardedComponents.empty() )
+    {
+        // circuit thread j ticks the shards dealt to it
+        for ( int i = 0; i < (int)_shardedComponents.size(); ++i )
+        {
+            for ( auto component : _shardedComponents[i] )
+            {
+                if ( auto it = nodeIndices.find( component ); it != nodeIndices.end() )
+                {
+                    nodes[it->second].thread = i;
+                }
+            }
+        }
+    }
+    // circuit thread j ticks every _threadCount'th component of _componentsParallel, starting from j
+    else if ( _threadCount != 0 )
+    {
+        for ( int i = 0; i < (int)_componentsParallel.size(); ++i )
+        {
+            if ( auto it = nodeIndices.find( _componentsParallel[i] ); it != nodeIndices.end() )
+            {
+                nodes[it->second].thread = i % _threadCount;
+            }
+        }
+    }
+
+    // find the most expensive chain of forward wires ending at each node
+    std::vector<double> pathTimes( nodes.size(), 0.0 );
+    std::vector<int> pathEdges( nodes.size(), -1 );
+
+    for ( int i = 0; i < (int)nodes.size(); ++i )
+    {
+        for ( int j = 0; j < nodes[i].component->GetInputCount(); ++j )
+        {
+            const Component* fromComponent = nullptr;
+            int fromOutput = -1;
+
+            if ( !nodes[i].component->GetInputWire( j, fromComponent, fromOutput ) )
+            {
+                continue;
+            }
+
+            auto it = nodeIndices.find( fromComponent );
+            if ( it == nodeIndices.end() )
+            {
+                continue;  // wired from outside of this circuit
+            }
+
+            edges.emplace_back( GraphEdge{ it->second, fromOutput, i, j, it->second >= i, false } );
+
+            if ( !edges.back().feedback && ( pathEdges[i] == -1 || pathTimes[it->second] > pathTimes[edges[pathEdges[i]].from] ) )
+            {
+                pathEdges[i] = (int)edges.size() - 1;
+            }
+        }
+
+        // (+1 so that, without timings, the longest chain wins)
+        pathTimes[i] = 1.0 + nodes[i].stats.processTime.GetMean();
+        if ( pathEdges[i] != -1 )
+        {
+            pathTimes[i] += pathTimes[edges[pathEdges[i]].from];
+        }
+    }
+
+    // walk the critical path back from its most expensive end
+    if ( !nodes.empty() )
+    {
+        auto node = (int)( std::max_element( pathTimes.begin(), pathTimes.end() ) - pathTimes.begin() );
+
+        while ( true )
+        {
+            nodes[node].critical = true;
+
+            if ( pathEdges[node] == -1 )
+            {
+                break;
+            }
+
+            edges[pathEdges[node]].critical = true;
+            node = edges[pathEdges[node]].from;
+        }
+    }
+
+    _autoTickThread.Resume();
+}
+
+inline void Circuit::_GetTopology( std::vector<int>& parallelOrder, std::vector<GraphEdge>& wires ) const
+{
+    std::unordered_map<const Component*, int> componentIndices;
+    for ( int i = 0; i < (int)_components.size(); ++i )
+    {
+        componentIndices.emplace( _components[i], i );
+    }
+
+    for ( auto component : _componentsParallel )
+    {
+        parallelOrder.emplace_back( componentIndices[component] );
+    }
+
+    for ( int i = 0; i < (int)_components.size(); ++i )
+    {
+        for ( int j = 0; j < _components[i]->GetInputCount(); ++j )
+        {
+            const Component* fromComponent = nullptr;
+            int fromOutput = -1;
+
+            if ( !_components[i]->GetInputWire( j, fromComponent, fromOutput ) )
+            {
+                continue;
+            }
+
+            if ( auto it = componentIndices.find( fromComponent ); it != componentIndices.end() )
+            {
+                wires.emplace_back( GraphEdge{ it->second, fromOutput, i, j, false, false } );
+            }
+        }
+    }
+}
+
+inline std::string Circuit::_Quote( const std::string& string )
+{
+    // quoted and escaped for both DOT and JSON
+    std::string quoted = "\"";
+
+    for ( auto c : string )
+    {
+        switch ( c )
+        {
+            case '"':
+                quoted += "\\\"";
+                break;
+            case '\\':
+                quoted += "\\\\";
+                break;
+            case '\n':
+                quoted += "\\n";
+                break;
+            default:
+                quoted += c;
+        }
+    }
+
+    return quoted + "\"";
+}
+
+inline void Circuit::_CollectLatency( int bufferNo )
+{
+    if ( bufferNo >= (int)_queueTimes.size() )
+    {
+        return;
+    }
+
+    // a buffer is picked up when its first thread starts, and completes when its last thread ends
+    bool timed = false;
+    uint64_t submitTime = std::numeric_limits<uint64_t>::max();
+    uint64_t startTime = std::numeric_limits<uint64_t>::max();
+    uint64_t endTime = 0;
+
+    auto collect = [&]( auto& circuitThread ) {
+        uint64_t threadSubmitTime, threadStartTime, threadEndTime;
+        if ( circuitThread.CollectLatency( threadSubmitTime, threadStartTime, threadEndTime ) )
+        {
+            timed = true;
+            submitTime = std::min( submitTime, threadSubmitTime );
+            startTime = std::min( startTime, threadStartTime );
+            endTime = std::max( endTime, threadEndTime );
+        }
+    };
+
+    if ( _threadCount != 0 )
+    {
+        if ( bufferNo < (int)_circuitThreadsParallel.size() )
+        {
+            for ( auto& circuitThread : _circuitThreadsParallel[bufferNo] )
+            {
+                collect( circuitThread );
+            }
+        }
+    }
+    else if ( bufferNo < (int)_circuitThreads.size() )
+    {
+        collect( _circuitThreads[bufferNo] );
+    }
+
+    if ( timed )
+    {
+        _queueTimes[bufferNo].Record( startTime - submitTime );
+        _completionTimes[bufferNo].Record( endTime - submitTime );
+    }
+}
+
+inline void Circuit::_UpdateFlightRings()
+{
+    // must be called while paused (all circuit threads synced)
+    _flightRings.clear();
+
+    auto addFlightRing = [this]( int threadNo ) -> internal::FlightRing* {
+        if ( !_flightRecorderEnabled )
+        {
+            return nullptr;
+        }
+        _flightRings.emplace_back( std::make_unique<internal::FlightRing>( threadNo ) );
+        return _flightRings.back().get();
+    };
+
+    addFlightRing( -1 );  // the caller's thread
+
+    for ( auto& circuitThread : _circuitThreads )
+    {
+        circuitThread.SetFlightRing( addFlightRing( 0 ) );
+    }
+    for ( auto& circuitThreads : _circuitThreadsParallel )
+    {
+        int threadNo = 0;
+        for ( auto& circuitThread : circuitThreads )
+        {
+            circuitThread.SetFlightRing( addFlightRing( threadNo++ ) );
+        }
+    }
+}
+
+inline void Circuit::_CheckFlightRecorder( int bufferNo )
+{
+    // a buffer's tick starts when its first thread starts, and ends when its last thread ends
+    bool spanned = false;
+    uint64_t startTime = std::numeric_limits<uint64_t>::max();
+    uint64_t endTime = 0;
+
+    auto collect = [&]( auto& circuitThread ) {
+        uint64_t threadStartTime, threadEndTime;
+        if ( circuitThread.CollectTickSpan( threadStartTime, threadEndTime ) )
+        {
+            spanned = true;
+            startTime = std::min( startTime, threadStartTime );
+            endTime = std::max( endTime, threadEndTime );
+        }
+    };
+
+    if ( _threadCount != 0 )
+    {
+        if ( bufferNo < (int)_circuitThreadsParallel.size() )
+        {
+            for ( auto& circuitThread : _circuitThreadsParallel[bufferNo] )
+            {
+                collect( circuitThread );
+            }
+        }
+    }
+    else if ( bufferNo < (int)_circuitThreads.size() )
+    {
+        collect( _circuitThreads[bufferNo] );
+    }
+
+    if ( spanned )
+    {
+        _TriggerFlightRecorder( endTime - startTime, bufferNo );
+    }
+}
+
+inline void Circuit::_TriggerFlightRecorder( uint64_t tickTime, int bufferNo )
+{
+    if ( _flightRecorderHoldoff != 0 )
+    {
+        --_flightRecorderHoldoff;
+        return;
+    }
+
+    if ( _flightRecorderThreshold == 0 || tickTime <= _flightRecorderThreshold )
+    {
+        return;
+    }
+
+    std::ofstream stream( _flightRecorderPath, std::ios::binary );
+    if ( stream )
+    {
+        _DumpFlightRecord( stream, tickTime, bufferNo );
+        ++_flightRecorderDumpCount;
+    }
+
+    // let the rings fill with fresh history before dumping again
+    _flightRecorderHoldoff = DSPATCH_FLIGHT_RECORDER_CAPACITY;
+}
+
+inline void Circuit::_DumpFlightRecord( std::ostream& stream, uint64_t tickTime, int bufferNo ) const
+{
+    auto write = [&stream]( const auto& value ) { stream.write( reinterpret_cast<const char*>( &value ), sizeof( value ) ); };
+
+    stream.write( "DSPFLTR1", 8 );
+
+    write( tickTime == 0 ? (uint64_t)0 : _flightRecorderThreshold );
+    write( tickTime );
+    write( (int32_t)bufferNo );
+
+    write( (uint32_t)_components.size() );
+    for ( auto component : _components )
+    {
+        const auto name = internal::DemangleTypeName( typeid( *component ) );
+        write( (uint32_t)name.size() );
+        stream.write( name.data(), (std::streamsize)name.size() );
+    }
+
+    const auto records = GetFlightRecord();
+
+    write( (uint32_t)records.size() );
+    for ( const auto& record : records )
+    {
+        write( (int32_t)record.componentIndex );
+        write( (int32_t)record.bufferNo );
+        write( (int32_t)record.threadNo );
+        write( record.startTime );
+        write( record.endTime );
+    }
 }
 
 }  // namespace DSPatch
@@ -28,10 +28,16 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #pragma once
 
+#include "ComponentArena.h"
+#include "FlightRecorder.h"
+#include "Probes.h"
 #include "SignalBus.h"
+#include "Stats.h"
+#include "Trace.h"
 
 #include <algorithm>
 #include <atomic>
+#include <cstdint>
 #include <string>
 #include <thread>
 #include <vector>
@@ -39,6 +45,30 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 namespace DSPatch
 {
 
+namespace internal
+{
+
+// the tick sequence number of the Process_() call running on the current thread (see Component::GetTickSequence_())
+inline uint64_t& ThreadTickSequence()
+{
+    thread_local uint64_t tickSequence = 0;
+    return tickSequence;
+}
+
+// hints to the CPU that the current thread is busy-waiting
+inline void CpuRelax()
+{
+#if defined( _MSC_VER ) && ( defined( _M_X64 ) || defined( _M_IX86 ) )
+    _mm_pause();
+#elif ( defined( __GNUC__ ) || defined( __clang__ ) ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+    __builtin_ia32_pause();
+#elif ( defined( __GNUC__ ) || defined( __clang__ ) ) && defined( __aarch64__ )
+    asm volatile( "yield" );
+#endif
+}
+
+}  // namespace internal
+
 /// Abstract base class for DSPatch components
 
 /**
@@ -56,9 +86,31 @@ In order for a component to do any work it must be ticked. This is performed by
 is responsible for acquiring the next set of input signals from its input wires and populating the component's input bus. The
 acquired input bus is then passed to the Process_() method.
 
+Components that process blocks of samples (see Block) should size the blocks they create according to GetBlockSize(). This is
+configured circuit-wide via Circuit::SetBlockSize().
+
 <b>PERFORMANCE TIP:</b> If a component is capable of processing its buffers out-of-order within a stream processing circuit,
 consider initialising its base with ProcessOrder::OutOfOrder to improve performance. Note however that Process_() must be
 thread-safe to operate in this mode.
+
+In a multi-buffered circuit, the buffers of an in-order component take turns to call Process_(), in the order they were ticked.
+Each buffer waits for its turn on a per-component ticket: the sequence number of the circuit tick it is processing (available from
+within Process_() via GetTickSequence_()). How a buffer waits is configured via SetWaitStrategy() (see WaitStrategy).
+
+Components that only need to process every Nth tick (E.g. control-rate envelopes and parameter smoothers) can be given a clock
+divider via Circuit::SetClockDivider(). Such a component processes on ticks whose sequence number is a multiple of its divider,
+and is skipped entirely on all others. On those idle ticks, consumers of its outputs see them as either held at their last values,
+or absent (see IdleOutput). A component doesn't know its circuit, so calling its own SetClockDivider() directly only takes effect
+once the circuit is next re-optimized (after its next edit), whereas Circuit::SetClockDivider() flags the circuit for
+re-optimization.
+
+When DSPatch is compiled with DSPATCH_ENABLE_STATS defined, each tick of a component records the time spent gathering its inputs,
+waiting on other components / buffers, and processing, into lock-free histograms. A snapshot of these is returned by GetStats()
+(see ComponentStats and Circuit::GetStats()). Without DSPATCH_ENABLE_STATS, this instrumentation is compiled out entirely.
+Similarly, with DSPATCH_ENABLE_TRACE defined, each tick, Process_() call and spin-wait is recorded as a timeline event (see
+StartTrace()).
+Independent of these, each tick is also logged to its circuit's flight recorder while it is enabled (see
+Circuit::SetFlightRecorderEnabled()).
 */
 
 class Component
@@ -75,6 +127,19 @@ public:
         OutOfOrder
     };
 
+    enum class WaitStrategy
+    {
+        Yield,   // yield the thread between checks (default)
+        Spin,    // busy-wait (lowest wake-up latency, but occupies a core while waiting)
+        Backoff  // busy-wait briefly, then yield between checks
+    };
+
+    enum class IdleOutput
+    {
+        Hold,   // consumers see the outputs of our last Process_() on ticks we're idle (default)
+        Absent  // consumers see no outputs on ticks we're idle
+    };
+
     Component( ProcessOrder processOrder = ProcessOrder::InOrder );
     virtual ~Component();
 
@@ -83,6 +148,7 @@ public:
     void DisconnectInput( int inputNo );
     void DisconnectInput( const Component::SPtr& fromComponent );
     void DisconnectAllInputs();
+    void DisconnectAllOutputs();
 
     int GetInputCount() const;
     int GetOutputCount() const;
@@ -90,25 +156,52 @@ public:
     std::string GetInputName( int inputNo ) const;
     std::string GetOutputName( int outputNo ) const;
 
-    void SetBufferCount( int bufferCount, int startBuffer );
+    bool GetInputWire( int inputNo, const Component*& fromComponent, int& fromOutput ) const;
+
+    void SetBufferCount( int bufferCount, int startBuffer, uint64_t startSequence = 0 );
     int GetBufferCount() const;
 
+    void SetWaitStrategy( WaitStrategy waitStrategy );
+    WaitStrategy GetWaitStrategy() const;
+
+    void SetBlockSize( int blockSize );
+    int GetBlockSize() const;
+
+    void SetClockDivider( int clockDivider, IdleOutput idleOutput = IdleOutput::Hold );
+    int GetClockDivider() const;
+    IdleOutput GetIdleOutput() const;
+
+    void SetClocked( bool clocked, uint64_t startSequence );
+
+    void RelocateState( const ComponentArena::SPtr& arena );
+    void PlanGathers();
+
     void Tick();
     void Tick( int bufferNo );
     void TickParallel();
     void TickParallel( int bufferNo );
 
+    bool IsBufferReleased( int bufferNo ) const;
+
     void Scan( std::vector<Component*>& components );
     void ScanParallel( std::vector<std::vector<DSPatch::Component*>>& componentsMap, int& scanPosition );
     void EndScan();
 
+    ComponentStats GetStats() const;
+    void ResetStats();
+
 protected:
     inline virtual void Process_( SignalBus&, SignalBus& ) = 0;
 
+    uint64_t GetTickSequence_() const;
+
     void SetInputCount_( int inputCount, const std::vector<std::string>& inputNames = {} );
     void SetOutputCount_( int outputCount, const std::vector<std::string>& outputNames = {} );
 
 private:
+    template <typename T>
+    using StateVector = std::vector<T, internal::StateAllocator<T>>;  // allocated from _stateArena (see RelocateState())
+
     class AtomicFlag final
     {
     public:
@@ -123,10 +216,29 @@ private:
 
         inline void WaitAndClear()
         {
+#if defined( DSPATCH_ENABLE_STATS ) || defined( DSPATCH_ENABLE_TRACE ) || defined( DSPATCH_ENABLE_PROBES )
+            if ( !flag.test_and_set( std::memory_order_acquire ) )
+            {
+                return;  // no wait, nothing to record
+            }
+
+            DSPATCH_PROBE1( wait_begin, this );
+            DSPATCH_TRACE( internal::TraceScope traceScope( "Wait" ); )
+            DSPATCH_STATS( const auto startTime = internal::StatsClock::now(); )
+
             while ( flag.test_and_set( std::memory_order_acquire ) )
             {
                 std::this_thread::yield();
             }
+
+            DSPATCH_STATS( internal::StatsThreadWaitTime() += internal::StatsElapsed( startTime, internal::StatsClock::now() ); )
+            DSPATCH_PROBE1( wait_end, this );
+#else
+            while ( flag.test_and_set( std::memory_order_acquire ) )
+            {
+                std::this_thread::yield();
+            }
+#endif
         }
 
         inline void Set()
@@ -157,29 +269,72 @@ private:
         int toInput;
     };
 
+    struct Gather final
+    {
+        fast_any::any* signal;    // source component's output signal
+        RefCounter* ref;          // source component's output reference counter
+        fast_any::any* toSignal;  // our input signal
+        int toInput;
+        bool sole;        // ours is the source output's only wire, so its signal is always moved
+        bool held;        // clocked gathers only: the source holds its outputs while idle
+        int clockStride;  // clocked gathers only: the source processes every clockStride'th tick
+    };
+
+    struct GatherPlan final
+    {
+        StateVector<Gather> gathers;         // Gather per input wire
+        StateVector<Gather> clockedGathers;  // Gather per input wire from an output crossing clock rates
+        bool dirty = true;
+    };
+
+    struct alignas( 64 ) BufferState final  // aligned to (and padded to a multiple of) a cache line
+    {
+        DSPatch::SignalBus inputBus;
+        DSPatch::SignalBus outputBus;
+        StateVector<RefCounter> refs;  // RefCounter per output
+        GatherPlan gatherPlan;
+        uint64_t sequence = 0;  // tick sequence number this buffer processes next
+        DSPATCH_STATS( internal::ComponentStatsRecorder stats; )
+    };
+
+    void _Process( DSPatch::SignalBus& inputBus, DSPatch::SignalBus& outputBus, int bufferNo );
+
     void _WaitForRelease( int bufferNo );
     void _ReleaseNextBuffer( int bufferNo );
 
-    void _GetOutput( int fromOutput, int toInput, DSPatch::SignalBus& toBus );
-    void _GetOutput( int bufferNo, int fromOutput, int toInput, DSPatch::SignalBus& toBus );
-    void _GetOutputParallel( int fromOutput, int toInput, DSPatch::SignalBus& toBus );
-    void _GetOutputParallel( int bufferNo, int fromOutput, int toInput, DSPatch::SignalBus& toBus );
+    const StateVector<Gather>& _GetGathers( int bufferNo );
+    void _SetGathersDirty();
+    void _SetConsumerGathersDirty();
 
-    void _IncRefs( int output );
-    void _DecRefs( int output );
+    static internal::SignalTransfer _Gather( const Gather& gather );
+    static internal::SignalTransfer _GatherParallel( const Gather& gather );
+    static internal::SignalTransfer _GatherClocked( const Gather& gather, uint64_t sequence );
+
+    bool _IsOutputClocked( int output ) const;
+
+    void _DisconnectInput( const DSPatch::Component* fromComponent );
+
+    void _IncRefs( int output, DSPatch::Component* toComponent );
+    void _DecRefs( int output, const DSPatch::Component* toComponent );
 
     const DSPatch::Component::ProcessOrder _processOrder;
 
     int _bufferCount = 0;
+    int _blockSize = 256;
 
-    std::vector<DSPatch::SignalBus> _inputBuses;
-    std::vector<DSPatch::SignalBus> _outputBuses;
+    int _clockDivider = 1;
+    int _clockStride = 1;  // _clockDivider while our circuit is ticking us on it, otherwise 1
+    IdleOutput _idleOutput = IdleOutput::Hold;
 
-    std::vector<std::vector<RefCounter>> _refs;  // RefCounter per output, per buffer
+    WaitStrategy _waitStrategy = WaitStrategy::Yield;
 
-    std::vector<Wire> _inputWires;
+    std::atomic<uint64_t> _releaseSequence = 0;  // tick sequence number whose turn it is to process
 
-    std::vector<AtomicFlag> _releaseFlags;
+    ComponentArena::SPtr _stateArena;  // (declared before our state, so as to outlive it)
+    StateVector<BufferState> _buffers;
+
+    std::vector<Wire> _inputWires;
+    std::vector<DSPatch::Component*> _consumers;  // component at the end of each output wire
 
     std::vector<std::string> _inputNames;
     std::vector<std::string> _outputNames;
@@ -214,12 +369,12 @@ inline bool Component::ConnectInput( const Component::SPtr& fromComponent, int f
         }
 
         // update source output's reference count
-        it->fromComponent->_DecRefs( it->fromOutput );
+        it->fromComponent->_DecRefs( it->fromOutput, this );
 
         // clear input
-        for ( auto& inputBus : _inputBuses )
+        for ( auto& buffer : _buffers )
         {
-            inputBus.ClearValue( toInput );
+            buffer.inputBus.ClearValue( toInput );
         }
 
         // replace wire
@@ -233,7 +388,9 @@ inline bool Component::ConnectInput( const Component::SPtr& fromComponent, int f
     }
 
     // update source output's reference count
-    fromComponent->_IncRefs( fromOutput );
+    fromComponent->_IncRefs( fromOutput, this );
+
+    _SetGathersDirty();
 
     return true;
 }
@@ -246,39 +403,24 @@ inline void Component::DisconnectInput( int inputNo )
     if ( auto it = std::find_if( _inputWires.begin(), _inputWires.end(), findFn ); it != _inputWires.end() )
     {
         // update source output's reference count
-        it->fromComponent->_DecRefs( it->fromOutput );
+        it->fromComponent->_DecRefs( it->fromOutput, this );
 
         // clear input
-        for ( auto& inputBus : _inputBuses )
+        for ( auto& buffer : _buffers )
         {
-            inputBus.ClearValue( inputNo );
+            buffer.inputBus.ClearValue( inputNo );
         }
 
         // remove wire
         _inputWires.erase( it );
+
+        _SetGathersDirty();
     }
 }
 
 inline void Component::DisconnectInput( const Component::SPtr& fromComponent )
 {
-    // remove fromComponent from _inputWires
-    auto findFn = [&fromComponent]( const auto& wire ) { return wire.fromComponent == fromComponent.get(); };
-
-    for ( auto it = std::find_if( _inputWires.begin(), _inputWires.end(), findFn ); it != _inputWires.end();
-          it = std::find_if( it, _inputWires.end(), findFn ) )
-    {
-        // update source output's reference count
-        fromComponent->_DecRefs( it->fromOutput );
-
-        // clear input
-        for ( auto& inputBus : _inputBuses )
-        {
-            inputBus.ClearValue( it->toInput );
-        }
-
-        // remove wire
-        it = _inputWires.erase( it );
-    }
+    _DisconnectInput( fromComponent.get() );
 }
 
 inline void Component::DisconnectAllInputs()
@@ -286,27 +428,38 @@ inline void Component::DisconnectAllInputs()
     // update all source output reference counts
     for ( const auto& wire : _inputWires )
     {
-        wire.fromComponent->_DecRefs( wire.fromOutput );
+        wire.fromComponent->_DecRefs( wire.fromOutput, this );
     }
 
     // clear all inputs
-    for ( auto& inputBus : _inputBuses )
+    for ( auto& buffer : _buffers )
     {
-        inputBus.ClearAllValues();
+        buffer.inputBus.ClearAllValues();
     }
 
     // remove all wires
     _inputWires.clear();
+
+    _SetGathersDirty();
+}
+
+inline void Component::DisconnectAllOutputs()
+{
+    // each consumer removes itself from _consumers as its wires from this component are removed
+    while ( !_consumers.empty() )
+    {
+        _consumers.back()->_DisconnectInput( this );
+    }
 }
 
 inline int Component::GetInputCount() const
 {
-    return _inputBuses[0].GetSignalCount();
+    return _buffers[0].inputBus.GetSignalCount();
 }
 
 inline int Component::GetOutputCount() const
 {
-    return _outputBuses[0].GetSignalCount();
+    return _buffers[0].outputBus.GetSignalCount();
 }
 
 // cppcheck-suppress unusedFunction
@@ -329,7 +482,21 @@ inline std::string Component::GetOutputName( int outputNo ) const
     return "";
 }
 
-inline void Component::SetBufferCount( int bufferCount, int startBuffer )
+inline bool Component::GetInputWire( int inputNo, const Component*& fromComponent, int& fromOutput ) const
+{
+    for ( const auto& wire : _inputWires )
+    {
+        if ( wire.toInput == inputNo )
+        {
+            fromComponent = wire.fromComponent;
+            fromOutput = wire.fromOutput;
+            return true;
+        }
+    }
+    return false;
+}
+
+inline void Component::SetBufferCount( int bufferCount, int startBuffer, uint64_t startSequence )
 {
     // _bufferCount is the current thread count / bufferCount is new thread count
 
@@ -343,42 +510,47 @@ inline void Component::SetBufferCount( int bufferCount, int startBuffer )
         startBuffer = 0;
     }
 
-    // resize vectors
-    _inputBuses.resize( bufferCount );
-    _outputBuses.resize( bufferCount );
+    // You might be thinking: Why one vector of buffers rather than a vector per buffered member?
 
-    _releaseFlags.resize( bufferCount );
+    // Different threads tick different buffers, so any two buffers' state should never share a cache line
+    // (each write would otherwise invalidate the line for the other thread). Keeping all of a buffer's
+    // state together, in one cache line aligned BufferState and a cache line aligned slab of storage for
+    // its signals, refs and gathers (see RelocateState()), also means that ticking a buffer touches as few
+    // lines as possible.
 
-    _refs.resize( bufferCount );
+    _buffers.resize( bufferCount );
 
     const auto inputCount = GetInputCount();
     const auto outputCount = GetOutputCount();
-    const auto refCount = _refs[0].size();
+    const auto refCount = _buffers.front().refs.size();
 
-    // init vector values
+    // init buffer values
     for ( int i = 0; i < bufferCount; ++i )
     {
-        _inputBuses[i].SetSignalCount( inputCount );
-        _outputBuses[i].SetSignalCount( outputCount );
+        auto& buffer = _buffers[i];
 
-        if ( i == startBuffer )
-        {
-            _releaseFlags[i].Set();
-        }
-        else
-        {
-            _releaseFlags[i].Clear();
-        }
+        buffer.inputBus.SetSignalCount( inputCount );
+        buffer.outputBus.SetSignalCount( outputCount );
 
-        _refs[i].resize( refCount );
+        // startBuffer processes startSequence, and each following buffer (wrapping around) the tick after
+        buffer.sequence = startSequence + (uint64_t)( ( i - startBuffer + bufferCount ) % bufferCount );
+
+        buffer.refs.resize( refCount );
         for ( size_t j = 0; j < refCount; ++j )
         {
             // sync output reference counts
-            _refs[i][j].total = _refs[0][j].total;
+            buffer.refs[j].total = _buffers.front().refs[j].total;
         }
+
+        DSPATCH_STATS( buffer.stats.transfers.SetInputCount( inputCount ); )
     }
 
     _bufferCount = bufferCount;
+
+    _releaseSequence.store( startSequence, std::memory_order_release );
+
+    // lay our buffers' state out afresh, in a slab of our own
+    RelocateState( nullptr );
 }
 
 inline int Component::GetBufferCount() const
@@ -386,37 +558,206 @@ inline int Component::GetBufferCount() const
     return _bufferCount;
 }
 
-inline void Component::Tick()
+inline void Component::SetWaitStrategy( WaitStrategy waitStrategy )
 {
-    auto& inputBus = _inputBuses.front();
+    _waitStrategy = waitStrategy;
+}
+
+inline Component::WaitStrategy Component::GetWaitStrategy() const
+{
+    return _waitStrategy;
+}
+
+inline void Component::SetBlockSize( int blockSize )
+{
+    _blockSize = blockSize;
+}
+
+inline int Component::GetBlockSize() const
+{
+    return _blockSize;
+}
+
+inline void Component::SetClockDivider( int clockDivider, IdleOutput idleOutput )
+{
+    // takes effect once our circuit next calls SetClocked() (only single-buffered, unthreaded circuits clock their components)
+    _clockDivider = std::max( clockDivider, 1 );
+    _idleOutput = idleOutput;
+}
+
+inline int Component::GetClockDivider() const
+{
+    return _clockDivider;
+}
+
+inline Component::IdleOutput Component::GetIdleOutput() const
+{
+    return _idleOutput;
+}
+
+inline void Component::SetClocked( bool clocked, uint64_t startSequence )
+{
+    _clockStride = clocked ? _clockDivider : 1;
+
+    if ( _bufferCount == 1 )
+    {
+        // we process the first tick from startSequence on that's a multiple of our stride
+        _buffers.front().sequence = ( startSequence + _clockStride - 1 ) / _clockStride * _clockStride;
+    }
+
+    // whether a wire crosses clock rates depends on the strides at both of its ends, and those of the source output's other wires
+    _SetGathersDirty();
+    _SetConsumerGathersDirty();
 
     for ( const auto& wire : _inputWires )
+    {
+        wire.fromComponent->_SetConsumerGathersDirty();
+    }
+}
+
+inline void Component::RelocateState( const ComponentArena::SPtr& arena )
+{
+    // must only be called while we're not being ticked (our circuit calls this once optimized)
+
+    // You might be thinking: Why move our buffers' state rather than the component itself?
+
+    // Components are owned (and allocated) by whoever created them, so only the state we manage ourselves can be moved. It is
+    // also what's touched each tick: our buffers, their gathers resolving our input wires, their buses' signals, and their
+    // outputs' reference counters. Relocating each component's state in tick order lays all of it out in that order in the
+    // arena, so ticking the circuit walks forward through memory. Passing a null arena moves the state into a slab of our own.
+
+    const auto inputCount = (size_t)GetInputCount();
+    const auto outputCount = (size_t)GetOutputCount();
+
+    auto stateArena = arena;
+
+    if ( !stateArena )
+    {
+        // size our slab to fit every buffer's state, each padded out to whole cache lines
+        const auto bufferSize = inputCount * sizeof( Gather ) + ( inputCount + outputCount ) * sizeof( fast_any::any ) +
+                                outputCount * sizeof( RefCounter ) + 3 * alignof( std::max_align_t );
+        const auto slabSize = _buffers.size() * ( sizeof( BufferState ) + ( bufferSize + 63 ) / 64 * 64 ) + 64;
+
+        stateArena = std::make_shared<ComponentArena>( slabSize );
+    }
+
+    const internal::StateAllocator<BufferState> allocator( stateArena.get() );
+
+    StateVector<BufferState> buffers( allocator );
+    buffers.reserve( _buffers.size() );
+
+    for ( auto& buffer : _buffers )
+    {
+        auto& relocated = buffers.emplace_back( std::move( buffer ) );
+
+        // each buffer's state starts on a cache line of its own (so no two buffers share one), and follows in the order it's
+        // touched per tick: gathers, input signals, output signals, then refs
+        stateArena->AlignNext( 64 );
+
+        // the gathers are rebuilt before our next tick, into the arena space reserved for them here (an input has at most 1 wire)
+        relocated.gatherPlan.gathers = StateVector<Gather>( allocator );
+        relocated.gatherPlan.gathers.reserve( inputCount );
+        relocated.gatherPlan.clockedGathers = StateVector<Gather>( allocator );
+
+        relocated.inputBus._Relocate( stateArena.get() );
+        relocated.outputBus._Relocate( stateArena.get() );
+
+        StateVector<RefCounter> refs( allocator );
+        refs.resize( relocated.refs.size() );
+
+        for ( size_t i = 0; i < refs.size(); ++i )
+        {
+            // (flags are all clear while we're not being ticked)
+            refs[i].count = relocated.refs[i].count;
+            refs[i].total = relocated.refs[i].total;
+        }
+
+        relocated.refs = std::move( refs );
+    }
+
+    _buffers = std::move( buffers );
+
+    // our old state has been released back into the old arena, so now we can let go of that
+    _stateArena = stateArena;
+
+    // our buses and refs may have moved
+    _SetGathersDirty();
+    _SetConsumerGathersDirty();
+}
+
+inline void Component::PlanGathers()
+{
+    // must only be called while we're not being ticked (our circuit calls this once optimized, so that no tick has to)
+    for ( int i = 0; i < _bufferCount; ++i )
+    {
+        _GetGathers( i );
+    }
+}
+
+inline void Component::Tick()
+{
+    DSPATCH_PROBE2( component_tick_begin, this, 0 );
+    DSPATCH_TRACE( internal::TraceScope traceScope( "Tick", 0, &typeid( *this ) ); )
+    internal::FlightScope flightScope( this, 0 );
+    DSPATCH_STATS( internal::StatsTimer statsTimer( _buffers.front().stats ); )
+
+    auto& inputBus = _buffers.front().inputBus;
+
+    for ( const auto& gather : _GetGathers( 0 ) )
     {
         // get new inputs from incoming components
-        wire.fromComponent->_GetOutput( wire.fromOutput, wire.toInput, inputBus );
+        [[maybe_unused]] const auto transfer = _Gather( gather );
+        DSPATCH_STATS( _buffers.front().stats.transfers.Record( gather.toInput, transfer, *gather.toSignal ); )
+    }
+
+    for ( const auto& gather : _buffers.front().gatherPlan.clockedGathers )
+    {
+        // get held (or absent) inputs from incoming components running at other rates
+        [[maybe_unused]] const auto transfer = _GatherClocked( gather, _buffers.front().sequence );
+        DSPATCH_STATS( _buffers.front().stats.transfers.Record( gather.toInput, transfer, *gather.toSignal ); )
     }
 
+    DSPATCH_STATS( statsTimer.EndGather(); )
+
     // call Process_() with newly aquired inputs
-    Process_( inputBus, _outputBuses.front() );
+    _Process( inputBus, _buffers.front().outputBus, 0 );
+
+    DSPATCH_STATS( statsTimer.EndProcess(); )
+
+    _buffers.front().sequence += (uint64_t)_bufferCount * _clockStride;
+
+    DSPATCH_PROBE2( component_tick_end, this, 0 );
 }
 
 inline void Component::Tick( int bufferNo )
 {
-    auto& inputBus = _inputBuses[bufferNo];
+    DSPATCH_PROBE2( component_tick_begin, this, bufferNo );
+    DSPATCH_TRACE( internal::TraceScope traceScope( "Tick", bufferNo, &typeid( *this ) ); )
+    internal::FlightScope flightScope( this, bufferNo );
+    DSPATCH_STATS( internal::StatsTimer statsTimer( _buffers[bufferNo].stats ); )
 
-    for ( const auto& wire : _inputWires )
+    auto& inputBus = _buffers[bufferNo].inputBus;
+
+    for ( const auto& gather : _GetGathers( bufferNo ) )
     {
         // get new inputs from incoming components
-        wire.fromComponent->_GetOutput( bufferNo, wire.fromOutput, wire.toInput, inputBus );
+        [[maybe_unused]] const auto transfer = _Gather( gather );
+        DSPATCH_STATS( _buffers[bufferNo].stats.transfers.Record( gather.toInput, transfer, *gather.toSignal ); )
     }
 
+    DSPATCH_STATS( statsTimer.EndGather(); )
+
     if ( _bufferCount != 1 && _processOrder == ProcessOrder::InOrder )
     {
         // wait for our turn to process
         _WaitForRelease( bufferNo );
 
+        DSPATCH_STATS( statsTimer.EndWait(); )
+
         // call Process_() with newly aquired inputs
-        Process_( inputBus, _outputBuses[bufferNo] );
+        _Process( inputBus, _buffers[bufferNo].outputBus, bufferNo );
+
+        DSPATCH_STATS( statsTimer.EndProcess(); )
 
         // signal that we're done processing
         _ReleaseNextBuffer( bufferNo );
@@ -424,25 +765,42 @@ inline void Component::Tick( int bufferNo )
     else
     {
         // call Process_() with newly aquired inputs
-        Process_( inputBus, _outputBuses[bufferNo] );
+        _Process( inputBus, _buffers[bufferNo].outputBus, bufferNo );
+
+        DSPATCH_STATS( statsTimer.EndProcess(); )
     }
+
+    // move this buffer on to the next tick it will process
+    _buffers[bufferNo].sequence += _bufferCount;
+
+    DSPATCH_PROBE2( component_tick_end, this, bufferNo );
 }
 
 inline void Component::TickParallel()
 {
-    auto& inputBus = _inputBuses.front();
+    DSPATCH_PROBE2( component_tick_parallel_begin, this, 0 );
+    DSPATCH_TRACE( internal::TraceScope traceScope( "TickParallel", 0, &typeid( *this ) ); )
+    internal::FlightScope flightScope( this, 0 );
+    DSPATCH_STATS( internal::StatsTimer statsTimer( _buffers.front().stats ); )
 
-    for ( const auto& wire : _inputWires )
+    auto& inputBus = _buffers.front().inputBus;
+
+    for ( const auto& gather : _GetGathers( 0 ) )
     {
         // get new inputs from incoming components
-        wire.fromComponent->_GetOutputParallel( wire.fromOutput, wire.toInput, inputBus );
+        [[maybe_unused]] const auto transfer = _GatherParallel( gather );
+        DSPATCH_STATS( _buffers.front().stats.transfers.Record( gather.toInput, transfer, *gather.toSignal ); )
     }
 
+    DSPATCH_STATS( statsTimer.EndGather(); )
+
     // call Process_() with newly aquired inputs
-    Process_( inputBus, _outputBuses.front() );
+    _Process( inputBus, _buffers.front().outputBus, 0 );
+
+    DSPATCH_STATS( statsTimer.EndProcess(); )
 
     // signal that our outputs are ready
-    for ( auto& ref : _refs.front() )
+    for ( auto& ref : _buffers.front().refs )
     {
         // readyFlags are cleared in _GetOutputParallel() which ofc is only called on outputs with refs
         if ( ref.total != 0 )
@@ -450,25 +808,41 @@ inline void Component::TickParallel()
             ref.readyFlag.Set();
         }
     }
+
+    _buffers.front().sequence += _bufferCount;
+
+    DSPATCH_PROBE2( component_tick_parallel_end, this, 0 );
 }
 
 inline void Component::TickParallel( int bufferNo )
 {
-    auto& inputBus = _inputBuses[bufferNo];
+    DSPATCH_PROBE2( component_tick_parallel_begin, this, bufferNo );
+    DSPATCH_TRACE( internal::TraceScope traceScope( "TickParallel", bufferNo, &typeid( *this ) ); )
+    internal::FlightScope flightScope( this, bufferNo );
+    DSPATCH_STATS( internal::StatsTimer statsTimer( _buffers[bufferNo].stats ); )
 
-    for ( const auto& wire : _inputWires )
+    auto& inputBus = _buffers[bufferNo].inputBus;
+
+    for ( const auto& gather : _GetGathers( bufferNo ) )
     {
         // get new inputs from incoming components
-        wire.fromComponent->_GetOutputParallel( bufferNo, wire.fromOutput, wire.toInput, inputBus );
+        [[maybe_unused]] const auto transfer = _GatherParallel( gather );
+        DSPATCH_STATS( _buffers[bufferNo].stats.transfers.Record( gather.toInput, transfer, *gather.toSignal ); )
     }
 
+    DSPATCH_STATS( statsTimer.EndGather(); )
+
     if ( _bufferCount != 1 && _processOrder == ProcessOrder::InOrder )
     {
         // wait for our turn to process
         _WaitForRelease( bufferNo );
 
+        DSPATCH_STATS( statsTimer.EndWait(); )
+
         // call Process_() with newly aquired inputs
-        Process_( inputBus, _outputBuses[bufferNo] );
+        _Process( inputBus, _buffers[bufferNo].outputBus, bufferNo );
+
+        DSPATCH_STATS( statsTimer.EndProcess(); )
 
         // signal that we're done processing
         _ReleaseNextBuffer( bufferNo );
@@ -476,11 +850,13 @@ inline void Component::TickParallel( int bufferNo )
     else
     {
         // call Process_() with newly aquired inputs
-        Process_( inputBus, _outputBuses[bufferNo] );
+        _Process( inputBus, _buffers[bufferNo].outputBus, bufferNo );
+
+        DSPATCH_STATS( statsTimer.EndProcess(); )
     }
 
     // signal that our outputs are ready
-    for ( auto& ref : _refs[bufferNo] )
+    for ( auto& ref : _buffers[bufferNo].refs )
     {
         // readyFlags are cleared in _GetOutputParallel() which ofc is only called on outputs with refs
         if ( ref.total != 0 )
@@ -488,6 +864,18 @@ inline void Component::TickParallel( int bufferNo )
             ref.readyFlag.Set();
         }
     }
+
+    // move this buffer on to the next tick it will process
+    _buffers[bufferNo].sequence += _bufferCount;
+
+    DSPATCH_PROBE2( component_tick_parallel_end, this, bufferNo );
+}
+
+inline bool Component::IsBufferReleased( int bufferNo ) const
+{
+    // whether Tick( bufferNo ) would process straight away, rather than wait for its turn
+    return _bufferCount == 1 || _processOrder == ProcessOrder::OutOfOrder ||
+           _releaseSequence.load( std::memory_order_acquire ) == _buffers[bufferNo].sequence;
 }
 
 inline void Component::Scan( std::vector<Component*>& components )
@@ -547,124 +935,259 @@ inline void Component::EndScan()
     _scanPosition = -1;
 }
 
+inline ComponentStats Component::GetStats() const
+{
+    ComponentStats stats;
+    stats.component = this;
+
+#ifdef DSPATCH_ENABLE_STATS
+    // merge the stats of all buffers
+    for ( const auto& buffer : _buffers )
+    {
+        buffer.stats.gatherTime.MergeInto( stats.gatherTime );
+        buffer.stats.waitTime.MergeInto( stats.waitTime );
+        buffer.stats.processTime.MergeInto( stats.processTime );
+
+        stats.releaseWaitTimes.emplace_back();
+        buffer.stats.releaseWaitTime.MergeInto( stats.releaseWaitTimes.back() );
+    }
+
+    stats.inputs.resize( GetInputCount() );
+    for ( int i = 0; i < GetInputCount(); ++i )
+    {
+        stats.inputs[i].toInput = i;
+        GetInputWire( i, stats.inputs[i].fromComponent, stats.inputs[i].fromOutput );
+    }
+
+    for ( const auto& buffer : _buffers )
+    {
+        buffer.stats.transfers.MergeInto( stats.inputs );
+    }
+#endif
+
+    return stats;
+}
+
+inline void Component::ResetStats()
+{
+#ifdef DSPATCH_ENABLE_STATS
+    for ( auto& buffer : _buffers )
+    {
+        buffer.stats.gatherTime.Reset();
+        buffer.stats.waitTime.Reset();
+        buffer.stats.processTime.Reset();
+        buffer.stats.releaseWaitTime.Reset();
+        buffer.stats.transfers.Reset();
+    }
+#endif
+}
+
+inline uint64_t Component::GetTickSequence_() const
+{
+    return internal::ThreadTickSequence();
+}
+
 inline void Component::SetInputCount_( int inputCount, const std::vector<std::string>& inputNames )
 {
     _inputNames = inputNames;
 
-    for ( auto& inputBus : _inputBuses )
+    for ( auto& buffer : _buffers )
     {
-        inputBus.SetSignalCount( inputCount );
+        buffer.inputBus.SetSignalCount( inputCount );
     }
 
     _inputWires.reserve( inputCount );
+
+#ifdef DSPATCH_ENABLE_STATS
+    for ( auto& buffer : _buffers )
+    {
+        buffer.stats.transfers.SetInputCount( inputCount );
+    }
+#endif
+
+    // lay our buffers' state out afresh, in a slab of our own
+    RelocateState( nullptr );
 }
 
 inline void Component::SetOutputCount_( int outputCount, const std::vector<std::string>& outputNames )
 {
     _outputNames = outputNames;
 
-    for ( auto& outputBus : _outputBuses )
+    for ( auto& buffer : _buffers )
     {
-        outputBus.SetSignalCount( outputCount );
-    }
+        buffer.outputBus.SetSignalCount( outputCount );
 
-    // add reference counters for our new outputs
-    for ( auto& ref : _refs )
-    {
-        ref.resize( outputCount );
+        // add reference counters for our new outputs
+        buffer.refs.resize( outputCount );
     }
+
+    // lay our buffers' state out afresh, in a slab of our own
+    RelocateState( nullptr );
 }
 
-inline void Component::_WaitForRelease( int bufferNo )
+inline void Component::_Process( DSPatch::SignalBus& inputBus, DSPatch::SignalBus& outputBus, [[maybe_unused]] int bufferNo )
 {
-    _releaseFlags[bufferNo].WaitAndClear();
+    DSPATCH_PROBE2( process_begin, this, bufferNo );
+    DSPATCH_TRACE( internal::TraceScope traceScope( "Process_", bufferNo ); )
+
+    // restored after, in case Process_() ticks components of its own
+    auto& threadTickSequence = internal::ThreadTickSequence();
+    const auto callerTickSequence = threadTickSequence;
+    threadTickSequence = _buffers[bufferNo].sequence;
+
+    Process_( inputBus, outputBus );
+
+    threadTickSequence = callerTickSequence;
+
+    DSPATCH_PROBE2( process_end, this, bufferNo );
 }
 
-inline void Component::_ReleaseNextBuffer( int bufferNo )
+inline void Component::_WaitForRelease( int bufferNo )
 {
-    if ( ++bufferNo == _bufferCount )  // release the next available buffer
-    {
-        _releaseFlags[0].Set();
-    }
-    else
+    DSPATCH_PROBE2( wait_for_release_begin, this, bufferNo );
+
+    // You might be thinking: Why a sequence number rather than a flag per buffer?
+
+    // Each buffer processes every bufferCount'th tick, so the tick sequence number alone says whose turn
+    // it is. Releasing the next buffer is then a single store to one counter (rather than finding and
+    // setting the next buffer's flag), and waiting is a load of that same counter.
+
+    const auto sequence = _buffers[bufferNo].sequence;
+
+    if ( _releaseSequence.load( std::memory_order_acquire ) != sequence )
     {
-        _releaseFlags[bufferNo].Set();
+        DSPATCH_PROBE1( wait_begin, &_releaseSequence );
+        DSPATCH_TRACE( internal::TraceScope traceScope( "Wait" ); )
+
+        int spinCount = 0;
+
+        while ( _releaseSequence.load( std::memory_order_acquire ) != sequence )
+        {
+            if ( _waitStrategy == WaitStrategy::Yield || ( _waitStrategy == WaitStrategy::Backoff && spinCount == 64 ) )
+            {
+                std::this_thread::yield();
+            }
+            else
+            {
+                internal::CpuRelax();
+                ++spinCount;
+            }
+        }
+
+        DSPATCH_PROBE1( wait_end, &_releaseSequence );
     }
+
+    DSPATCH_PROBE2( wait_for_release_end, this, bufferNo );
+}
+
+inline void Component::_ReleaseNextBuffer( int bufferNo )
+{
+    // hand the turn to whichever buffer processes the following tick
+    _releaseSequence.store( _buffers[bufferNo].sequence + 1, std::memory_order_release );
 }
 
-inline void Component::_GetOutput( int fromOutput, int toInput, DSPatch::SignalBus& toBus )
+inline const Component::StateVector<Component::Gather>& Component::_GetGathers( int bufferNo )
 {
-    auto& signal = *_outputBuses.front().GetSignal( fromOutput );
+    auto& plan = _buffers[bufferNo].gatherPlan;
 
-    if ( !signal.has_value() )
+    if ( plan.dirty )
     {
-        toBus.ClearValue( toInput );
-        return;
-    }
+        // You might be thinking: Why not gather straight from _inputWires?
 
-    auto& ref = _refs.front()[fromOutput];
+        // Each wire would take several dependent loads (the source component, its buses, its refs) before
+        // reaching the signal it carries. Resolving these once, whenever the wiring (or any buffer it runs
+        // through) changes, leaves just the source signal and reference counter to touch per tick. Our
+        // circuit builds the plans up front whenever it re-plans (see PlanGathers()). Any left dirty (E.g.
+        // by wiring a component outside of a circuit) are built by the thread ticking their buffer, so no
+        // two threads ever touch the same plan.
 
-    if ( ref.total == 1 )
-    {
-        // there's only one reference, move the signal
-        toBus.MoveSignal( toInput, signal );
+        plan.gathers.clear();
+        plan.clockedGathers.clear();
+
+        for ( const auto& wire : _inputWires )
+        {
+            auto& ref = wire.fromComponent->_buffers[bufferNo].refs[wire.fromOutput];
+
+            // outputs with a wire crossing clock rates are copied from rather than moved (see _GatherClocked())
+            auto& gathers = wire.fromComponent->_IsOutputClocked( wire.fromOutput ) ? plan.clockedGathers : plan.gathers;
+
+            gathers.emplace_back( Gather{ wire.fromComponent->_buffers[bufferNo].outputBus.GetSignal( wire.fromOutput ),
+                                          &ref,
+                                          _buffers[bufferNo].inputBus.GetSignal( wire.toInput ),
+                                          wire.toInput,
+                                          ref.total == 1,
+                                          wire.fromComponent->_idleOutput == IdleOutput::Hold,
+                                          wire.fromComponent->_clockStride } );
+        }
+
+        plan.dirty = false;
     }
-    else if ( ++ref.count != ref.total )
+
+    return plan.gathers;
+}
+
+inline void Component::_SetGathersDirty()
+{
+    for ( auto& buffer : _buffers )
     {
-        // this is not the final reference, copy the signal
-        toBus.SetSignal( toInput, signal );
+        buffer.gatherPlan.dirty = true;
     }
-    else
+}
+
+inline void Component::_SetConsumerGathersDirty()
+{
+    for ( auto consumer : _consumers )
     {
-        // this is the final reference, reset the counter, move the signal
-        ref.count = 0;
-        toBus.MoveSignal( toInput, signal );
+        consumer->_SetGathersDirty();
     }
 }
 
-inline void Component::_GetOutput( int bufferNo, int fromOutput, int toInput, DSPatch::SignalBus& toBus )
+inline internal::SignalTransfer Component::_Gather( const Gather& gather )
 {
-    auto& signal = *_outputBuses[bufferNo].GetSignal( fromOutput );
+    auto& signal = *gather.signal;
 
     if ( !signal.has_value() )
     {
-        toBus.ClearValue( toInput );
-        return;
+        gather.toSignal->reset();
+        return internal::SignalTransfer::Null;
     }
 
-    auto& ref = _refs[bufferNo][fromOutput];
+    auto& ref = *gather.ref;
 
-    if ( ref.total == 1 )
+    if ( gather.sole )
     {
         // there's only one reference, move the signal
-        toBus.MoveSignal( toInput, signal );
+        gather.toSignal->swap( signal );
+        return internal::SignalTransfer::Move;
     }
     else if ( ++ref.count != ref.total )
     {
         // this is not the final reference, copy the signal
-        toBus.SetSignal( toInput, signal );
+        gather.toSignal->emplace( signal );
+        return internal::SignalTransfer::Copy;
     }
     else
     {
         // this is the final reference, reset the counter, move the signal
         ref.count = 0;
-        toBus.MoveSignal( toInput, signal );
+        gather.toSignal->swap( signal );
+        return internal::SignalTransfer::Move;
     }
 }
 
-inline void Component::_GetOutputParallel( int fromOutput, int toInput, DSPatch::SignalBus& toBus )
+inline internal::SignalTransfer Component::_GatherParallel( const Gather& gather )
 {
-    auto& signal = *_outputBuses.front().GetSignal( fromOutput );
-    auto& ref = _refs.front()[fromOutput];
+    auto& signal = *gather.signal;
+    auto& ref = *gather.ref;
 
     // wait for this output to be ready
     ref.readyFlag.WaitAndClear();
 
     if ( !signal.has_value() )
     {
-        toBus.ClearValue( toInput );
+        gather.toSignal->reset();
 
-        if ( ref.total != 1 )
+        if ( !gather.sole )
         {
             if ( ++ref.count != ref.total )
             {
@@ -677,84 +1200,138 @@ inline void Component::_GetOutputParallel( int fromOutput, int toInput, DSPatch:
                 ref.count = 0;
             }
         }
+
+        return internal::SignalTransfer::Null;
     }
-    else if ( ref.total == 1 )
+    else if ( gather.sole )
     {
         // there's only one reference, move the signal
-        toBus.MoveSignal( toInput, signal );
+        gather.toSignal->swap( signal );
+        return internal::SignalTransfer::Move;
     }
     else if ( ++ref.count != ref.total )
     {
         // this is not the final reference, copy the signal, wake next WaitAndClear()
-        toBus.SetSignal( toInput, signal );
+        gather.toSignal->emplace( signal );
         ref.readyFlag.Set();
+        return internal::SignalTransfer::Copy;
     }
     else
     {
         // this is the final reference, reset the counter, move the signal
         ref.count = 0;
-        toBus.MoveSignal( toInput, signal );
+        gather.toSignal->swap( signal );
+        return internal::SignalTransfer::Move;
     }
 }
 
-inline void Component::_GetOutputParallel( int bufferNo, int fromOutput, int toInput, DSPatch::SignalBus& toBus )
+inline internal::SignalTransfer Component::_GatherClocked( const Gather& gather, uint64_t sequence )
 {
-    auto& signal = *_outputBuses[bufferNo].GetSignal( fromOutput );
-    auto& ref = _refs[bufferNo][fromOutput];
+    // You might be thinking: Why copy held signals every tick, rather than just leave them in our inputs?
 
-    // wait for this output to be ready
-    ref.readyFlag.WaitAndClear();
+    // Process_() is free to move signals out of its inputs, so they may not still be there by our next
+    // tick. Leaving the source's signal in place instead, and copying it whenever we process, means we
+    // see its latest value however many ticks apart we and the source process.
+
+    if ( !gather.held && sequence % gather.clockStride != 0 )
+    {
+        // the source is idle this tick, and its outputs are absent while idle
+        gather.toSignal->reset();
+        return internal::SignalTransfer::Null;
+    }
+
+    const auto& signal = *gather.signal;
 
     if ( !signal.has_value() )
     {
-        toBus.ClearValue( toInput );
+        gather.toSignal->reset();
+        return internal::SignalTransfer::Null;
+    }
 
-        if ( ref.total != 1 )
+    gather.toSignal->emplace( signal );
+    return internal::SignalTransfer::Copy;
+}
+
+inline bool Component::_IsOutputClocked( int output ) const
+{
+    // whether any of this output's wires leads to a component processing at a different rate to ours
+    for ( auto consumer : _consumers )
+    {
+        if ( consumer->_clockStride == _clockStride )
         {
-            if ( ++ref.count != ref.total )
-            {
-                // this is not the final reference, wake next WaitAndClear()
-                ref.readyFlag.Set();
-            }
-            else
+            continue;
+        }
+
+        for ( const auto& wire : consumer->_inputWires )
+        {
+            if ( wire.fromComponent == this && wire.fromOutput == output )
             {
-                // this is the final reference, reset the counter
-                ref.count = 0;
+                return true;
             }
         }
     }
-    else if ( ref.total == 1 )
+
+    return false;
+}
+
+inline void Component::_DisconnectInput( const DSPatch::Component* fromComponent )
+{
+    // remove fromComponent from _inputWires
+    auto findFn = [&fromComponent]( const auto& wire ) { return wire.fromComponent == fromComponent; };
+
+    for ( auto it = std::find_if( _inputWires.begin(), _inputWires.end(), findFn ); it != _inputWires.end();
+          it = std::find_if( it, _inputWires.end(), findFn ) )
     {
-        // there's only one reference, move the signal
-        toBus.MoveSignal( toInput, signal );
+        // update source output's reference count
+        it->fromComponent->_DecRefs( it->fromOutput, this );
+
+        // clear input
+        for ( auto& buffer : _buffers )
+        {
+            buffer.inputBus.ClearValue( it->toInput );
+        }
+
+        // remove wire
+        it = _inputWires.erase( it );
     }
-    else if ( ++ref.count != ref.total )
+
+    _SetGathersDirty();
+}
+
+inline void Component::_IncRefs( int output, DSPatch::Component* toComponent )
+{
+    for ( auto& buffer : _buffers )
     {
-        // this is not the final reference, copy the signal, wake next WaitAndClear()
-        toBus.SetSignal( toInput, signal );
-        ref.readyFlag.Set();
+        ++buffer.refs[output].total;
     }
-    else
+
+    _consumers.emplace_back( toComponent );
+
+    if ( _buffers.front().refs[output].total == 2 )
     {
-        // this is the final reference, reset the counter, move the signal
-        ref.count = 0;
-        toBus.MoveSignal( toInput, signal );
+        // the output's existing wire is no longer its only one
+        _SetConsumerGathersDirty();
     }
 }
 
-inline void Component::_IncRefs( int output )
+inline void Component::_DecRefs( int output, const DSPatch::Component* toComponent )
 {
-    for ( auto& ref : _refs )
+    for ( auto& buffer : _buffers )
     {
-        ++ref[output].total;
+        --buffer.refs[output].total;
     }
-}
 
-inline void Component::_DecRefs( int output )
-{
-    for ( auto& ref : _refs )
+    // wires are usually removed in reverse order of creation, so search from the back
+    if ( auto it = std::find( _consumers.rbegin(), _consumers.rend(), toComponent ); it != _consumers.rend() )
+    {
+        *it = _consumers.back();
+        _consumers.pop_back();
+    }
+
+    if ( _buffers.front().refs[output].total == 1 )
     {
-        --ref[output].total;
+        // the output's remaining wire is now its only one
+        _SetConsumerGathersDirty();
     }
 }
 
@@ -0,0 +1,271 @@
+/******************************************************************************
+DSPatch - The Refreshingly Simple C++ Dataflow Framework
+Copyright (c) 2025, Marcus Tomlinson
+
+BSD 2-Clause License
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#ifndef DSPATCH_ARENA_CHUNK_SIZE
+#define DSPATCH_ARENA_CHUNK_SIZE 65536  // bytes per arena allocation
+#endif
+
+namespace DSPatch
+{
+
+/// Contiguous storage for components constructed by a circuit
+
+/**
+A ComponentArena hands out memory from large chunks, one after the other, so that components constructed in sequence (see
+Circuit::Emplace()) sit side by side in memory rather than wherever the heap happens to place them. As circuits are usually
+built in dataflow order, this keeps neighbouring components in a circuit's tick order close together.
+
+Memory released back to the arena (when the last reference to an emplaced component is released) is kept for reuse by the next
+allocation of the same size and alignment. Chunks themselves are only freed once the arena is destroyed: when its circuit, and
+every component emplaced into it, have been released. This is thread-safe, as the last reference to a component may be released
+from any thread.
+
+Components also keep their runtime state in arenas: each in a small one of its own, with chunks sized to fit that state, or in
+their circuit's while compacted (see Component::RelocateState()). AlignNext() starts the next allocation on a given alignment
+(E.g. so that each buffer's state starts on a cache line of its own).
+*/
+
+class ComponentArena final
+{
+public:
+    ComponentArena( const ComponentArena& ) = delete;
+    ComponentArena& operator=( const ComponentArena& ) = delete;
+
+    using SPtr = std::shared_ptr<ComponentArena>;
+
+    explicit ComponentArena( size_t chunkSize = DSPATCH_ARENA_CHUNK_SIZE );
+    ~ComponentArena();
+
+    void* Allocate( size_t size, size_t alignment );
+    void Deallocate( void* block, size_t size, size_t alignment );
+
+    void AlignNext( size_t alignment );
+
+    size_t GetSize() const;
+
+private:
+    mutable std::mutex _mutex;
+
+    const size_t _minChunkSize;
+
+    std::vector<std::unique_ptr<std::byte[]>> _chunks;
+    size_t _chunkSize = 0;      // size of the last chunk
+    size_t _offset = 0;         // offset of the next allocation in the last chunk
+    size_t _size = 0;           // total size of all chunks
+    size_t _nextAlignment = 1;  // minimum alignment of the next allocation (see AlignNext())
+
+    std::map<std::pair<size_t, size_t>, std::vector<void*>> _freeBlocks;  // by size and alignment
+};
+
+namespace internal
+{
+
+// allocator from an arena, held either by shared_ptr (ArenaAllocator) or by raw pointer (StateAllocator). Without an arena, it
+// allocates from the heap (aligning over-aligned types itself, as the arena does).
+template <typename T, typename ArenaPtr>
+class BasicArenaAllocator  // (not final, as containers derive from their allocator)
+{
+public:
+    using value_type = T;
+
+    // containers take their allocator along when assigned or swapped (so assigning a container built in an arena moves it there)
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    BasicArenaAllocator() = default;
+
+    explicit BasicArenaAllocator( const ArenaPtr& arena )
+        : arena( arena )
+    {
+    }
+
+    template <typename U>
+    BasicArenaAllocator( const BasicArenaAllocator<U, ArenaPtr>& other )
+        : arena( other.arena )
+    {
+    }
+
+    T* allocate( size_t count )
+    {
+        if ( arena )
+        {
+            return static_cast<T*>( arena->Allocate( count * sizeof( T ), alignof( T ) ) );
+        }
+
+        if constexpr ( alignof( T ) <= alignof( std::max_align_t ) )
+        {
+            return static_cast<T*>( ::operator new( count * sizeof( T ) ) );
+        }
+        else
+        {
+            // You might be thinking: Why not use aligned operator new here?
+
+            // For the same reason Block doesn't (see Block::_Allocate()): aligned allocation functions are
+            // not available on all of the platforms we support. So we over-allocate, align the block within
+            // that allocation ourselves, and keep the allocation's address just before the block to free it.
+
+            const auto size = count * sizeof( T ) + alignof( T ) - 1 + sizeof( void* );
+            const auto memory = static_cast<std::byte*>( ::operator new( size ) );
+
+            const auto address = reinterpret_cast<std::uintptr_t>( memory + sizeof( void* ) );
+            const auto block = reinterpret_cast<void**>( ( address + alignof( T ) - 1 ) & ~(std::uintptr_t)( alignof( T ) - 1 ) );
+
+            block[-1] = memory;
+            return reinterpret_cast<T*>( block );
+        }
+    }
+
+    void deallocate( T* block, size_t count )
+    {
+        if ( arena )
+        {
+            arena->Deallocate( block, count * sizeof( T ), alignof( T ) );
+        }
+        else if constexpr ( alignof( T ) <= alignof( std::max_align_t ) )
+        {
+            ::operator delete( block );
+        }
+        else
+        {
+            ::operator delete( reinterpret_cast<void**>( block )[-1] );
+        }
+    }
+
+    template <typename U>
+    bool operator==( const BasicArenaAllocator<U, ArenaPtr>& other ) const
+    {
+        return arena == other.arena;
+    }
+
+    template <typename U>
+    bool operator!=( const BasicArenaAllocator<U, ArenaPtr>& other ) const
+    {
+        return arena != other.arena;
+    }
+
+    ArenaPtr arena = nullptr;
+};
+
+// allocator for std::allocate_shared(), allocating both a component and its shared_ptr control block from an arena (the control
+// block's copy of the allocator keeps the arena alive)
+template <typename T>
+using ArenaAllocator = BasicArenaAllocator<T, ComponentArena::SPtr>;
+
+// allocator for component state relocated into an arena (see Component::RelocateState()). A raw pointer keeps each container
+// small, so the component must keep the arena alive for as long as its state is allocated from it.
+template <typename T>
+using StateAllocator = BasicArenaAllocator<T, ComponentArena*>;
+
+}  // namespace internal
+
+inline ComponentArena::ComponentArena( size_t chunkSize )
+    : _minChunkSize( chunkSize )
+{
+}
+
+inline ComponentArena::~ComponentArena() = default;
+
+inline void* ComponentArena::Allocate( size_t size, size_t alignment )
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    // reuse a released block of the same size and alignment (unless the block must start on a stricter alignment)
+    if ( auto it = _freeBlocks.find( { size, alignment } );
+         _nextAlignment <= alignment && it != _freeBlocks.end() && !it->second.empty() )
+    {
+        auto block = it->second.back();
+        it->second.pop_back();
+        return block;
+    }
+
+    alignment = std::max( alignment, _nextAlignment );
+    _nextAlignment = 1;
+
+    // otherwise place the block right after the last, starting a new chunk if it doesn't fit
+    auto alignedOffset = [alignment]( const std::byte* chunk, size_t offset ) {
+        const auto address = reinterpret_cast<uintptr_t>( chunk ) + offset;
+        return offset + ( alignment - address % alignment ) % alignment;
+    };
+
+    size_t offset = 0;
+
+    if ( !_chunks.empty() )
+    {
+        offset = alignedOffset( _chunks.back().get(), _offset );
+    }
+
+    if ( _chunks.empty() || offset + size > _chunkSize )
+    {
+        _chunkSize = std::max( _minChunkSize, size + alignment );
+        _chunks.emplace_back( std::make_unique<std::byte[]>( _chunkSize ) );
+        _size += _chunkSize;
+
+        offset = alignedOffset( _chunks.back().get(), 0 );
+    }
+
+    _offset = offset + size;
+
+    return _chunks.back().get() + offset;
+}
+
+inline void ComponentArena::Deallocate( void* block, size_t size, size_t alignment )
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    _freeBlocks[{ size, alignment }].emplace_back( block );
+}
+
+inline void ComponentArena::AlignNext( size_t alignment )
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    _nextAlignment = std::max( _nextAlignment, alignment );
+}
+
+// cppcheck-suppress unusedFunction
+inline size_t ComponentArena::GetSize() const
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    return _size;
+}
+
+}  // namespace DSPatch
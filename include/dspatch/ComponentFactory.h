@@ -0,0 +1,115 @@
+/******************************************************************************
+DSPatch - The Refreshingly Simple C++ Dataflow Framework
+Copyright (c) 2025, Marcus Tomlinson
+
+BSD 2-Clause License
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include "Component.h"
+
+#include <functional>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+
+namespace DSPatch
+{
+
+/// Registry of component types, for loading saved circuits
+
+/**
+A circuit's topology is saved with each of its components identified by type id (see Circuit::SaveTopology()). In order to load
+it back (see Circuit::LoadTopology()), each of those types must be registered with a ComponentFactory, which constructs a new
+component for a given type id.
+
+Register<T>() registers a default-constructible component type under its own type id. Alternatively, any function creating a
+component can be registered under a type id, E.g. components that require constructor arguments, or components loaded from
+plugins:
+
+    auto plugin = std::make_shared<Plugin>( "/path/to/plugin.so" );
+    factory.Register( ComponentFactory::GetTypeId( *plugin->Create() ), [plugin] { return plugin->Create(); } );
+
+A component's type id is its demangled class name (E.g. "DSPatch::BlockAdd").
+*/
+
+class ComponentFactory final
+{
+public:
+    ComponentFactory( const ComponentFactory& ) = delete;
+    ComponentFactory& operator=( const ComponentFactory& ) = delete;
+
+    using Create_t = std::function<Component::SPtr()>;
+
+    ComponentFactory();
+
+    template <typename T>
+    void Register();
+    void Register( const std::string& typeId, const Create_t& create );
+
+    bool IsRegistered( const std::string& typeId ) const;
+
+    Component::SPtr Create( const std::string& typeId ) const;
+
+    static std::string GetTypeId( const Component& component );
+
+private:
+    std::unordered_map<std::string, Create_t> _creators;
+};
+
+inline ComponentFactory::ComponentFactory() = default;
+
+template <typename T>
+inline void ComponentFactory::Register()
+{
+    Register( internal::DemangleTypeName( typeid( T ) ), [] { return std::make_shared<T>(); } );
+}
+
+inline void ComponentFactory::Register( const std::string& typeId, const Create_t& create )
+{
+    _creators[typeId] = create;
+}
+
+// cppcheck-suppress unusedFunction
+inline bool ComponentFactory::IsRegistered( const std::string& typeId ) const
+{
+    return _creators.find( typeId ) != _creators.end();
+}
+
+inline Component::SPtr ComponentFactory::Create( const std::string& typeId ) const
+{
+    if ( auto it = _creators.find( typeId ); it != _creators.end() )
+    {
+        return it->second();
+    }
+    return nullptr;
+}
+
+inline std::string ComponentFactory::GetTypeId( const Component& component )
+{
+    return internal::DemangleTypeName( typeid( component ) );
+}
+
+}  // namespace DSPatch
@@ -0,0 +1,272 @@
+/******************************************************************************
+DSPatch - The Refreshingly Simple C++ Dataflow Framework
+Copyright (c) 2025, Marcus Tomlinson
+
+BSD 2-Clause License
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#if defined( __x86_64__ ) || defined( _M_X64 )
+#define DSPATCH_X86_64
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define DSPATCH_TARGET_AVX2 __attribute__( ( target( "avx2" ) ) )
+#define DSPATCH_TARGET_AVX512 __attribute__( ( target( "avx512f" ) ) )
+#else
+#define DSPATCH_TARGET_AVX2
+#define DSPATCH_TARGET_AVX512
+#endif
+
+namespace DSPatch
+{
+
+/// Instruction sets selectable at runtime
+
+/**
+As DSPatch is header-only, it is compiled with whatever flags the host project uses. Components (particularly those shipped as
+plugins via EXPORT_PLUGIN) therefore cannot assume that anything beyond the baseline instruction set is available. Instead, a
+component can compile several variants of its Process_() kernel, each for a different instruction set, and select the best one
+the host CPU supports at runtime via a Dispatcher.
+
+Variants are compiled for a specific instruction set by prefixing their definitions with DSPATCH_TARGET_AVX2 or
+DSPATCH_TARGET_AVX512. These variants must only ever be called via a Dispatcher (or after checking GetIsa()), as they may contain
+instructions the host CPU does not support. On non-x86-64 platforms only Isa::Scalar is available. To keep the intrinsics headers
+out of every translation unit that includes DSPatch, variants written with intrinsics should include <immintrin.h> themselves.
+
+GetHostIsa() returns the best instruction set supported by the host CPU. For testing purposes, ForceIsa() caps the instruction set
+returned by GetIsa() (and hence selected by subsequently constructed Dispatchers, and by each subsequent Kernels call) until
+ResetIsa() is called.
+*/
+
+enum class Isa
+{
+    Scalar,
+    SSE2,
+    AVX2,
+    AVX512
+};
+
+Isa GetHostIsa();
+
+Isa GetIsa();
+void ForceIsa( Isa isa );
+void ResetIsa();
+
+/// Runtime selection between instruction set specific function variants
+
+/**
+A Dispatcher holds up to one variant of a function (or member function) per instruction set. Each time a variant is registered via
+Register(), the Dispatcher selects the best registered variant supported by GetIsa(), so a component that registers its variants
+from its constructor has its best variant selected once, on construction. The selected variant is returned by Get(), and can be
+re-selected for a specific instruction set via Select() (E.g. to test each variant in turn).
+
+<b>NOTE:</b> An Isa::Scalar variant should always be registered, as this is the only variant guaranteed to be selectable.
+
+\code
+class Gain final : public DSPatch::Component
+{
+public:
+    Gain()
+    {
+        SetInputCount_( 1 );
+        SetOutputCount_( 1 );
+
+        _process.Register( DSPatch::Isa::Scalar, &Gain::ProcessScalar );
+        _process.Register( DSPatch::Isa::AVX2, &Gain::ProcessAvx2 );
+    }
+
+protected:
+    void Process_( DSPatch::SignalBus& inputs, DSPatch::SignalBus& outputs ) override
+    {
+        ( this->*_process.Get() )( inputs, outputs );
+    }
+
+private:
+    void ProcessScalar( DSPatch::SignalBus& inputs, DSPatch::SignalBus& outputs );
+    DSPATCH_TARGET_AVX2 void ProcessAvx2( DSPatch::SignalBus& inputs, DSPatch::SignalBus& outputs );
+
+    DSPatch::Dispatcher<void ( Gain::* )( DSPatch::SignalBus&, DSPatch::SignalBus& )> _process;
+};
+\endcode
+*/
+
+template <typename Fn>
+class Dispatcher final
+{
+public:
+    Dispatcher();
+
+    Dispatcher& Register( Isa isa, Fn variant );
+
+    bool Select( Isa isa );
+
+    Fn Get() const;
+    Isa GetSelectedIsa() const;
+
+private:
+    std::array<Fn, 4> _variants{};
+
+    Fn _selected = nullptr;
+    Isa _selectedIsa = Isa::Scalar;
+};
+
+namespace internal
+{
+
+inline Isa DetectIsa()
+{
+#if !defined( DSPATCH_X86_64 )
+    return Isa::Scalar;
+#elif defined( _MSC_VER )
+    int regs[4];
+
+    __cpuid( regs, 1 );
+    const bool osxsave = ( regs[2] & ( 1 << 27 ) ) != 0;
+    const bool avx = ( regs[2] & ( 1 << 28 ) ) != 0;
+
+    if ( !osxsave || !avx )
+    {
+        return Isa::SSE2;
+    }
+
+    // check that the OS saves the AVX (and AVX-512) register state
+    const auto xcr0 = _xgetbv( 0 );
+
+    __cpuidex( regs, 7, 0 );
+    const bool avx2 = ( regs[1] & ( 1 << 5 ) ) != 0;
+    const bool avx512f = ( regs[1] & ( 1 << 16 ) ) != 0;
+
+    if ( avx512f && ( xcr0 & 0xE6 ) == 0xE6 )
+    {
+        return Isa::AVX512;
+    }
+    if ( avx2 && ( xcr0 & 0x6 ) == 0x6 )
+    {
+        return Isa::AVX2;
+    }
+    return Isa::SSE2;
+#else
+    __builtin_cpu_init();
+
+    if ( __builtin_cpu_supports( "avx512f" ) )
+    {
+        return Isa::AVX512;
+    }
+    if ( __builtin_cpu_supports( "avx2" ) )
+    {
+        return Isa::AVX2;
+    }
+    return Isa::SSE2;
+#endif
+}
+
+inline std::atomic<Isa>& ForcedIsa()
+{
+    static std::atomic<Isa> forcedIsa( Isa::AVX512 );
+    return forcedIsa;
+}
+
+}  // namespace internal
+
+inline Isa GetHostIsa()
+{
+    static const Isa hostIsa = internal::DetectIsa();
+    return hostIsa;
+}
+
+inline Isa GetIsa()
+{
+    const auto forcedIsa = internal::ForcedIsa().load( std::memory_order_relaxed );
+    const auto hostIsa = GetHostIsa();
+
+    // never exceed what the host actually supports
+    return forcedIsa < hostIsa ? forcedIsa : hostIsa;
+}
+
+inline void ForceIsa( Isa isa )
+{
+    internal::ForcedIsa().store( isa, std::memory_order_relaxed );
+}
+
+inline void ResetIsa()
+{
+    internal::ForcedIsa().store( Isa::AVX512, std::memory_order_relaxed );
+}
+
+template <typename Fn>
+inline Dispatcher<Fn>::Dispatcher() = default;
+
+template <typename Fn>
+inline Dispatcher<Fn>& Dispatcher<Fn>::Register( Isa isa, Fn variant )
+{
+    _variants[(size_t)isa] = variant;
+
+    Select( GetIsa() );
+
+    return *this;
+}
+
+template <typename Fn>
+inline bool Dispatcher<Fn>::Select( Isa isa )
+{
+    if ( isa > GetHostIsa() )
+    {
+        return false;
+    }
+
+    // select the best variant at or below isa
+    for ( int i = (int)isa; i >= 0; --i )
+    {
+        if ( _variants[i] )
+        {
+            _selected = _variants[i];
+            _selectedIsa = (Isa)i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <typename Fn>
+inline Fn Dispatcher<Fn>::Get() const
+{
+    return _selected;
+}
+
+template <typename Fn>
+inline Isa Dispatcher<Fn>::GetSelectedIsa() const
+{
+    return _selectedIsa;
+}
+
+}  // namespace DSPatch
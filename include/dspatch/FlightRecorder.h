@@ -0,0 +1,203 @@
+/******************************************************************************
+DSPatch - The Refreshingly Simple C++ Dataflow Framework
+Copyright (c) 2025, Marcus Tomlinson
+
+BSD 2-Clause License
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include "Stats.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#ifndef DSPATCH_FLIGHT_RECORDER_CAPACITY
+#define DSPATCH_FLIGHT_RECORDER_CAPACITY 1024  // component executions per thread
+#endif
+
+namespace DSPatch
+{
+
+class Component;
+
+/// A single component execution held by a circuit's flight recorder
+
+/**
+Times are steady clock timestamps in nanoseconds. componentIndex is the component's position in the circuit's process order at
+the time the record was read (-1 if the component has since been removed). threadNo is the index of the circuit thread within
+the buffer that processed it, or -1 if it was processed on the thread calling Circuit::Tick() (in a circuit with no buffers).
+*/
+
+struct FlightRecord final
+{
+    const Component* component = nullptr;
+    int componentIndex = -1;
+    int bufferNo = 0;
+    int threadNo = 0;
+    uint64_t startTime = 0;
+    uint64_t endTime = 0;
+};
+
+namespace internal
+{
+
+class FlightRing final
+{
+public:
+    FlightRing( const FlightRing& ) = delete;
+    FlightRing& operator=( const FlightRing& ) = delete;
+
+    explicit FlightRing( int threadNo );
+
+    // You might be thinking: Why not lock the ring while it's read?
+
+    // Each ring has a single writer (the thread ticking its components), and must never block it. Instead,
+    // each slot carries a sequence number that is odd while the slot is being written. A reader keeps only
+    // the slots whose sequence number was even and unchanged across its read (a seqlock), so a dump can be
+    // taken from any thread, at any time, without the writer ever noticing.
+
+    void Record( const Component* component, int bufferNo, uint64_t startTime, uint64_t endTime );
+
+    void Read( std::vector<FlightRecord>& records ) const;
+
+private:
+    struct Slot final
+    {
+        std::atomic<uint64_t> sequence;
+        std::atomic<const Component*> component;
+        std::atomic<int> bufferNo;
+        std::atomic<uint64_t> startTime;
+        std::atomic<uint64_t> endTime;
+    };
+
+    const int _threadNo;
+
+    std::unique_ptr<Slot[]> _slots;
+    std::atomic<uint64_t> _head = 0;
+};
+
+// the ring of the thread currently ticking components (nullptr when not recording)
+inline FlightRing*& GetThreadFlightRing()
+{
+    thread_local FlightRing* ring = nullptr;
+    return ring;
+}
+
+class FlightScope final
+{
+public:
+    FlightScope( const FlightScope& ) = delete;
+    FlightScope& operator=( const FlightScope& ) = delete;
+
+    FlightScope( const Component* component, int bufferNo );
+    ~FlightScope();
+
+private:
+    FlightRing* const _ring;
+    const Component* const _component;
+    const int _bufferNo;
+    const uint64_t _startTime;
+};
+
+inline FlightRing::FlightRing( int threadNo )
+    : _threadNo( threadNo )
+    , _slots( std::make_unique<Slot[]>( DSPATCH_FLIGHT_RECORDER_CAPACITY ) )
+{
+}
+
+inline void FlightRing::Record( const Component* component, int bufferNo, uint64_t startTime, uint64_t endTime )
+{
+    const auto head = _head.load( std::memory_order_relaxed );
+    auto& slot = _slots[head % DSPATCH_FLIGHT_RECORDER_CAPACITY];
+
+    // relaxed stores compile to plain moves, so this is as cheap as writing a non-atomic struct
+    slot.sequence.store( head * 2 + 1, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+
+    slot.component.store( component, std::memory_order_relaxed );
+    slot.bufferNo.store( bufferNo, std::memory_order_relaxed );
+    slot.startTime.store( startTime, std::memory_order_relaxed );
+    slot.endTime.store( endTime, std::memory_order_relaxed );
+
+    slot.sequence.store( head * 2 + 2, std::memory_order_release );
+    _head.store( head + 1, std::memory_order_release );
+}
+
+inline void FlightRing::Read( std::vector<FlightRecord>& records ) const
+{
+    const auto head = _head.load( std::memory_order_acquire );
+
+    // once the ring has wrapped, only the most recent executions remain
+    const uint64_t capacity = DSPATCH_FLIGHT_RECORDER_CAPACITY;
+    const auto begin = head > capacity ? head - capacity : 0;
+
+    for ( auto i = begin; i < head; ++i )
+    {
+        const auto& slot = _slots[i % capacity];
+
+        const auto sequence = slot.sequence.load( std::memory_order_acquire );
+        if ( sequence != i * 2 + 2 )
+        {
+            continue;  // being (or already) overwritten by a newer execution
+        }
+
+        FlightRecord record;
+        record.component = slot.component.load( std::memory_order_relaxed );
+        record.bufferNo = slot.bufferNo.load( std::memory_order_relaxed );
+        record.threadNo = _threadNo;
+        record.startTime = slot.startTime.load( std::memory_order_relaxed );
+        record.endTime = slot.endTime.load( std::memory_order_relaxed );
+
+        std::atomic_thread_fence( std::memory_order_acquire );
+        if ( slot.sequence.load( std::memory_order_relaxed ) != sequence )
+        {
+            continue;  // overwritten while we were reading it
+        }
+
+        records.emplace_back( record );
+    }
+}
+
+inline FlightScope::FlightScope( const Component* component, int bufferNo )
+    : _ring( GetThreadFlightRing() )
+    , _component( component )
+    , _bufferNo( bufferNo )
+    , _startTime( _ring ? StatsNow() : 0 )
+{
+}
+
+inline FlightScope::~FlightScope()
+{
+    if ( _ring )
+    {
+        _ring->Record( _component, _bufferNo, _startTime, StatsNow() );
+    }
+}
+
+}  // namespace internal
+
+}  // namespace DSPatch
@@ -0,0 +1,722 @@
+/******************************************************************************
+DSPatch - The Refreshingly Simple C++ Dataflow Framework
+Copyright (c) 2025, Marcus Tomlinson
+
+BSD 2-Clause License
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include "Dispatch.h"
+
+#ifdef DSPATCH_X86_64
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace DSPatch
+{
+
+/// Vectorized kernels for processing blocks of samples
+
+/**
+The Kernels namespace provides a set of arithmetic kernels for processing contiguous arrays of samples (E.g. the contents of a
+Block). Each kernel is implemented for SSE2, AVX2 and AVX-512, as well as in plain scalar code. The best implementation supported
+by the host CPU (see GetIsa()) is selected at runtime on each call, so a single binary runs at full speed across different
+machines without having to be compiled for a specific instruction set (and ForceIsa() takes effect on the very next call).
+
+Kernels accept unaligned pointers, though aligned data (as provided by Block) performs best. Input and output arrays may be the
+same array (in-place processing), but must not otherwise overlap.
+
+<b>NOTE:</b> Reductions (Sum(), MinValue(), MaxValue()) return their identity value (0, +infinity, and -infinity respectively)
+when count is 0. As vectorized sums accumulate in a different order to scalar sums, and multiply-adds may be fused on CPUs that
+support it, the results of Sum(), MultiplyAdd() and Mix() may differ in their last few bits between instruction sets. Min() and
+Max() follow the SSE minps / maxps convention on every instruction set: where either operand is NaN, the second (b) is returned.
+MinValue() and MaxValue() of arrays containing NaN are therefore order dependent, and may differ between instruction sets.
+*/
+
+namespace Kernels
+{
+
+void Add( const float* a, const float* b, float* out, int count );
+void Multiply( const float* a, const float* b, float* out, int count );
+void MultiplyAdd( const float* a, const float* b, const float* c, float* out, int count );
+void Mix( const float* a, float aGain, const float* b, float bGain, float* out, int count );
+void Min( const float* a, const float* b, float* out, int count );
+void Max( const float* a, const float* b, float* out, int count );
+void Abs( const float* in, float* out, int count );
+
+float Sum( const float* in, int count );
+float MinValue( const float* in, int count );
+float MaxValue( const float* in, int count );
+
+void Convert( const std::int16_t* in, float* out, int count );
+void Convert( const float* in, std::int16_t* out, int count );
+
+namespace internal
+{
+
+struct AddOp final
+{
+    static constexpr float identity = 0.0f;
+
+    static inline float Scalar( float a, float b )
+    {
+        return a + b;
+    }
+
+#ifdef DSPATCH_X86_64
+    static inline __m128 Sse2( __m128 a, __m128 b )
+    {
+        return _mm_add_ps( a, b );
+    }
+
+    DSPATCH_TARGET_AVX2 static inline __m256 Avx2( __m256 a, __m256 b )
+    {
+        return _mm256_add_ps( a, b );
+    }
+
+    DSPATCH_TARGET_AVX512 static inline __m512 Avx512( __m512 a, __m512 b )
+    {
+        return _mm512_add_ps( a, b );
+    }
+#endif
+};
+
+struct MultiplyOp final
+{
+    static inline float Scalar( float a, float b )
+    {
+        return a * b;
+    }
+
+#ifdef DSPATCH_X86_64
+    static inline __m128 Sse2( __m128 a, __m128 b )
+    {
+        return _mm_mul_ps( a, b );
+    }
+
+    DSPATCH_TARGET_AVX2 static inline __m256 Avx2( __m256 a, __m256 b )
+    {
+        return _mm256_mul_ps( a, b );
+    }
+
+    DSPATCH_TARGET_AVX512 static inline __m512 Avx512( __m512 a, __m512 b )
+    {
+        return _mm512_mul_ps( a, b );
+    }
+#endif
+};
+
+struct MinOp final
+{
+    static constexpr float identity = std::numeric_limits<float>::infinity();
+
+    static inline float Scalar( float a, float b )
+    {
+        return a < b ? a : b;  // as _mm_min_ps() (b if either is NaN)
+    }
+
+#ifdef DSPATCH_X86_64
+    static inline __m128 Sse2( __m128 a, __m128 b )
+    {
+        return _mm_min_ps( a, b );
+    }
+
+    DSPATCH_TARGET_AVX2 static inline __m256 Avx2( __m256 a, __m256 b )
+    {
+        return _mm256_min_ps( a, b );
+    }
+
+    DSPATCH_TARGET_AVX512 static inline __m512 Avx512( __m512 a, __m512 b )
+    {
+        return _mm512_min_ps( a, b );
+    }
+#endif
+};
+
+struct MaxOp final
+{
+    static constexpr float identity = -std::numeric_limits<float>::infinity();
+
+    static inline float Scalar( float a, float b )
+    {
+        return a > b ? a : b;  // as _mm_max_ps() (b if either is NaN)
+    }
+
+#ifdef DSPATCH_X86_64
+    static inline __m128 Sse2( __m128 a, __m128 b )
+    {
+        return _mm_max_ps( a, b );
+    }
+
+    DSPATCH_TARGET_AVX2 static inline __m256 Avx2( __m256 a, __m256 b )
+    {
+        return _mm256_max_ps( a, b );
+    }
+
+    DSPATCH_TARGET_AVX512 static inline __m512 Avx512( __m512 a, __m512 b )
+    {
+        return _mm512_max_ps( a, b );
+    }
+#endif
+};
+
+// Scalar
+// ======
+
+template <typename Op>
+inline void BinaryScalar( const float* a, const float* b, float* out, int count )
+{
+    for ( int i = 0; i < count; ++i )
+    {
+        out[i] = Op::Scalar( a[i], b[i] );
+    }
+}
+
+inline void MultiplyAddScalar( const float* a, const float* b, const float* c, float* out, int count )
+{
+    for ( int i = 0; i < count; ++i )
+    {
+        out[i] = a[i] * b[i] + c[i];
+    }
+}
+
+inline void MixScalar( const float* a, float aGain, const float* b, float bGain, float* out, int count )
+{
+    for ( int i = 0; i < count; ++i )
+    {
+        out[i] = a[i] * aGain + b[i] * bGain;
+    }
+}
+
+inline void AbsScalar( const float* in, float* out, int count )
+{
+    for ( int i = 0; i < count; ++i )
+    {
+        out[i] = std::fabs( in[i] );
+    }
+}
+
+template <typename Op>
+inline float ReduceScalar( const float* in, int count )
+{
+    float result = Op::identity;
+    for ( int i = 0; i < count; ++i )
+    {
+        result = Op::Scalar( result, in[i] );
+    }
+    return result;
+}
+
+inline void ConvertScalar( const std::int16_t* in, float* out, int count )
+{
+    for ( int i = 0; i < count; ++i )
+    {
+        out[i] = in[i] * ( 1.0f / 32768.0f );
+    }
+}
+
+inline void ConvertScalar( const float* in, std::int16_t* out, int count )
+{
+    for ( int i = 0; i < count; ++i )
+    {
+        out[i] = (std::int16_t)std::lrint( std::min( std::max( in[i] * 32768.0f, -32768.0f ), 32767.0f ) );
+    }
+}
+
+#ifdef DSPATCH_X86_64
+
+// SSE2
+// ====
+
+template <typename Op>
+inline void BinarySse2( const float* a, const float* b, float* out, int count )
+{
+    int i = 0;
+    for ( ; i + 4 <= count; i += 4 )
+    {
+        _mm_storeu_ps( out + i, Op::Sse2( _mm_loadu_ps( a + i ), _mm_loadu_ps( b + i ) ) );
+    }
+    BinaryScalar<Op>( a + i, b + i, out + i, count - i );
+}
+
+inline void MultiplyAddSse2( const float* a, const float* b, const float* c, float* out, int count )
+{
+    int i = 0;
+    for ( ; i + 4 <= count; i += 4 )
+    {
+        _mm_storeu_ps( out + i, _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( a + i ), _mm_loadu_ps( b + i ) ), _mm_loadu_ps( c + i ) ) );
+    }
+    MultiplyAddScalar( a + i, b + i, c + i, out + i, count - i );
+}
+
+inline void MixSse2( const float* a, float aGain, const float* b, float bGain, float* out, int count )
+{
+    const auto ga = _mm_set1_ps( aGain );
+    const auto gb = _mm_set1_ps( bGain );
+
+    int i = 0;
+    for ( ; i + 4 <= count; i += 4 )
+    {
+        _mm_storeu_ps( out + i, _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( a + i ), ga ), _mm_mul_ps( _mm_loadu_ps( b + i ), gb ) ) );
+    }
+    MixScalar( a + i, aGain, b + i, bGain, out + i, count - i );
+}
+
+inline void AbsSse2( const float* in, float* out, int count )
+{
+    const auto signMask = _mm_set1_ps( -0.0f );
+
+    int i = 0;
+    for ( ; i + 4 <= count; i += 4 )
+    {
+        _mm_storeu_ps( out + i, _mm_andnot_ps( signMask, _mm_loadu_ps( in + i ) ) );
+    }
+    AbsScalar( in + i, out + i, count - i );
+}
+
+template <typename Op>
+inline float ReduceSse2( const float* in, int count )
+{
+    auto acc = _mm_set1_ps( Op::identity );
+
+    int i = 0;
+    for ( ; i + 4 <= count; i += 4 )
+    {
+        acc = Op::Sse2( acc, _mm_loadu_ps( in + i ) );
+    }
+
+    float lanes[4];
+    _mm_storeu_ps( lanes, acc );
+
+    return Op::Scalar( ReduceScalar<Op>( lanes, 4 ), ReduceScalar<Op>( in + i, count - i ) );
+}
+
+inline void ConvertSse2( const std::int16_t* in, float* out, int count )
+{
+    const auto scale = _mm_set1_ps( 1.0f / 32768.0f );
+
+    int i = 0;
+    for ( ; i + 8 <= count; i += 8 )
+    {
+        const auto samples = _mm_loadu_si128( (const __m128i*)( in + i ) );
+
+        // sign extend 16-bit samples to 32-bit
+        const auto lo = _mm_srai_epi32( _mm_unpacklo_epi16( samples, samples ), 16 );
+        const auto hi = _mm_srai_epi32( _mm_unpackhi_epi16( samples, samples ), 16 );
+
+        _mm_storeu_ps( out + i, _mm_mul_ps( _mm_cvtepi32_ps( lo ), scale ) );
+        _mm_storeu_ps( out + i + 4, _mm_mul_ps( _mm_cvtepi32_ps( hi ), scale ) );
+    }
+    ConvertScalar( in + i, out + i, count - i );
+}
+
+inline void ConvertSse2( const float* in, std::int16_t* out, int count )
+{
+    const auto scale = _mm_set1_ps( 32768.0f );
+    const auto lower = _mm_set1_ps( -32768.0f );
+    const auto upper = _mm_set1_ps( 32767.0f );
+
+    int i = 0;
+    for ( ; i + 8 <= count; i += 8 )
+    {
+        const auto lo = _mm_min_ps( _mm_max_ps( _mm_mul_ps( _mm_loadu_ps( in + i ), scale ), lower ), upper );
+        const auto hi = _mm_min_ps( _mm_max_ps( _mm_mul_ps( _mm_loadu_ps( in + i + 4 ), scale ), lower ), upper );
+
+        _mm_storeu_si128( (__m128i*)( out + i ), _mm_packs_epi32( _mm_cvtps_epi32( lo ), _mm_cvtps_epi32( hi ) ) );
+    }
+    ConvertScalar( in + i, out + i, count - i );
+}
+
+// AVX2
+// ====
+
+template <typename Op>
+DSPATCH_TARGET_AVX2 inline void BinaryAvx2( const float* a, const float* b, float* out, int count )
+{
+    int i = 0;
+    for ( ; i + 8 <= count; i += 8 )
+    {
+        _mm256_storeu_ps( out + i, Op::Avx2( _mm256_loadu_ps( a + i ), _mm256_loadu_ps( b + i ) ) );
+    }
+    BinaryScalar<Op>( a + i, b + i, out + i, count - i );
+}
+
+DSPATCH_TARGET_AVX2 inline void MultiplyAddAvx2( const float* a, const float* b, const float* c, float* out, int count )
+{
+    int i = 0;
+    for ( ; i + 8 <= count; i += 8 )
+    {
+        _mm256_storeu_ps(
+            out + i, _mm256_add_ps( _mm256_mul_ps( _mm256_loadu_ps( a + i ), _mm256_loadu_ps( b + i ) ), _mm256_loadu_ps( c + i ) ) );
+    }
+    MultiplyAddScalar( a + i, b + i, c + i, out + i, count - i );
+}
+
+DSPATCH_TARGET_AVX2 inline void MixAvx2( const float* a, float aGain, const float* b, float bGain, float* out, int count )
+{
+    const auto ga = _mm256_set1_ps( aGain );
+    const auto gb = _mm256_set1_ps( bGain );
+
+    int i = 0;
+    for ( ; i + 8 <= count; i += 8 )
+    {
+        _mm256_storeu_ps(
+            out + i, _mm256_add_ps( _mm256_mul_ps( _mm256_loadu_ps( a + i ), ga ), _mm256_mul_ps( _mm256_loadu_ps( b + i ), gb ) ) );
+    }
+    MixScalar( a + i, aGain, b + i, bGain, out + i, count - i );
+}
+
+DSPATCH_TARGET_AVX2 inline void AbsAvx2( const float* in, float* out, int count )
+{
+    const auto signMask = _mm256_set1_ps( -0.0f );
+
+    int i = 0;
+    for ( ; i + 8 <= count; i += 8 )
+    {
+        _mm256_storeu_ps( out + i, _mm256_andnot_ps( signMask, _mm256_loadu_ps( in + i ) ) );
+    }
+    AbsScalar( in + i, out + i, count - i );
+}
+
+template <typename Op>
+DSPATCH_TARGET_AVX2 inline float ReduceAvx2( const float* in, int count )
+{
+    auto acc = _mm256_set1_ps( Op::identity );
+
+    int i = 0;
+    for ( ; i + 8 <= count; i += 8 )
+    {
+        acc = Op::Avx2( acc, _mm256_loadu_ps( in + i ) );
+    }
+
+    float lanes[8];
+    _mm256_storeu_ps( lanes, acc );
+
+    return Op::Scalar( ReduceScalar<Op>( lanes, 8 ), ReduceScalar<Op>( in + i, count - i ) );
+}
+
+DSPATCH_TARGET_AVX2 inline void ConvertAvx2( const std::int16_t* in, float* out, int count )
+{
+    const auto scale = _mm256_set1_ps( 1.0f / 32768.0f );
+
+    int i = 0;
+    for ( ; i + 8 <= count; i += 8 )
+    {
+        const auto samples = _mm256_cvtepi16_epi32( _mm_loadu_si128( (const __m128i*)( in + i ) ) );
+
+        _mm256_storeu_ps( out + i, _mm256_mul_ps( _mm256_cvtepi32_ps( samples ), scale ) );
+    }
+    ConvertScalar( in + i, out + i, count - i );
+}
+
+DSPATCH_TARGET_AVX2 inline void ConvertAvx2( const float* in, std::int16_t* out, int count )
+{
+    const auto scale = _mm256_set1_ps( 32768.0f );
+    const auto lower = _mm256_set1_ps( -32768.0f );
+    const auto upper = _mm256_set1_ps( 32767.0f );
+
+    int i = 0;
+    for ( ; i + 8 <= count; i += 8 )
+    {
+        const auto samples = _mm256_cvtps_epi32(
+            _mm256_min_ps( _mm256_max_ps( _mm256_mul_ps( _mm256_loadu_ps( in + i ), scale ), lower ), upper ) );
+
+        _mm_storeu_si128( (__m128i*)( out + i ),
+                          _mm_packs_epi32( _mm256_castsi256_si128( samples ), _mm256_extracti128_si256( samples, 1 ) ) );
+    }
+    ConvertScalar( in + i, out + i, count - i );
+}
+
+// AVX-512
+// =======
+
+#if defined( __GNUC__ ) && !defined( __clang__ )
+// GCC 12 falsely reports the undefined vectors in its AVX-512 intrinsics as maybe-uninitialized
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+template <typename Op>
+DSPATCH_TARGET_AVX512 inline void BinaryAvx512( const float* a, const float* b, float* out, int count )
+{
+    int i = 0;
+    for ( ; i + 16 <= count; i += 16 )
+    {
+        _mm512_storeu_ps( out + i, Op::Avx512( _mm512_loadu_ps( a + i ), _mm512_loadu_ps( b + i ) ) );
+    }
+    BinaryScalar<Op>( a + i, b + i, out + i, count - i );
+}
+
+DSPATCH_TARGET_AVX512 inline void MultiplyAddAvx512( const float* a, const float* b, const float* c, float* out, int count )
+{
+    int i = 0;
+    for ( ; i + 16 <= count; i += 16 )
+    {
+        _mm512_storeu_ps(
+            out + i, _mm512_add_ps( _mm512_mul_ps( _mm512_loadu_ps( a + i ), _mm512_loadu_ps( b + i ) ), _mm512_loadu_ps( c + i ) ) );
+    }
+    MultiplyAddScalar( a + i, b + i, c + i, out + i, count - i );
+}
+
+DSPATCH_TARGET_AVX512 inline void MixAvx512( const float* a, float aGain, const float* b, float bGain, float* out, int count )
+{
+    const auto ga = _mm512_set1_ps( aGain );
+    const auto gb = _mm512_set1_ps( bGain );
+
+    int i = 0;
+    for ( ; i + 16 <= count; i += 16 )
+    {
+        _mm512_storeu_ps(
+            out + i, _mm512_add_ps( _mm512_mul_ps( _mm512_loadu_ps( a + i ), ga ), _mm512_mul_ps( _mm512_loadu_ps( b + i ), gb ) ) );
+    }
+    MixScalar( a + i, aGain, b + i, bGain, out + i, count - i );
+}
+
+DSPATCH_TARGET_AVX512 inline void AbsAvx512( const float* in, float* out, int count )
+{
+    int i = 0;
+    for ( ; i + 16 <= count; i += 16 )
+    {
+        _mm512_storeu_ps( out + i, _mm512_abs_ps( _mm512_loadu_ps( in + i ) ) );
+    }
+    AbsScalar( in + i, out + i, count - i );
+}
+
+template <typename Op>
+DSPATCH_TARGET_AVX512 inline float ReduceAvx512( const float* in, int count )
+{
+    auto acc = _mm512_set1_ps( Op::identity );
+
+    int i = 0;
+    for ( ; i + 16 <= count; i += 16 )
+    {
+        acc = Op::Avx512( acc, _mm512_loadu_ps( in + i ) );
+    }
+
+    float lanes[16];
+    _mm512_storeu_ps( lanes, acc );
+
+    return Op::Scalar( ReduceScalar<Op>( lanes, 16 ), ReduceScalar<Op>( in + i, count - i ) );
+}
+
+DSPATCH_TARGET_AVX512 inline void ConvertAvx512( const std::int16_t* in, float* out, int count )
+{
+    const auto scale = _mm512_set1_ps( 1.0f / 32768.0f );
+
+    int i = 0;
+    for ( ; i + 16 <= count; i += 16 )
+    {
+        const auto samples = _mm512_cvtepi16_epi32( _mm256_loadu_si256( (const __m256i*)( in + i ) ) );
+
+        _mm512_storeu_ps( out + i, _mm512_mul_ps( _mm512_cvtepi32_ps( samples ), scale ) );
+    }
+    ConvertScalar( in + i, out + i, count - i );
+}
+
+DSPATCH_TARGET_AVX512 inline void ConvertAvx512( const float* in, std::int16_t* out, int count )
+{
+    const auto scale = _mm512_set1_ps( 32768.0f );
+    const auto lower = _mm512_set1_ps( -32768.0f );
+    const auto upper = _mm512_set1_ps( 32767.0f );
+
+    int i = 0;
+    for ( ; i + 16 <= count; i += 16 )
+    {
+        const auto samples = _mm512_cvtps_epi32(
+            _mm512_min_ps( _mm512_max_ps( _mm512_mul_ps( _mm512_loadu_ps( in + i ), scale ), lower ), upper ) );
+
+        _mm256_storeu_si256( (__m256i*)( out + i ), _mm512_cvtsepi32_epi16( samples ) );
+    }
+    ConvertScalar( in + i, out + i, count - i );
+}
+
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#pragma GCC diagnostic pop
+#endif
+
+#endif  // DSPATCH_X86_64
+
+struct KernelTable final
+{
+    void ( *add )( const float*, const float*, float*, int );
+    void ( *multiply )( const float*, const float*, float*, int );
+    void ( *multiplyAdd )( const float*, const float*, const float*, float*, int );
+    void ( *mix )( const float*, float, const float*, float, float*, int );
+    void ( *min )( const float*, const float*, float*, int );
+    void ( *max )( const float*, const float*, float*, int );
+    void ( *abs )( const float*, float*, int );
+    float ( *sum )( const float*, int );
+    float ( *minValue )( const float*, int );
+    float ( *maxValue )( const float*, int );
+    void ( *convertFromInt16 )( const std::int16_t*, float*, int );
+    void ( *convertToInt16 )( const float*, std::int16_t*, int );
+};
+
+inline KernelTable MakeKernelTable( Isa isa )
+{
+#ifdef DSPATCH_X86_64
+    if ( isa == Isa::AVX512 )
+    {
+        return { BinaryAvx512<AddOp>,
+                 BinaryAvx512<MultiplyOp>,
+                 MultiplyAddAvx512,
+                 MixAvx512,
+                 BinaryAvx512<MinOp>,
+                 BinaryAvx512<MaxOp>,
+                 AbsAvx512,
+                 ReduceAvx512<AddOp>,
+                 ReduceAvx512<MinOp>,
+                 ReduceAvx512<MaxOp>,
+                 ConvertAvx512,
+                 ConvertAvx512 };
+    }
+    if ( isa == Isa::AVX2 )
+    {
+        return { BinaryAvx2<AddOp>,
+                 BinaryAvx2<MultiplyOp>,
+                 MultiplyAddAvx2,
+                 MixAvx2,
+                 BinaryAvx2<MinOp>,
+                 BinaryAvx2<MaxOp>,
+                 AbsAvx2,
+                 ReduceAvx2<AddOp>,
+                 ReduceAvx2<MinOp>,
+                 ReduceAvx2<MaxOp>,
+                 ConvertAvx2,
+                 ConvertAvx2 };
+    }
+    if ( isa == Isa::SSE2 )
+    {
+        return { BinarySse2<AddOp>,
+                 BinarySse2<MultiplyOp>,
+                 MultiplyAddSse2,
+                 MixSse2,
+                 BinarySse2<MinOp>,
+                 BinarySse2<MaxOp>,
+                 AbsSse2,
+                 ReduceSse2<AddOp>,
+                 ReduceSse2<MinOp>,
+                 ReduceSse2<MaxOp>,
+                 ConvertSse2,
+                 ConvertSse2 };
+    }
+#else
+    (void)isa;
+#endif
+
+    return { BinaryScalar<AddOp>,
+             BinaryScalar<MultiplyOp>,
+             MultiplyAddScalar,
+             MixScalar,
+             BinaryScalar<MinOp>,
+             BinaryScalar<MaxOp>,
+             AbsScalar,
+             ReduceScalar<AddOp>,
+             ReduceScalar<MinOp>,
+             ReduceScalar<MaxOp>,
+             ConvertScalar,
+             ConvertScalar };
+}
+
+inline const KernelTable& GetKernelTable()
+{
+    // build each instruction set's kernels once, on first use, then select between them per call (so ForceIsa() applies)
+    static const KernelTable kernelTables[] = { MakeKernelTable( Isa::Scalar ),
+                                                MakeKernelTable( Isa::SSE2 ),
+                                                MakeKernelTable( Isa::AVX2 ),
+                                                MakeKernelTable( Isa::AVX512 ) };
+    return kernelTables[(size_t)GetIsa()];
+}
+
+}  // namespace internal
+
+inline void Add( const float* a, const float* b, float* out, int count )
+{
+    internal::GetKernelTable().add( a, b, out, count );
+}
+
+inline void Multiply( const float* a, const float* b, float* out, int count )
+{
+    internal::GetKernelTable().multiply( a, b, out, count );
+}
+
+inline void MultiplyAdd( const float* a, const float* b, const float* c, float* out, int count )
+{
+    internal::GetKernelTable().multiplyAdd( a, b, c, out, count );
+}
+
+inline void Mix( const float* a, float aGain, const float* b, float bGain, float* out, int count )
+{
+    internal::GetKernelTable().mix( a, aGain, b, bGain, out, count );
+}
+
+inline void Min( const float* a, const float* b, float* out, int count )
+{
+    internal::GetKernelTable().min( a, b, out, count );
+}
+
+inline void Max( const float* a, const float* b, float* out, int count )
+{
+    internal::GetKernelTable().max( a, b, out, count );
+}
+
+inline void Abs( const float* in, float* out, int count )
+{
+    internal::GetKernelTable().abs( in, out, count );
+}
+
+inline float Sum( const float* in, int count )
+{
+    return internal::GetKernelTable().sum( in, count );
+}
+
+inline float MinValue( const float* in, int count )
+{
+    return internal::GetKernelTable().minValue( in, count );
+}
+
+inline float MaxValue( const float* in, int count )
+{
+    return internal::GetKernelTable().maxValue( in, count );
+}
+
+inline void Convert( const std::int16_t* in, float* out, int count )
+{
+    internal::GetKernelTable().convertFromInt16( in, out, count );
+}
+
+inline void Convert( const float* in, std::int16_t* out, int count )
+{
+    internal::GetKernelTable().convertToInt16( in, out, count );
+}
+
+}  // namespace Kernels
+
+}  // namespace DSPatch
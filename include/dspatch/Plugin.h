@@ -29,6 +29,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
 #include "Component.h"
+#include "Dispatch.h"
 
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
@@ -64,6 +65,10 @@ href="https://github.com/cross-platform/dspatchables/tree/master/Components"><b>
 A Plugin should be constructed with the absolute path of the plugin (shared library) to be loaded. Once instantiated you should
 check that the plugin was successfully loaded by calling IsLoaded(). Thereafter, the contained component type can be instantiated
 (mutiple times) via the Create() method.
+
+<b>PERFORMANCE TIP:</b> As a plugin cannot know which CPU it will be loaded on, it should be built for a baseline instruction set.
+Components can still make use of wider instruction sets (E.g. AVX2 and AVX-512) by registering instruction set specific variants of
+their kernels with a Dispatcher, which selects the best variant supported by the host CPU at runtime.
 */
 
 class Plugin final
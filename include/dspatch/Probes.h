@@ -0,0 +1,114 @@
+/******************************************************************************
+DSPatch - The Refreshingly Simple C++ Dataflow Framework
+Copyright (c) 2025, Marcus Tomlinson
+
+BSD 2-Clause License
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include <type_traits>
+
+/// Linux USDT probes
+
+/**
+When DSPatch is compiled with DSPATCH_ENABLE_PROBES defined (on Linux x86-64 / AArch64 with GCC or Clang), static tracepoints are
+compiled into the tick hot path. Each probe is a single nop instruction plus an ELF note (in the same format as sys/sdt.h, but
+without requiring the systemtap headers), so probes cost next to nothing until a tracer such as bpftrace or perf attaches to them.
+Without DSPATCH_ENABLE_PROBES (or on other platforms) the probes compile out entirely.
+
+All probes belong to the "dspatch" provider:
+
+    circuit_tick_begin / circuit_tick_end                 (Circuit*, int bufferNo)
+    component_tick_begin / component_tick_end             (Component*, int bufferNo)
+    component_tick_parallel_begin / ..._parallel_end      (Component*, int bufferNo)
+    process_begin / process_end                           (Component*, int bufferNo)
+    wait_for_release_begin / wait_for_release_end         (Component*, int bufferNo)
+    wait_begin / wait_end                                 (flag address)  - only fired when a wait has to spin
+    optimize_begin / optimize_end                         (Circuit*, int componentCount)
+
+E.g. to histogram Process_() durations per component in a running process:
+
+    bpftrace -p $PID -e 'usdt:*:dspatch:process_begin { @start[tid] = nsecs; }
+                         usdt:*:dspatch:process_end /@start[tid]/ { @ns[arg0] = hist(nsecs - @start[tid]); delete(@start[tid]); }'
+*/
+
+#if defined( DSPATCH_ENABLE_PROBES ) && defined( __linux__ ) && ( defined( __x86_64__ ) || defined( __aarch64__ ) ) && \
+    ( defined( __GNUC__ ) || defined( __clang__ ) )
+
+namespace DSPatch::internal
+{
+
+// the argument size as encoded in a probe's note: negative for signed arguments
+template <typename T>
+constexpr int ProbeArgSize()
+{
+    return ( std::is_signed<T>::value ? -1 : 1 ) * (int)sizeof( T );
+}
+
+}  // namespace DSPatch::internal
+
+// clang-format off
+#define DSPATCH_PROBE_NOTE( name, args )                                                    \
+    "990: nop\n"                                                                            \
+    ".pushsection .note.stapsdt,\"?\",\"note\"\n"                                           \
+    ".balign 4\n"                                                                           \
+    ".4byte 992f-991f, 994f-993f, 3\n"                                                      \
+    "991: .asciz \"stapsdt\"\n"                                                             \
+    "992: .balign 4\n"                                                                      \
+    "993: .8byte 990b\n"                                                                    \
+    ".8byte _.stapsdt.base\n"                                                               \
+    ".8byte 0\n"                                                                            \
+    ".asciz \"dspatch\"\n"                                                                  \
+    ".asciz \"" #name "\"\n"                                                                \
+    ".asciz \"" args "\"\n"                                                                 \
+    "994: .balign 4\n"                                                                      \
+    ".popsection\n"                                                                         \
+    ".ifndef _.stapsdt.base\n"                                                              \
+    ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n"                 \
+    ".weak _.stapsdt.base\n"                                                                \
+    ".hidden _.stapsdt.base\n"                                                              \
+    "_.stapsdt.base: .space 1\n"                                                            \
+    ".size _.stapsdt.base, 1\n"                                                             \
+    ".popsection\n"                                                                         \
+    ".endif\n"
+// clang-format on
+
+#define DSPATCH_PROBE_OPERAND( no, arg )                                                            \
+    [S##no] "n"( DSPatch::internal::ProbeArgSize<std::decay_t<decltype( arg )>>() ), [A##no] "nor"( arg )
+
+#define DSPATCH_PROBE2( name, arg1, arg2 )                                                                                   \
+    __asm__ __volatile__( DSPATCH_PROBE_NOTE( name, "%c[S1]@%[A1] %c[S2]@%[A2]" )                                             \
+                          :                                                                                                  \
+                          : DSPATCH_PROBE_OPERAND( 1, arg1 ), DSPATCH_PROBE_OPERAND( 2, arg2 ) )
+
+#define DSPATCH_PROBE1( name, arg1 )                                                                                         \
+    __asm__ __volatile__( DSPATCH_PROBE_NOTE( name, "%c[S1]@%[A1]" ) : : DSPATCH_PROBE_OPERAND( 1, arg1 ) )
+
+#else
+
+#define DSPATCH_PROBE2( name, arg1, arg2 )
+#define DSPATCH_PROBE1( name, arg1 )
+
+#endif
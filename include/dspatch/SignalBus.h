@@ -28,6 +28,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #pragma once
 
+#include "ComponentArena.h"
+
 #include "../fast_any/any.h"
 
 #include <vector>
@@ -84,7 +86,11 @@ public:
     fast_any::type_info GetType( int signalIndex ) const;
 
 private:
-    std::vector<fast_any::any> _signals;
+    friend class Component;
+
+    void _Relocate( ComponentArena* arena );
+
+    std::vector<fast_any::any, internal::StateAllocator<fast_any::any>> _signals;  // heap allocated unless relocated
 };
 
 inline SignalBus::SignalBus() = default;
@@ -184,4 +190,20 @@ inline fast_any::type_info SignalBus::GetType( int signalIndex ) const
     return _signals[signalIndex].type();
 }
 
+inline void SignalBus::_Relocate( ComponentArena* arena )
+{
+    // move our signals into storage allocated from arena (see Component::RelocateState())
+    const internal::StateAllocator<fast_any::any> allocator( arena );
+
+    decltype( _signals ) signals( allocator );
+    signals.resize( _signals.size() );
+
+    for ( size_t i = 0; i < _signals.size(); ++i )
+    {
+        signals[i].swap( _signals[i] );
+    }
+
+    _signals = std::move( signals );
+}
+
 }  // namespace DSPatch
@@ -0,0 +1,666 @@
+/******************************************************************************
+DSPatch - The Refreshingly Simple C++ Dataflow Framework
+Copyright (c) 2025, Marcus Tomlinson
+
+BSD 2-Clause License
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include "../fast_any/any.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#ifdef DSPATCH_ENABLE_STATS
+#define DSPATCH_STATS( ... ) __VA_ARGS__
+#else
+#define DSPATCH_STATS( ... )
+#endif
+
+namespace DSPatch
+{
+
+class Component;
+
+namespace internal
+{
+class AtomicHistogram;
+}
+
+/// Log-linear histogram of durations
+
+/**
+A Histogram counts recorded values (nanoseconds, in the case of circuit stats) into log-linear buckets: each power of 2 is split
+into 8 linear sub-buckets, so any recorded value can be recovered to within 12.5% of its true value (values below 8 are exact),
+while the whole range up to ~18 minutes fits in a few hundred buckets. The exact minimum, maximum and total are tracked alongside
+the buckets.
+
+Histograms returned from Circuit::GetStats() are snapshots, and can be freely copied, merged and queried. GetPercentile() returns
+the upper bound of the bucket the requested percentile falls into (clamped to GetMax()).
+*/
+
+class Histogram final
+{
+public:
+    static constexpr int subBucketBits = 3;
+    static constexpr int subBucketCount = 1 << subBucketBits;
+    static constexpr int maxExponent = 40;
+    static constexpr int bucketCount = ( maxExponent - subBucketBits + 1 ) * subBucketCount;
+
+    Histogram();
+
+    void Record( uint64_t value );
+    void Merge( const Histogram& other );
+    void Reset();
+
+    uint64_t GetCount() const;
+    uint64_t GetTotal() const;
+    uint64_t GetMin() const;
+    uint64_t GetMax() const;
+    double GetMean() const;
+    uint64_t GetPercentile( double percentile ) const;
+
+    static int GetBucket( uint64_t value );
+    static uint64_t GetBucketUpperBound( int bucket );
+
+private:
+    friend class internal::AtomicHistogram;
+
+    std::vector<uint64_t> _counts;
+
+    uint64_t _count = 0;
+    uint64_t _total = 0;
+    uint64_t _min = std::numeric_limits<uint64_t>::max();
+    uint64_t _max = 0;
+};
+
+/// Signal traffic snapshot of a single component input
+
+/**
+Counts how the signals gathered by a component input were delivered, merged across the component's buffers. A signal is moved if
+this wire is its output's only (or final) consumer that tick, copied if another consumer of the same output still has to gather
+it, and null if the output held no value. bytesCopied totals the sizes of copied signals, as reported by the size hook registered
+for their type (see SetSignalSizeHook()). Copies of types without a size hook are counted, but add 0 bytes.
+
+Counts are kept per input rather than per wire, so they carry over if the input is rewired. fromComponent and fromOutput describe
+the wire connected at the time of the snapshot (fromComponent is nullptr if the input is not connected).
+*/
+
+struct WireStats final
+{
+    const DSPatch::Component* fromComponent = nullptr;
+    int fromOutput = -1;
+    int toInput = 0;
+
+    uint64_t moves = 0;
+    uint64_t copies = 0;
+    uint64_t nulls = 0;
+    uint64_t bytesCopied = 0;
+};
+
+/// Timing snapshot of a single component
+
+/**
+All durations are in nanoseconds, and are merged across the component's buffers. gatherTime covers acquiring inputs from incoming
+wires, waitTime covers spinning for upstream outputs (multi-threaded circuits) or for this component's turn to process an
+in-order buffer (multi-buffered circuits), and processTime covers the component's Process_() method. releaseWaitTimes breaks the
+latter down per buffer: the time each buffer of an in-order component spent waiting for its turn to process (empty histograms for
+out-of-order components, or components with a single buffer). inputs holds a WireStats entry per input, in input order.
+*/
+
+struct ComponentStats final
+{
+    const DSPatch::Component* component = nullptr;
+
+    Histogram gatherTime;
+    Histogram waitTime;
+    Histogram processTime;
+
+    std::vector<Histogram> releaseWaitTimes;
+
+    std::vector<WireStats> inputs;
+};
+
+/// Timing snapshot of a circuit
+
+/**
+tickTime holds the time taken by each circuit thread to process its share of a tick (in a circuit with no threads, or with only
+buffer threads, this is the time taken to process the whole tick). components holds a ComponentStats entry per component, in
+processing order. enabled is false (and all histograms empty) if DSPatch was compiled without DSPATCH_ENABLE_STATS.
+*/
+
+struct CircuitStats final
+{
+    bool enabled = false;
+
+    Histogram tickTime;
+    std::vector<ComponentStats> components;
+};
+
+/// Latency snapshot of a circuit
+
+/**
+All durations are in nanoseconds. queueTime holds the time from a buffer being submitted to its circuit thread(s) (by
+Circuit::Tick()) until processing of that buffer began, and completionTime holds the time from submission until all of the
+buffer's components finished processing. bufferCompletionTimes breaks completionTime down per buffer. In a circuit with no buffers
+or threads, ticks are processed on the caller's thread, so queueTime is always 0 and completionTime is the duration of Tick().
+*/
+
+struct LatencyStats final
+{
+    bool enabled = false;
+
+    Histogram queueTime;
+    Histogram completionTime;
+    std::vector<Histogram> bufferCompletionTimes;
+};
+
+/// Registers the function used to measure copied signals of type T (see WireStats)
+
+/**
+E.g. SetSignalSizeHook<std::vector<float>>( []( const std::vector<float>& v ) { return v.size() * sizeof( float ); } );
+
+Registering a hook for a type replaces any previous hook for it. Hooks should be registered before any circuit starts ticking.
+*/
+
+template <typename T>
+void SetSignalSizeHook( std::function<size_t( const T& )> sizeHook );
+
+namespace internal
+{
+
+using StatsClock = std::chrono::steady_clock;
+
+inline uint64_t StatsNow()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>( StatsClock::now().time_since_epoch() ).count();
+}
+
+inline uint64_t StatsElapsed( StatsClock::time_point from, StatsClock::time_point to )
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>( to - from ).count();
+}
+
+// time the current thread has spent spinning in AtomicFlag::WaitAndClear()
+inline uint64_t& StatsThreadWaitTime()
+{
+    thread_local uint64_t waitTime = 0;
+    return waitTime;
+}
+
+class AtomicHistogram final
+{
+public:
+    AtomicHistogram( const AtomicHistogram& ) = delete;
+    AtomicHistogram& operator=( const AtomicHistogram& ) = delete;
+
+    AtomicHistogram();
+    AtomicHistogram( AtomicHistogram&& ) = default;
+
+    // You might be thinking: Why not fetch_add()?
+
+    // Each histogram has a single writer (the thread processing its component's buffer, or its
+    // circuit thread), so a relaxed load + store is enough, and avoids a locked instruction per
+    // update. Readers may see a snapshot that is a few updates behind, but never a torn value.
+
+    void Record( uint64_t value );
+    void Reset();
+
+    void MergeInto( Histogram& histogram ) const;
+
+private:
+    struct Data final
+    {
+        std::atomic<uint64_t> counts[Histogram::bucketCount];
+        std::atomic<uint64_t> count;
+        std::atomic<uint64_t> total;
+        std::atomic<uint64_t> min;
+        std::atomic<uint64_t> max;
+    };
+
+    static void _Increment( std::atomic<uint64_t>& value, uint64_t amount );
+
+    std::unique_ptr<Data> _data;  // heap allocated so that recorders can be held in (resizable) vectors
+};
+
+enum class SignalTransfer
+{
+    Null,
+    Move,
+    Copy
+};
+
+using SignalSizeHook = std::function<bool( const fast_any::any& signal, size_t& size )>;
+
+struct SignalSizeHooks final
+{
+    std::mutex mutex;  // guards registration only (hooks are registered before ticking)
+    std::vector<SignalSizeHook> hooks;
+};
+
+SignalSizeHooks& GetSignalSizeHooks();
+size_t GetSignalSize( const fast_any::any& signal );
+
+// counts the signal transfers into each input of a component's buffer
+class TransferRecorder final
+{
+public:
+    TransferRecorder( const TransferRecorder& ) = delete;
+    TransferRecorder& operator=( const TransferRecorder& ) = delete;
+
+    TransferRecorder() = default;
+    TransferRecorder( TransferRecorder&& ) = default;
+
+    void SetInputCount( int inputCount );
+
+    void Record( int input, SignalTransfer transfer, const fast_any::any& signal );
+    void Reset();
+
+    void MergeInto( std::vector<WireStats>& inputs ) const;
+
+private:
+    struct Counters final
+    {
+        std::atomic<uint64_t> moves;
+        std::atomic<uint64_t> copies;
+        std::atomic<uint64_t> nulls;
+        std::atomic<uint64_t> bytesCopied;
+    };
+
+    std::unique_ptr<Counters[]> _counters;  // heap allocated so that recorders can be held in (resizable) vectors
+    int _inputCount = 0;
+};
+
+struct ComponentStatsRecorder final
+{
+    AtomicHistogram gatherTime;
+    AtomicHistogram waitTime;
+    AtomicHistogram processTime;
+    AtomicHistogram releaseWaitTime;
+
+    TransferRecorder transfers;
+};
+
+// times the phases of a single component tick
+class StatsTimer final
+{
+public:
+    StatsTimer( const StatsTimer& ) = delete;
+    StatsTimer& operator=( const StatsTimer& ) = delete;
+
+    explicit StatsTimer( ComponentStatsRecorder& recorder );
+
+    void EndGather();
+    void EndWait();
+    void EndProcess();
+
+private:
+    ComponentStatsRecorder& _recorder;
+
+    StatsClock::time_point _time;
+    uint64_t _startWaitTime;
+    uint64_t _gatherTime = 0;
+    uint64_t _waitTime = 0;
+};
+
+}  // namespace internal
+
+inline Histogram::Histogram()
+    : _counts( bucketCount, 0 )
+{
+}
+
+inline void Histogram::Record( uint64_t value )
+{
+    ++_counts[GetBucket( value )];
+    ++_count;
+    _total += value;
+    _min = std::min( _min, value );
+    _max = std::max( _max, value );
+}
+
+inline void Histogram::Merge( const Histogram& other )
+{
+    for ( int i = 0; i < bucketCount; ++i )
+    {
+        _counts[i] += other._counts[i];
+    }
+
+    _count += other._count;
+    _total += other._total;
+    _min = std::min( _min, other._min );
+    _max = std::max( _max, other._max );
+}
+
+// cppcheck-suppress unusedFunction
+inline void Histogram::Reset()
+{
+    *this = Histogram();
+}
+
+inline uint64_t Histogram::GetCount() const
+{
+    return _count;
+}
+
+inline uint64_t Histogram::GetTotal() const
+{
+    return _total;
+}
+
+inline uint64_t Histogram::GetMin() const
+{
+    return _count == 0 ? 0 : _min;
+}
+
+inline uint64_t Histogram::GetMax() const
+{
+    return _max;
+}
+
+inline double Histogram::GetMean() const
+{
+    return _count == 0 ? 0.0 : (double)_total / (double)_count;
+}
+
+inline uint64_t Histogram::GetPercentile( double percentile ) const
+{
+    if ( _count == 0 )
+    {
+        return 0;
+    }
+
+    // the rank of the sample we're looking for (1-based)
+    const auto rank =
+        std::max( (uint64_t)1, (uint64_t)std::ceil( std::clamp( percentile, 0.0, 100.0 ) / 100.0 * (double)_count ) );
+
+    uint64_t seen = 0;
+    for ( int i = 0; i < bucketCount; ++i )
+    {
+        seen += _counts[i];
+
+        if ( seen >= rank )
+        {
+            return std::clamp( GetBucketUpperBound( i ), GetMin(), _max );
+        }
+    }
+
+    return _max;
+}
+
+inline int Histogram::GetBucket( uint64_t value )
+{
+    if ( value < subBucketCount )
+    {
+        return (int)value;
+    }
+
+    // find the index of the most significant bit
+#ifdef _MSC_VER
+    unsigned long msb;
+    _BitScanReverse64( &msb, value );
+    const int exponent = (int)msb;
+#else
+    const int exponent = 63 - __builtin_clzll( value );
+#endif
+
+    if ( exponent >= maxExponent )
+    {
+        return bucketCount - 1;
+    }
+
+    // the bits just below the most significant bit select the sub-bucket
+    const auto subBucket = (int)( value >> ( exponent - subBucketBits ) ) - subBucketCount;
+
+    return ( exponent - subBucketBits + 1 ) * subBucketCount + subBucket;
+}
+
+template <typename T>
+inline void SetSignalSizeHook( std::function<size_t( const T& )> sizeHook )
+{
+    auto& sizeHooks = internal::GetSignalSizeHooks();
+    std::lock_guard<std::mutex> lock( sizeHooks.mutex );
+
+    auto hook = [sizeHook = std::move( sizeHook )]( const fast_any::any& signal, size_t& size ) {
+        if ( auto value = signal.as<T>() )
+        {
+            size = sizeHook( *value );
+            return true;
+        }
+        return false;
+    };
+
+    // each type gets its own instance of this function, and so its own slot in the hooks
+    static int slot = -1;
+
+    if ( slot == -1 )
+    {
+        slot = (int)sizeHooks.hooks.size();
+        sizeHooks.hooks.emplace_back( std::move( hook ) );
+    }
+    else
+    {
+        sizeHooks.hooks[slot] = std::move( hook );
+    }
+}
+
+inline uint64_t Histogram::GetBucketUpperBound( int bucket )
+{
+    if ( bucket < subBucketCount )
+    {
+        return (uint64_t)bucket;
+    }
+
+    const auto exponent = bucket / subBucketCount + subBucketBits - 1;
+    const auto subBucket = (uint64_t)( bucket % subBucketCount + subBucketCount + 1 );
+
+    return ( subBucket << ( exponent - subBucketBits ) ) - 1;
+}
+
+namespace internal
+{
+
+inline AtomicHistogram::AtomicHistogram()
+    : _data( std::make_unique<Data>() )
+{
+    Reset();
+}
+
+inline void AtomicHistogram::Record( uint64_t value )
+{
+    _Increment( _data->counts[Histogram::GetBucket( value )], 1 );
+    _Increment( _data->count, 1 );
+    _Increment( _data->total, value );
+
+    if ( value < _data->min.load( std::memory_order_relaxed ) )
+    {
+        _data->min.store( value, std::memory_order_relaxed );
+    }
+    if ( value > _data->max.load( std::memory_order_relaxed ) )
+    {
+        _data->max.store( value, std::memory_order_relaxed );
+    }
+}
+
+inline void AtomicHistogram::Reset()
+{
+    for ( auto& count : _data->counts )
+    {
+        count.store( 0, std::memory_order_relaxed );
+    }
+
+    _data->count.store( 0, std::memory_order_relaxed );
+    _data->total.store( 0, std::memory_order_relaxed );
+    _data->min.store( std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed );
+    _data->max.store( 0, std::memory_order_relaxed );
+}
+
+inline void AtomicHistogram::MergeInto( Histogram& histogram ) const
+{
+    for ( int i = 0; i < Histogram::bucketCount; ++i )
+    {
+        histogram._counts[i] += _data->counts[i].load( std::memory_order_relaxed );
+    }
+
+    histogram._count += _data->count.load( std::memory_order_relaxed );
+    histogram._total += _data->total.load( std::memory_order_relaxed );
+    histogram._min = std::min( histogram._min, _data->min.load( std::memory_order_relaxed ) );
+    histogram._max = std::max( histogram._max, _data->max.load( std::memory_order_relaxed ) );
+}
+
+inline void AtomicHistogram::_Increment( std::atomic<uint64_t>& value, uint64_t amount )
+{
+    value.store( value.load( std::memory_order_relaxed ) + amount, std::memory_order_relaxed );
+}
+
+inline SignalSizeHooks& GetSignalSizeHooks()
+{
+    static SignalSizeHooks sizeHooks;
+    return sizeHooks;
+}
+
+inline size_t GetSignalSize( const fast_any::any& signal )
+{
+    size_t size = 0;
+
+    for ( const auto& hook : GetSignalSizeHooks().hooks )
+    {
+        if ( hook( signal, size ) )
+        {
+            break;
+        }
+    }
+
+    return size;
+}
+
+inline void TransferRecorder::SetInputCount( int inputCount )
+{
+    if ( inputCount == _inputCount )
+    {
+        return;
+    }
+
+    _counters = std::make_unique<Counters[]>( inputCount );
+    _inputCount = inputCount;
+}
+
+inline void TransferRecorder::Record( int input, SignalTransfer transfer, const fast_any::any& signal )
+{
+    auto& counters = _counters[input];
+
+    // single writer (see AtomicHistogram)
+    auto increment = []( std::atomic<uint64_t>& value, uint64_t amount ) {
+        value.store( value.load( std::memory_order_relaxed ) + amount, std::memory_order_relaxed );
+    };
+
+    switch ( transfer )
+    {
+        case SignalTransfer::Null:
+            increment( counters.nulls, 1 );
+            break;
+        case SignalTransfer::Move:
+            increment( counters.moves, 1 );
+            break;
+        case SignalTransfer::Copy:
+            increment( counters.copies, 1 );
+            increment( counters.bytesCopied, GetSignalSize( signal ) );
+            break;
+    }
+}
+
+inline void TransferRecorder::Reset()
+{
+    for ( int i = 0; i < _inputCount; ++i )
+    {
+        _counters[i].moves.store( 0, std::memory_order_relaxed );
+        _counters[i].copies.store( 0, std::memory_order_relaxed );
+        _counters[i].nulls.store( 0, std::memory_order_relaxed );
+        _counters[i].bytesCopied.store( 0, std::memory_order_relaxed );
+    }
+}
+
+inline void TransferRecorder::MergeInto( std::vector<WireStats>& inputs ) const
+{
+    for ( int i = 0; i < _inputCount && i < (int)inputs.size(); ++i )
+    {
+        inputs[i].moves += _counters[i].moves.load( std::memory_order_relaxed );
+        inputs[i].copies += _counters[i].copies.load( std::memory_order_relaxed );
+        inputs[i].nulls += _counters[i].nulls.load( std::memory_order_relaxed );
+        inputs[i].bytesCopied += _counters[i].bytesCopied.load( std::memory_order_relaxed );
+    }
+}
+
+inline StatsTimer::StatsTimer( ComponentStatsRecorder& recorder )
+    : _recorder( recorder )
+    , _time( StatsClock::now() )
+    , _startWaitTime( StatsThreadWaitTime() )
+{
+}
+
+inline void StatsTimer::EndGather()
+{
+    const auto time = StatsClock::now();
+
+    // time spent spinning on upstream outputs counts as wait time rather than gather time
+    _waitTime = StatsThreadWaitTime() - _startWaitTime;
+    _gatherTime = StatsElapsed( _time, time ) - std::min( _waitTime, StatsElapsed( _time, time ) );
+
+    _time = time;
+}
+
+inline void StatsTimer::EndWait()
+{
+    const auto time = StatsClock::now();
+
+    // only in-order buffers wait for their turn between gathering and processing
+    _recorder.releaseWaitTime.Record( StatsElapsed( _time, time ) );
+    _waitTime += StatsElapsed( _time, time );
+
+    _time = time;
+}
+
+inline void StatsTimer::EndProcess()
+{
+    _recorder.gatherTime.Record( _gatherTime );
+    _recorder.waitTime.Record( _waitTime );
+    _recorder.processTime.Record( StatsElapsed( _time, StatsClock::now() ) );
+}
+
+}  // namespace internal
+
+}  // namespace DSPatch
@@ -0,0 +1,429 @@
+/******************************************************************************
+DSPatch - The Refreshingly Simple C++ Dataflow Framework
+Copyright (c) 2025, Marcus Tomlinson
+
+BSD 2-Clause License
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#if defined( __GNUG__ ) || defined( __clang__ )
+#include <cxxabi.h>
+#endif
+
+#ifdef DSPATCH_ENABLE_TRACE
+#define DSPATCH_TRACE( ... ) __VA_ARGS__
+#else
+#define DSPATCH_TRACE( ... )
+#endif
+
+#ifndef DSPATCH_TRACE_CAPACITY
+#define DSPATCH_TRACE_CAPACITY 65536  // events per thread
+#endif
+
+namespace DSPatch
+{
+
+/// Timeline recording of circuit execution
+
+/**
+When DSPatch is compiled with DSPATCH_ENABLE_TRACE defined, component ticks, Process_() calls, spin-waits (on upstream outputs and
+in-order buffers), circuit thread sync / resume, and auto-tick pause / resume are recorded as timeline events between calls to
+StartTrace() and StopTrace(). Without DSPATCH_ENABLE_TRACE, these functions do nothing and the recording is compiled out entirely.
+
+Events are recorded lock-free into a ring buffer per thread, holding the most recent DSPATCH_TRACE_CAPACITY events (define this
+before including DSPatch to change it). ExportTrace() writes the recorded events in Chrome Trace Event JSON format, which can be
+opened in Perfetto (ui.perfetto.dev) or chrome://tracing. Each circuit thread is labelled with the buffer (and thread) it
+processes, and each Tick event is labelled with the component's type and the buffer it processed.
+
+<b>NOTE:</b> ExportTrace() and ClearTrace() must not be called while a circuit is ticking (E.g. call StopTrace() and
+Circuit::PauseAutoTick() first).
+*/
+
+void StartTrace();
+void StopTrace();
+bool IsTracing();
+
+void ClearTrace();
+
+void ExportTrace( std::ostream& stream );
+bool ExportTrace( const std::string& filePath );
+
+namespace internal
+{
+
+struct TraceEvent final
+{
+    const char* name;
+    const std::type_info* type;
+    uint64_t start;
+    uint64_t duration;
+    int bufferNo;
+    char phase;
+};
+
+class TraceBuffer final
+{
+public:
+    TraceBuffer( const TraceBuffer& ) = delete;
+    TraceBuffer& operator=( const TraceBuffer& ) = delete;
+
+    TraceBuffer( int threadId, const std::string& threadName );
+
+    void Record( const TraceEvent& event );
+    void Clear();
+
+    void Export( std::ostream& stream, bool& first ) const;
+
+    bool IsRetired() const;
+    void Retire();
+
+private:
+    const int _threadId;
+    const std::string _threadName;
+
+    std::vector<TraceEvent> _events;
+    std::atomic<uint64_t> _head = 0;
+    std::atomic<bool> _retired = false;
+};
+
+struct TraceState final
+{
+    std::atomic<bool> recording = false;
+
+    std::mutex mutex;
+    std::vector<std::shared_ptr<TraceBuffer>> buffers;
+    int nextThreadId = 1;
+
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+};
+
+TraceState& GetTraceState();
+TraceBuffer& GetThreadTraceBuffer();
+std::string& GetThreadTraceName();
+
+void SetTraceThreadName( const std::string& threadName );
+
+std::string DemangleTypeName( const std::type_info& type );
+
+uint64_t TraceNow();
+void TraceInstant( const char* name, int bufferNo = -1 );
+
+// records a complete event spanning its own lifetime
+class TraceScope final
+{
+public:
+    TraceScope( const TraceScope& ) = delete;
+    TraceScope& operator=( const TraceScope& ) = delete;
+
+    explicit TraceScope( const char* name, int bufferNo = -1, const std::type_info* type = nullptr );
+    ~TraceScope();
+
+private:
+    const char* _name;
+    const std::type_info* _type;
+    int _bufferNo;
+    uint64_t _start = 0;
+    bool _recording;
+};
+
+}  // namespace internal
+
+inline void StartTrace()
+{
+    DSPATCH_TRACE( internal::GetTraceState().recording = true; )
+}
+
+inline void StopTrace()
+{
+    DSPATCH_TRACE( internal::GetTraceState().recording = false; )
+}
+
+inline bool IsTracing()
+{
+#ifdef DSPATCH_ENABLE_TRACE
+    return internal::GetTraceState().recording.load( std::memory_order_relaxed );
+#else
+    return false;
+#endif
+}
+
+inline void ClearTrace()
+{
+#ifdef DSPATCH_ENABLE_TRACE
+    auto& state = internal::GetTraceState();
+    std::lock_guard<std::mutex> lock( state.mutex );
+
+    // drop the buffers of threads that have since exited
+    state.buffers.erase( std::remove_if( state.buffers.begin(),
+                                         state.buffers.end(),
+                                         []( const auto& buffer ) { return buffer->IsRetired(); } ),
+                         state.buffers.end() );
+
+    for ( auto& buffer : state.buffers )
+    {
+        buffer->Clear();
+    }
+#endif
+}
+
+inline void ExportTrace( std::ostream& stream )
+{
+    stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+#ifdef DSPATCH_ENABLE_TRACE
+    auto& state = internal::GetTraceState();
+    std::lock_guard<std::mutex> lock( state.mutex );
+
+    bool first = true;
+    for ( const auto& buffer : state.buffers )
+    {
+        buffer->Export( stream, first );
+    }
+#endif
+
+    stream << "]}\n";
+}
+
+inline bool ExportTrace( const std::string& filePath )
+{
+    std::ofstream stream( filePath );
+
+    if ( !stream )
+    {
+        return false;
+    }
+
+    ExportTrace( stream );
+
+    return (bool)stream;
+}
+
+namespace internal
+{
+
+inline TraceBuffer::TraceBuffer( int threadId, const std::string& threadName )
+    : _threadId( threadId )
+    , _threadName( threadName )
+    , _events( DSPATCH_TRACE_CAPACITY )
+{
+}
+
+inline void TraceBuffer::Record( const TraceEvent& event )
+{
+    // only the owning thread records, so the head can't move under us
+    const auto head = _head.load( std::memory_order_relaxed );
+
+    _events[head % _events.size()] = event;
+
+    _head.store( head + 1, std::memory_order_release );
+}
+
+inline void TraceBuffer::Clear()
+{
+    _head.store( 0, std::memory_order_release );
+}
+
+inline void TraceBuffer::Export( std::ostream& stream, bool& first ) const
+{
+    auto separator = [&stream, &first]() {
+        if ( !first )
+        {
+            stream << ",\n";
+        }
+        first = false;
+    };
+
+    const auto head = _head.load( std::memory_order_acquire );
+
+    if ( head == 0 )
+    {
+        return;
+    }
+
+    separator();
+    stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << _threadId << ",\"args\":{\"name\":\""
+           << ( _threadName.empty() ? "Thread " + std::to_string( _threadId ) : _threadName ) << "\"}}";
+
+    // once the ring has wrapped, only the most recent events remain
+    const auto capacity = (uint64_t)_events.size();
+    const auto begin = head > capacity ? head - capacity : 0;
+
+    for ( auto i = begin; i < head; ++i )
+    {
+        const auto& event = _events[i % capacity];
+
+        const std::string name = event.type ? DemangleTypeName( *event.type ) : event.name;
+
+        separator();
+        stream << "{\"name\":\"" << name << "\",\"cat\":\"" << event.name << "\",\"ph\":\"" << event.phase
+               << "\",\"ts\":" << (double)event.start / 1000.0;
+
+        if ( event.phase == 'X' )
+        {
+            stream << ",\"dur\":" << (double)event.duration / 1000.0;
+        }
+        else
+        {
+            stream << ",\"s\":\"t\"";
+        }
+
+        stream << ",\"pid\":1,\"tid\":" << _threadId;
+
+        if ( event.bufferNo >= 0 )
+        {
+            stream << ",\"args\":{\"buffer\":" << event.bufferNo << "}";
+        }
+
+        stream << "}";
+    }
+}
+
+inline bool TraceBuffer::IsRetired() const
+{
+    return _retired;
+}
+
+inline void TraceBuffer::Retire()
+{
+    _retired = true;
+}
+
+inline TraceState& GetTraceState()
+{
+    static TraceState state;
+    return state;
+}
+
+inline TraceBuffer& GetThreadTraceBuffer()
+{
+    // You might be thinking: Why not just hold the buffer in a thread_local?
+
+    // The events of a thread must outlive the thread itself (circuit threads are restarted whenever
+    // the buffer or thread count changes), so buffers are owned by the trace state, and a thread
+    // merely retires its buffer on exit. Retired buffers are dropped on the next ClearTrace().
+
+    struct Handle final
+    {
+        Handle()
+        {
+            auto& state = GetTraceState();
+            std::lock_guard<std::mutex> lock( state.mutex );
+
+            buffer = std::make_shared<TraceBuffer>( state.nextThreadId++, GetThreadTraceName() );
+            state.buffers.emplace_back( buffer );
+        }
+
+        ~Handle()
+        {
+            buffer->Retire();
+        }
+
+        std::shared_ptr<TraceBuffer> buffer;
+    };
+
+    thread_local Handle handle;
+    return *handle.buffer;
+}
+
+inline std::string& GetThreadTraceName()
+{
+    thread_local std::string threadName;
+    return threadName;
+}
+
+inline void SetTraceThreadName( const std::string& threadName )
+{
+    // applied to the thread's buffer when it records its first event
+    GetThreadTraceName() = threadName;
+}
+
+inline std::string DemangleTypeName( const std::type_info& type )
+{
+    std::string name = type.name();
+
+#if defined( __GNUG__ ) || defined( __clang__ )
+    int status = 0;
+    auto demangled = abi::__cxa_demangle( name.c_str(), nullptr, nullptr, &status );
+    if ( status == 0 && demangled )
+    {
+        name = demangled;
+    }
+    std::free( demangled );
+#endif
+
+    return name;
+}
+
+inline uint64_t TraceNow()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() -
+                                                                           GetTraceState().epoch )
+        .count();
+}
+
+inline void TraceInstant( const char* name, int bufferNo )
+{
+    if ( IsTracing() )
+    {
+        GetThreadTraceBuffer().Record( TraceEvent{ name, nullptr, TraceNow(), 0, bufferNo, 'i' } );
+    }
+}
+
+inline TraceScope::TraceScope( const char* name, int bufferNo, const std::type_info* type )
+    : _name( name )
+    , _type( type )
+    , _bufferNo( bufferNo )
+    , _recording( IsTracing() )
+{
+    if ( _recording )
+    {
+        _start = TraceNow();
+    }
+}
+
+inline TraceScope::~TraceScope()
+{
+    if ( _recording )
+    {
+        GetThreadTraceBuffer().Record( TraceEvent{ _name, _type, _start, TraceNow() - _start, _bufferNo, 'X' } );
+    }
+}
+
+}  // namespace internal
+
+}  // namespace DSPatch
@@ -0,0 +1,71 @@
+/******************************************************************************
+DSPatch - The Refreshingly Simple C++ Dataflow Framework
+Copyright (c) 2025, Marcus Tomlinson
+
+BSD 2-Clause License
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+namespace DSPatch
+{
+
+class BlockProbe final : public Component
+{
+public:
+    explicit BlockProbe( int blockSize )
+        : _blockSize( blockSize )
+        , _count( 0 )
+    {
+        SetInputCount_( 2 );
+    }
+
+protected:
+    void Process_( SignalBus& inputs, SignalBus& ) override
+    {
+        // input 0: ( count + count ) * count + count
+        auto block = inputs.GetValue<Block<float>>( 0 );
+        REQUIRE( block );
+        REQUIRE( block->GetSize() == _blockSize );
+
+        const auto expected = (float)( ( _count + _count ) * _count + _count );
+        for ( const auto& sample : *block )
+        {
+            REQUIRE( sample == expected );
+        }
+
+        // input 1: sum of input 0
+        auto sum = inputs.GetValue<float>( 1 );
+        REQUIRE( sum );
+        REQUIRE( *sum == Approx( expected * _blockSize ) );
+
+        ++_count;
+    }
+
+private:
+    const int _blockSize;
+    int _count;
+};
+
+}  // namespace DSPatch
@@ -0,0 +1,81 @@
+/******************************************************************************
+DSPatch - The Refreshingly Simple C++ Dataflow Framework
+Copyright (c) 2025, Marcus Tomlinson
+
+BSD 2-Clause License
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include <chrono>
+
+namespace DSPatch
+{
+
+// An in-order probe holds up its first tick until the out-of-order probe has processed the second
+class DeferralProbe final : public Component
+{
+public:
+    DeferralProbe( ProcessOrder processOrder, std::shared_ptr<std::atomic<bool>> secondTickSeen )
+        : Component( processOrder )
+        , _processOrder( processOrder )
+        , _secondTickSeen( std::move( secondTickSeen ) )
+    {
+    }
+
+    bool WaitedForSecondTick() const
+    {
+        return _waitedForSecondTick;
+    }
+
+protected:
+    void Process_( SignalBus&, SignalBus& ) override
+    {
+        if ( _processOrder == ProcessOrder::OutOfOrder )
+        {
+            if ( GetTickSequence_() == 1 )
+            {
+                *_secondTickSeen = true;
+            }
+        }
+        else if ( GetTickSequence_() == 0 )
+        {
+            const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds( 1 );
+
+            while ( !*_secondTickSeen && std::chrono::steady_clock::now() < timeout )
+            {
+                std::this_thread::yield();
+            }
+
+            _waitedForSecondTick = *_secondTickSeen;
+        }
+    }
+
+private:
+    const ProcessOrder _processOrder;
+    std::shared_ptr<std::atomic<bool>> _secondTickSeen;
+    bool _waitedForSecondTick = false;
+};
+
+}  // namespace DSPatch
@@ -0,0 +1,87 @@
+/******************************************************************************
+DSPatch - The Refreshingly Simple C++ Dataflow Framework
+Copyright (c) 2025, Marcus Tomlinson
+
+BSD 2-Clause License
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+namespace DSPatch
+{
+
+class MultiversionCounter final : public Component
+{
+public:
+    MultiversionCounter()
+        : _count( 0 )
+    {
+        SetOutputCount_( 1 );
+
+        _process.Register( Isa::Scalar, &MultiversionCounter::ProcessScalar )
+            .Register( Isa::AVX2, &MultiversionCounter::ProcessAvx2 )
+            .Register( Isa::AVX512, &MultiversionCounter::ProcessAvx512 );
+    }
+
+    Dispatcher<void ( MultiversionCounter::* )( SignalBus& )>& GetDispatcher()
+    {
+        return _process;
+    }
+
+    Isa GetLastIsa() const
+    {
+        return _lastIsa;
+    }
+
+protected:
+    void Process_( SignalBus&, SignalBus& outputs ) override
+    {
+        ( this->*_process.Get() )( outputs );
+    }
+
+private:
+    void ProcessScalar( SignalBus& outputs )
+    {
+        outputs.SetValue( 0, _count++ );
+        _lastIsa = Isa::Scalar;
+    }
+
+    DSPATCH_TARGET_AVX2 void ProcessAvx2( SignalBus& outputs )
+    {
+        outputs.SetValue( 0, _count++ );
+        _lastIsa = Isa::AVX2;
+    }
+
+    DSPATCH_TARGET_AVX512 void ProcessAvx512( SignalBus& outputs )
+    {
+        outputs.SetValue( 0, _count++ );
+        _lastIsa = Isa::AVX512;
+    }
+
+    Dispatcher<void ( MultiversionCounter::* )( SignalBus& )> _process;
+    Isa _lastIsa = Isa::Scalar;
+    int _count;
+};
+
+}  // namespace DSPatch
@@ -0,0 +1,92 @@
+/******************************************************************************
+DSPatch - The Refreshingly Simple C++ Dataflow Framework
+Copyright (c) 2025, Marcus Tomlinson
+
+BSD 2-Clause License
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+******************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+
+namespace DSPatch
+{
+
+// A gated probe holds up its first tick until its gate is opened, while an ungated probe just counts its ticks
+class ShardProbe final : public Component
+{
+public:
+    class Gate final
+    {
+    public:
+        void Open()
+        {
+            std::lock_guard<std::mutex> lock( _mutex );
+            _open = true;
+            _condt.notify_all();
+        }
+
+        void Wait()
+        {
+            std::unique_lock<std::mutex> lock( _mutex );
+            _condt.wait( lock, [this] { return _open; } );
+        }
+
+    private:
+        std::mutex _mutex;
+        std::condition_variable _condt;
+        bool _open = false;
+    };
+
+    explicit ShardProbe( std::shared_ptr<Gate> gate = nullptr )
+        : _gate( std::move( gate ) )
+    {
+        SetInputCount_( 1 );
+        SetOutputCount_( 1 );
+    }
+
+    int TickCount() const
+    {
+        return _tickCount;
+    }
+
+protected:
+    void Process_( SignalBus&, SignalBus& outputs ) override
+    {
+        if ( _gate && GetTickSequence_() == 0 )
+        {
+            _gate->Wait();
+        }
+
+        outputs.SetValue( 0, 0 );
+        ++_tickCount;
+    }
+
+private:
+    std::shared_ptr<Gate> _gate;
+    std::atomic<int> _tickCount = 0;
+};
+
+}  // namespace DSPatch
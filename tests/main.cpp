@@ -29,28 +29,41 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define CATCH_CONFIG_MAIN
 
 #include <DSPatch.h>
+#include <dspatch/BlockComponents.h>
 
 #include <catch/catch.hpp>
 
 #include "components/Adder.h"
+#include "components/BlockCounter.h"
+#include "components/BlockProbe.h"
 #include "components/BranchSyncProbe.h"
 #include "components/ChangingCounter.h"
 #include "components/ChangingProbe.h"
 #include "components/CircuitCounter.h"
 #include "components/CircuitProbe.h"
+#include "components/ClockProbe.h"
 #include "components/Counter.h"
+#include "components/DeferralProbe.h"
 #include "components/FeedbackProbe.h"
 #include "components/FeedbackTester.h"
 #include "components/Incrementer.h"
+#include "components/MultiversionCounter.h"
 #include "components/NoOutputProbe.h"
 #include "components/NullInputProbe.h"
 #include "components/ParallelProbe.h"
 #include "components/PassThrough.h"
+#include "components/PooledCounter.h"
+#include "components/PooledProbe.h"
+#include "components/SequenceProbe.h"
 #include "components/SerialProbe.h"
+#include "components/ShardProbe.h"
 #include "components/SlowCounter.h"
 #include "components/SporadicCounter.h"
 #include "components/ThreadingProbe.h"
 
+#include <cstdio>
+#include <fstream>
+#include <sstream>
 #include <thread>
 
 using namespace DSPatch;
@@ -355,6 +368,2127 @@ TEST_CASE( "ChangingOutputTest" )
     }
 }
 
+TEST_CASE( "BufferPoolTest" )
+{
+    BufferPool<std::vector<int>> bufferPool;
+
+    REQUIRE( bufferPool.GetSize() == 0 );
+
+    auto buffer1 = bufferPool.Acquire( 16 );
+    auto buffer2 = bufferPool.Acquire( 16 );
+
+    REQUIRE( buffer1->size() == 16 );
+    REQUIRE( buffer1 != buffer2 );
+    REQUIRE( bufferPool.GetSize() == 2 );
+    REQUIRE( bufferPool.GetInUseCount() == 2 );
+    REQUIRE( bufferPool.GetAvailableCount() == 0 );
+    REQUIRE( bufferPool.GetHighWaterCount() == 2 );
+
+    // Release buffer1 and check that it is recycled rather than reallocated
+    auto* recycled = buffer1.get();
+    buffer1.reset();
+
+    REQUIRE( bufferPool.GetAvailableCount() == 1 );
+
+    buffer1 = bufferPool.Acquire( 16 );
+
+    REQUIRE( buffer1.get() == recycled );
+    REQUIRE( bufferPool.GetSize() == 2 );
+
+    buffer1.reset();
+    buffer2.reset();
+    bufferPool.Trim();
+
+    REQUIRE( bufferPool.GetSize() == 0 );
+    REQUIRE( bufferPool.GetHighWaterCount() == 2 );
+
+    // The high water count should only ever rise, as buffers are acquired beyond it
+    std::vector<BufferPool<std::vector<int>>::Buffer> buffers;
+    for ( int i = 0; i < 3; ++i )
+    {
+        buffers.emplace_back( bufferPool.Acquire( 16 ) );
+    }
+    buffers.clear();
+
+    buffer1 = bufferPool.Acquire( 16 );
+
+    REQUIRE( bufferPool.GetSize() == 3 );
+    REQUIRE( bufferPool.GetInUseCount() == 1 );
+    REQUIRE( bufferPool.GetAvailableCount() == 2 );
+    REQUIRE( bufferPool.GetHighWaterCount() == 3 );
+
+    // Buffers should outlive their pool
+    {
+        BufferPool<std::vector<int>> transientPool;
+        buffer2 = transientPool.Acquire( 8 );
+    }
+    REQUIRE( buffer2->size() == 8 );
+
+    buffer1.reset();
+    buffer2.reset();
+
+    // Configure a circuit where a pooled counter fans out to 2 probes
+    auto circuit = std::make_shared<Circuit>();
+
+    auto counter = std::make_shared<PooledCounter>( circuit->GetBufferPool<std::vector<int>>() );
+    auto probe1 = std::make_shared<PooledProbe>();
+    auto probe2 = std::make_shared<PooledProbe>();
+
+    REQUIRE( circuit->GetBufferPool<std::vector<int>>() == circuit->GetBufferPool<std::vector<int>>() );
+
+    circuit->AddComponent( counter );
+    circuit->AddComponent( probe1 );
+    circuit->AddComponent( probe2 );
+
+    circuit->ConnectOutToIn( counter, 0, probe1, 0 );
+    circuit->ConnectOutToIn( counter, 0, probe2, 0 );
+
+    // Tick the circuit 100 times
+    for ( int i = 0; i < 100; ++i )
+    {
+        circuit->Tick();
+    }
+
+    // Buffers should be recycled rather than allocated every tick
+    REQUIRE( circuit->GetBufferPool<std::vector<int>>()->GetHighWaterCount() <= 4 );
+
+    // Tick the circuit 100 times with 3 buffers
+    circuit->SetBufferCount( 3 );
+
+    for ( int i = 0; i < 100; ++i )
+    {
+        circuit->Tick();
+    }
+    circuit->Sync();
+
+    REQUIRE( circuit->GetBufferPool<std::vector<int>>()->GetHighWaterCount() <= 12 );
+}
+
+TEST_CASE( "BlockTest" )
+{
+    Block<float> block( 100 );
+
+    REQUIRE( block.GetCapacity() == 100 );
+    REQUIRE( block.GetSize() == 100 );
+    REQUIRE( (std::uintptr_t)block.GetData() % Block<float>::alignment == 0 );
+
+    block.SetSize( 50 );
+    REQUIRE( block.GetSize() == 50 );
+    block.SetSize( 200 );
+    REQUIRE( block.GetSize() == 100 );
+
+    // Copying into a block of the same capacity should reuse its storage
+    Block<float> copy( 100 );
+    auto* data = copy.GetData();
+    block[0] = 1.0f;
+    copy = block;
+    REQUIRE( copy.GetData() == data );
+    REQUIRE( copy[0] == 1.0f );
+
+    // Verify every kernel implementation supported by this CPU against a scalar reference
+    const int count = 67;
+
+    std::vector<float> a( count ), b( count ), c( count ), out( count ), ref( count );
+    std::vector<std::int16_t> pcm( count ), pcmRef( count );
+    for ( int i = 0; i < count; ++i )
+    {
+        a[i] = (float)( i - 30 ) * 0.031f;
+        b[i] = (float)( 17 - i ) * 0.027f;
+        c[i] = (float)( i % 7 ) * 0.5f;
+        pcm[i] = (std::int16_t)( ( i - 33 ) * 997 );
+    }
+
+    auto checkBinary = [&]( auto kernel, auto fn )
+    {
+        for ( int n = 0; n <= count; ++n )
+        {
+            std::fill( out.begin(), out.end(), 0.0f );
+            kernel( a.data(), b.data(), out.data(), n );
+            for ( int i = 0; i < n; ++i )
+            {
+                REQUIRE( out[i] == fn( a[i], b[i] ) );
+            }
+        }
+    };
+
+    for ( auto isa : { Isa::Scalar, Isa::SSE2, Isa::AVX2, Isa::AVX512 } )
+    {
+        if ( isa > GetHostIsa() )
+        {
+            break;
+        }
+
+        const auto kernels = Kernels::internal::MakeKernelTable( isa );
+
+        checkBinary( kernels.add, []( float x, float y ) { return x + y; } );
+        checkBinary( kernels.multiply, []( float x, float y ) { return x * y; } );
+        checkBinary( kernels.min, []( float x, float y ) { return std::min( x, y ); } );
+        checkBinary( kernels.max, []( float x, float y ) { return std::max( x, y ); } );
+
+        // Check that NaN operands give the same result on each instruction set (b, as minps / maxps)
+        const auto nan = std::numeric_limits<float>::quiet_NaN();
+        std::vector<float> nanA( a ), nanB( b );
+        for ( int i = 0; i < count; i += 3 )
+        {
+            nanA[i] = nan;
+            nanB[( i + 1 ) % count] = nan;
+        }
+
+        for ( auto kernel : { kernels.min, kernels.max } )
+        {
+            kernel( nanA.data(), nanB.data(), out.data(), count );
+            for ( int i = 0; i < count; ++i )
+            {
+                if ( std::isnan( nanB[i] ) )
+                {
+                    REQUIRE( std::isnan( out[i] ) );
+                }
+                else if ( std::isnan( nanA[i] ) )
+                {
+                    REQUIRE( out[i] == nanB[i] );
+                }
+                else
+                {
+                    REQUIRE( out[i] == ( kernel == kernels.min ? std::min( nanA[i], nanB[i] ) : std::max( nanA[i], nanB[i] ) ) );
+                }
+            }
+        }
+
+        kernels.multiplyAdd( a.data(), b.data(), c.data(), out.data(), count );
+        kernels.mix( a.data(), 0.25f, b.data(), 0.75f, ref.data(), count );
+        for ( int i = 0; i < count; ++i )
+        {
+            REQUIRE( out[i] == Approx( a[i] * b[i] + c[i] ) );
+            REQUIRE( ref[i] == Approx( a[i] * 0.25f + b[i] * 0.75f ) );
+        }
+
+        kernels.abs( a.data(), out.data(), count );
+        for ( int i = 0; i < count; ++i )
+        {
+            REQUIRE( out[i] == std::fabs( a[i] ) );
+        }
+
+        REQUIRE( kernels.sum( a.data(), count ) == Approx( Kernels::internal::ReduceScalar<Kernels::internal::AddOp>( a.data(), count ) ) );
+        REQUIRE( kernels.minValue( a.data(), count ) == *std::min_element( a.begin(), a.end() ) );
+        REQUIRE( kernels.maxValue( a.data(), count ) == *std::max_element( a.begin(), a.end() ) );
+        REQUIRE( kernels.sum( a.data(), 0 ) == 0.0f );
+
+        kernels.convertFromInt16( pcm.data(), out.data(), count );
+        kernels.convertToInt16( out.data(), pcmRef.data(), count );
+        for ( int i = 0; i < count; ++i )
+        {
+            REQUIRE( out[i] == pcm[i] / 32768.0f );
+            REQUIRE( pcmRef[i] == pcm[i] );
+        }
+
+        // Check float to int16 saturation
+        std::fill( out.begin(), out.end(), 2.0f );
+        out[1] = -2.0f;
+        kernels.convertToInt16( out.data(), pcmRef.data(), count );
+        REQUIRE( pcmRef[0] == 32767 );
+        REQUIRE( pcmRef[1] == -32768 );
+        REQUIRE( pcmRef[count - 1] == 32767 );
+    }
+
+    // Configure a circuit of block components: ( counter + counter ) * counter + counter -> sum
+    auto circuit = std::make_shared<Circuit>();
+    circuit->SetBlockSize( 37 );
+
+    auto counter = std::make_shared<BlockCounter>();
+    auto add = std::make_shared<BlockAdd>();
+    auto multiplyAdd = std::make_shared<BlockMultiplyAdd>();
+    auto sum = std::make_shared<BlockSum>();
+    auto probe = std::make_shared<BlockProbe>( 37 );
+
+    circuit->AddComponent( counter );
+    circuit->AddComponent( add );
+    circuit->AddComponent( multiplyAdd );
+    circuit->AddComponent( sum );
+    circuit->AddComponent( probe );
+
+    REQUIRE( counter->GetBlockSize() == 37 );
+
+    circuit->ConnectOutToIn( counter, 0, add, 0 );
+    circuit->ConnectOutToIn( counter, 0, add, 1 );
+    circuit->ConnectOutToIn( add, 0, multiplyAdd, 0 );
+    circuit->ConnectOutToIn( counter, 0, multiplyAdd, 1 );
+    circuit->ConnectOutToIn( counter, 0, multiplyAdd, 2 );
+    circuit->ConnectOutToIn( multiplyAdd, 0, sum, 0 );
+    circuit->ConnectOutToIn( multiplyAdd, 0, probe, 0 );
+    circuit->ConnectOutToIn( sum, 0, probe, 1 );
+
+    // Tick the circuit 100 times
+    for ( int i = 0; i < 100; ++i )
+    {
+        circuit->Tick();
+    }
+
+    // Tick the circuit 100 times with 3 buffers
+    circuit->SetBufferCount( 3 );
+
+    for ( int i = 0; i < 100; ++i )
+    {
+        circuit->Tick();
+    }
+    circuit->Sync();
+}
+
+TEST_CASE( "DispatchTest" )
+{
+    REQUIRE( GetIsa() == GetHostIsa() );
+
+    // The best variant supported by this CPU should be selected on construction
+    auto expectedIsa = GetHostIsa() == Isa::SSE2 ? Isa::Scalar : GetHostIsa();
+
+    auto counter = std::make_shared<MultiversionCounter>();
+    REQUIRE( counter->GetDispatcher().GetSelectedIsa() == expectedIsa );
+
+    // Forcing an instruction set should only affect subsequently constructed components
+    ForceIsa( Isa::Scalar );
+    REQUIRE( GetIsa() == Isa::Scalar );
+
+    auto scalarCounter = std::make_shared<MultiversionCounter>();
+    REQUIRE( scalarCounter->GetDispatcher().GetSelectedIsa() == Isa::Scalar );
+    REQUIRE( counter->GetDispatcher().GetSelectedIsa() == expectedIsa );
+
+    // Kernels should follow the forced instruction set from the very next call
+    REQUIRE( Kernels::internal::GetKernelTable().min == Kernels::internal::BinaryScalar<Kernels::internal::MinOp> );
+
+    ResetIsa();
+    REQUIRE( GetIsa() == GetHostIsa() );
+    REQUIRE( Kernels::internal::GetKernelTable().min == Kernels::internal::MakeKernelTable( GetHostIsa() ).min );
+
+    // Variants can be re-selected explicitly, but never beyond what the CPU supports
+    REQUIRE( scalarCounter->GetDispatcher().Select( Isa::AVX2 ) == ( GetHostIsa() >= Isa::AVX2 ) );
+    REQUIRE( scalarCounter->GetDispatcher().Select( Isa::AVX512 ) == ( GetHostIsa() == Isa::AVX512 ) );
+
+    // Configure a circuit and check that the selected variant is the one that runs
+    auto circuit = std::make_shared<Circuit>();
+    auto probe = std::make_shared<ThreadingProbe>( 1 );
+
+    circuit->AddComponent( counter );
+    circuit->AddComponent( probe );
+
+    circuit->ConnectOutToIn( counter, 0, probe, 0 );
+
+    for ( int i = 0; i < 100; ++i )
+    {
+        circuit->Tick();
+    }
+
+    REQUIRE( counter->GetLastIsa() == expectedIsa );
+}
+
+TEST_CASE( "StatsTest", "[instrumentation]" )
+{
+    // Recorded values should be recoverable to within a sub-bucket (12.5%)
+    Histogram histogram;
+
+    for ( uint64_t i = 1; i <= 1000; ++i )
+    {
+        histogram.Record( i );
+    }
+
+    REQUIRE( histogram.GetCount() == 1000 );
+    REQUIRE( histogram.GetMin() == 1 );
+    REQUIRE( histogram.GetMax() == 1000 );
+    REQUIRE( histogram.GetMean() == 500.5 );
+    REQUIRE( histogram.GetPercentile( 50.0 ) >= 500 );
+    REQUIRE( histogram.GetPercentile( 50.0 ) <= 500 * 1.125 );
+    REQUIRE( histogram.GetPercentile( 100.0 ) == 1000 );
+
+    for ( uint64_t value = 1; value < ( (uint64_t)1 << Histogram::maxExponent ); value = value * 3 / 2 + 1 )
+    {
+        const auto upperBound = Histogram::GetBucketUpperBound( Histogram::GetBucket( value ) );
+        REQUIRE( upperBound >= value );
+        REQUIRE( (double)upperBound <= (double)value * 1.125 );
+    }
+
+    Histogram other;
+    other.Record( 5000 );
+    histogram.Merge( other );
+
+    REQUIRE( histogram.GetCount() == 1001 );
+    REQUIRE( histogram.GetMax() == 5000 );
+
+    // Configure a circuit and check that each tick is recorded once per component
+    auto circuit = std::make_shared<Circuit>();
+
+    auto counter = std::make_shared<SlowCounter>();
+    auto passThrough = std::make_shared<PassThrough>();
+
+    circuit->AddComponent( counter );
+    circuit->AddComponent( passThrough );
+
+    circuit->ConnectOutToIn( counter, 0, passThrough, 0 );
+
+    for ( int bufferCount : { 0, 3 } )
+    {
+        for ( int threadCount : { 0, 2 } )
+        {
+            circuit->SetBufferCount( bufferCount );
+            circuit->SetThreadCount( threadCount );
+            circuit->ResetStats();
+
+            for ( int i = 0; i < 20; ++i )
+            {
+                circuit->Tick();
+            }
+            circuit->Sync();
+
+            auto stats = circuit->GetStats();
+
+#ifdef DSPATCH_ENABLE_STATS
+            REQUIRE( stats.enabled );
+
+            // Each thread records its share of each tick
+            REQUIRE( stats.tickTime.GetCount() == (uint64_t)( 20 * std::max( threadCount, 1 ) ) );
+
+            REQUIRE( stats.components.size() == 2 );
+            REQUIRE( stats.components[0].component == counter.get() );
+            REQUIRE( stats.components[1].component == passThrough.get() );
+
+            for ( const auto& componentStats : stats.components )
+            {
+                REQUIRE( componentStats.gatherTime.GetCount() == 20 );
+                REQUIRE( componentStats.waitTime.GetCount() == 20 );
+                REQUIRE( componentStats.processTime.GetCount() == 20 );
+
+                // Each buffer records its waits for its turn to process
+                REQUIRE( componentStats.releaseWaitTimes.size() == (size_t)std::max( bufferCount, 1 ) );
+            }
+
+            // Only in-order components (SlowCounter, not PassThrough) wait their turn, and only when multi-buffered
+            for ( size_t i = 0; i < stats.components.size(); ++i )
+            {
+                uint64_t releaseWaitCount = 0;
+                for ( const auto& releaseWaitTime : stats.components[i].releaseWaitTimes )
+                {
+                    releaseWaitCount += releaseWaitTime.GetCount();
+                }
+                REQUIRE( releaseWaitCount == ( i == 0 && bufferCount != 0 ? 20u : 0u ) );
+            }
+
+            // SlowCounter waits ~1ms per tick (except the first)
+            REQUIRE( stats.components[0].processTime.GetPercentile( 50.0 ) >= 900000 );
+            REQUIRE( stats.tickTime.GetMax() >= 900000 );
+#else
+            REQUIRE( !stats.enabled );
+            REQUIRE( stats.tickTime.GetCount() == 0 );
+            REQUIRE( stats.components.empty() );
+#endif
+        }
+    }
+}
+
+TEST_CASE( "TrafficStatsTest", "[instrumentation]" )
+{
+    SetSignalSizeHook<int>( []( const int& ) { return sizeof( int ); } );
+
+    // Configure a circuit with a counter fanned out to 3 consumers, and an unconnected pass-through feeding a 4th
+    auto circuit = std::make_shared<Circuit>();
+
+    auto counter = std::make_shared<Counter>();
+    auto passThrough1 = std::make_shared<PassThrough>();
+    auto passThrough2 = std::make_shared<PassThrough>();
+    auto passThrough3 = std::make_shared<PassThrough>();
+    auto nullSource = std::make_shared<PassThrough>();
+    auto nullSink = std::make_shared<PassThrough>();
+
+    circuit->AddComponent( counter );
+    circuit->AddComponent( passThrough1 );
+    circuit->AddComponent( passThrough2 );
+    circuit->AddComponent( passThrough3 );
+    circuit->AddComponent( nullSource );
+    circuit->AddComponent( nullSink );
+
+    circuit->ConnectOutToIn( counter, 0, passThrough1, 0 );
+    circuit->ConnectOutToIn( counter, 0, passThrough2, 0 );
+    circuit->ConnectOutToIn( counter, 0, passThrough3, 0 );
+    circuit->ConnectOutToIn( nullSource, 0, nullSink, 0 );
+
+    for ( int bufferCount : { 0, 3 } )
+    {
+        for ( int threadCount : { 0, 2 } )
+        {
+            circuit->SetBufferCount( bufferCount );
+            circuit->SetThreadCount( threadCount );
+            circuit->ResetStats();
+
+            for ( int i = 0; i < 30; ++i )
+            {
+                circuit->Tick();
+            }
+            circuit->Sync();
+
+            auto stats = circuit->GetStats();
+
+#ifdef DSPATCH_ENABLE_STATS
+            uint64_t moves = 0, copies = 0, bytesCopied = 0;
+
+            for ( const auto& componentStats : stats.components )
+            {
+                if ( componentStats.component == counter.get() )
+                {
+                    REQUIRE( componentStats.inputs.size() == 0 );
+                    continue;
+                }
+
+                REQUIRE( componentStats.inputs.size() == 1 );
+
+                const auto& wireStats = componentStats.inputs[0];
+                REQUIRE( wireStats.toInput == 0 );
+
+                if ( componentStats.component == nullSource.get() )
+                {
+                    // Unconnected inputs gather nothing
+                    REQUIRE( wireStats.fromComponent == nullptr );
+                    REQUIRE( wireStats.moves + wireStats.copies + wireStats.nulls == 0 );
+                    continue;
+                }
+
+                REQUIRE( wireStats.fromOutput == 0 );
+
+                if ( componentStats.component == nullSink.get() )
+                {
+                    // The unconnected pass-through never outputs a value
+                    REQUIRE( wireStats.fromComponent == nullSource.get() );
+                    REQUIRE( wireStats.nulls == 30 );
+                    REQUIRE( wireStats.moves + wireStats.copies == 0 );
+                    continue;
+                }
+
+                REQUIRE( wireStats.fromComponent == counter.get() );
+                REQUIRE( wireStats.nulls == 0 );
+                REQUIRE( wireStats.moves + wireStats.copies == 30 );
+                REQUIRE( wireStats.bytesCopied == wireStats.copies * sizeof( int ) );
+
+                moves += wireStats.moves;
+                copies += wireStats.copies;
+                bytesCopied += wireStats.bytesCopied;
+            }
+
+            // Each tick, the counter's output is copied to 2 of its consumers, and moved to the last
+            REQUIRE( moves == 30 );
+            REQUIRE( copies == 60 );
+            REQUIRE( bytesCopied == 60 * sizeof( int ) );
+#else
+            REQUIRE( stats.components.empty() );
+#endif
+        }
+    }
+
+    // The DOT export should contain every component and wire, highlighting the copying wires
+    std::stringstream dot;
+    circuit->ExportDot( dot );
+
+    const auto dotString = dot.str();
+    REQUIRE( dotString.find( "digraph DSPatch" ) == 0 );
+    REQUIRE( dotString.find( "DSPatch::Counter" ) != std::string::npos );
+    REQUIRE( std::count( dotString.begin(), dotString.end(), '>' ) == 8 );
+
+#ifdef DSPATCH_ENABLE_STATS
+    REQUIRE( dotString.find( "copies: " ) != std::string::npos );
+    REQUIRE( dotString.find( "color=\"red\"" ) != std::string::npos );
+#else
+    REQUIRE( dotString.find( "copies: " ) == std::string::npos );
+#endif
+}
+
+TEST_CASE( "TraceTest", "[instrumentation]" )
+{
+    auto countOf = []( const std::string& str, const std::string& substr ) {
+        int count = 0;
+        for ( auto pos = str.find( substr ); pos != std::string::npos; pos = str.find( substr, pos + 1 ) )
+        {
+            ++count;
+        }
+        return count;
+    };
+
+    auto circuit = std::make_shared<Circuit>();
+
+    auto counter = std::make_shared<Counter>();
+    auto passThrough = std::make_shared<PassThrough>();
+
+    circuit->AddComponent( counter );
+    circuit->AddComponent( passThrough );
+
+    circuit->ConnectOutToIn( counter, 0, passThrough, 0 );
+
+    circuit->SetBufferCount( 2 );
+
+    ClearTrace();
+    StartTrace();
+
+    for ( int i = 0; i < 10; ++i )
+    {
+        circuit->Tick();
+    }
+    circuit->Sync();
+
+    StopTrace();
+
+    // Ticks while not tracing should not be recorded
+    circuit->Tick();
+    circuit->Sync();
+
+    std::stringstream trace;
+    ExportTrace( trace );
+
+    REQUIRE( trace.str().rfind( "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0 ) == 0 );
+    REQUIRE( trace.str().find( "]}\n" ) == trace.str().size() - 3 );
+
+#ifdef DSPATCH_ENABLE_TRACE
+    REQUIRE( countOf( trace.str(), "\"name\":\"DSPatch::Counter\",\"cat\":\"Tick\"" ) == 10 );
+    REQUIRE( countOf( trace.str(), "\"name\":\"DSPatch::PassThrough\",\"cat\":\"Tick\"" ) == 10 );
+    REQUIRE( countOf( trace.str(), "\"name\":\"Process_\"" ) == 20 );
+    REQUIRE( countOf( trace.str(), "\"args\":{\"name\":\"CircuitThread 0\"}" ) == 1 );
+    REQUIRE( countOf( trace.str(), "\"args\":{\"name\":\"CircuitThread 1\"}" ) == 1 );
+    REQUIRE( countOf( trace.str(), "\"name\":\"Resume\"" ) == 10 );
+    REQUIRE( countOf( trace.str(), "\"name\":\"Sync\"" ) >= 10 );
+#else
+    REQUIRE( countOf( trace.str(), "\"name\"" ) == 0 );
+#endif
+
+    // Clearing the trace should drop all recorded events
+    ClearTrace();
+
+    trace.str( "" );
+    ExportTrace( trace );
+
+    REQUIRE( countOf( trace.str(), "\"cat\":\"Tick\"" ) == 0 );
+}
+
+TEST_CASE( "LatencyStatsTest" )
+{
+    // Configure a circuit with a slow (~1ms) component
+    auto circuit = std::make_shared<Circuit>();
+
+    auto counter = std::make_shared<SlowCounter>();
+    auto passThrough = std::make_shared<PassThrough>();
+
+    circuit->AddComponent( counter );
+    circuit->AddComponent( passThrough );
+
+    circuit->ConnectOutToIn( counter, 0, passThrough, 0 );
+
+    // Latency should not be recorded until enabled
+    circuit->Tick();
+    REQUIRE( !circuit->GetLatencyStatsEnabled() );
+    REQUIRE( !circuit->GetLatencyStats().enabled );
+    REQUIRE( circuit->GetLatencyStats().completionTime.GetCount() == 0 );
+
+    circuit->SetLatencyStatsEnabled( true );
+    REQUIRE( circuit->GetLatencyStatsEnabled() );
+
+    for ( int bufferCount : { 0, 3 } )
+    {
+        for ( int threadCount : { 0, 2 } )
+        {
+            circuit->SetBufferCount( bufferCount );
+            circuit->SetThreadCount( threadCount );
+            circuit->ResetLatencyStats();
+
+            for ( int i = 0; i < 21; ++i )
+            {
+                circuit->Tick();
+            }
+            circuit->Sync();
+
+            auto stats = circuit->GetLatencyStats();
+
+            // Every tick should be recorded once, against its buffer
+            REQUIRE( stats.enabled );
+            REQUIRE( stats.queueTime.GetCount() == 21 );
+            REQUIRE( stats.completionTime.GetCount() == 21 );
+            REQUIRE( stats.bufferCompletionTimes.size() == (size_t)std::max( bufferCount, 1 ) );
+
+            for ( const auto& bufferCompletionTime : stats.bufferCompletionTimes )
+            {
+                REQUIRE( bufferCompletionTime.GetCount() == (uint64_t)( 21 / std::max( bufferCount, 1 ) ) );
+            }
+
+            // A buffer can't complete before the slow counter has processed it, nor before it was picked up
+            REQUIRE( stats.completionTime.GetPercentile( 50.0 ) >= 900000 );
+            REQUIRE( stats.completionTime.GetMax() >= stats.queueTime.GetMax() );
+
+            if ( bufferCount == 0 && threadCount == 0 )
+            {
+                REQUIRE( stats.queueTime.GetMax() == 0 );
+            }
+        }
+    }
+
+    // Disabling should stop recording
+    circuit->SetLatencyStatsEnabled( false );
+    circuit->ResetLatencyStats();
+
+    circuit->Tick();
+    circuit->Sync();
+
+    REQUIRE( circuit->GetLatencyStats().completionTime.GetCount() == 0 );
+}
+
+TEST_CASE( "FlightRecorderTest" )
+{
+    // Configure a circuit with a slow (~1ms) component
+    auto circuit = std::make_shared<Circuit>();
+
+    auto counter = std::make_shared<SlowCounter>();
+    auto passThrough = std::make_shared<PassThrough>();
+
+    circuit->AddComponent( counter );
+    circuit->AddComponent( passThrough );
+
+    circuit->ConnectOutToIn( counter, 0, passThrough, 0 );
+
+    // Nothing should be recorded until enabled
+    circuit->Tick();
+    REQUIRE( !circuit->GetFlightRecorderEnabled() );
+    REQUIRE( circuit->GetFlightRecord().empty() );
+
+    for ( int bufferCount : { 0, 3 } )
+    {
+        for ( int threadCount : { 0, 2 } )
+        {
+            circuit->SetBufferCount( bufferCount );
+            circuit->SetThreadCount( threadCount );
+
+            // (Re-)enabling should start from empty rings
+            circuit->SetFlightRecorderEnabled( true );
+            REQUIRE( circuit->GetFlightRecorderEnabled() );
+
+            for ( int i = 0; i < 6; ++i )
+            {
+                circuit->Tick();
+            }
+            circuit->Sync();
+
+            auto records = circuit->GetFlightRecord();
+
+            // Every component execution should be recorded, in order of start time
+            REQUIRE( records.size() == 12 );
+
+            for ( size_t i = 0; i < records.size(); ++i )
+            {
+                const auto& record = records[i];
+
+                REQUIRE( ( record.component == counter.get() || record.component == passThrough.get() ) );
+                REQUIRE( record.componentIndex == ( record.component == counter.get() ? 0 : 1 ) );
+                REQUIRE( record.bufferNo < std::max( bufferCount, 1 ) );
+                REQUIRE( record.endTime >= record.startTime );
+
+                if ( i != 0 )
+                {
+                    REQUIRE( record.startTime >= records[i - 1].startTime );
+                }
+
+                if ( bufferCount == 0 && threadCount == 0 )
+                {
+                    REQUIRE( record.threadNo == -1 );
+                }
+                else
+                {
+                    REQUIRE( record.threadNo < std::max( threadCount, 1 ) );
+                }
+            }
+        }
+    }
+
+    // Dump on demand
+    std::stringstream dump;
+    circuit->DumpFlightRecord( dump );
+
+    auto read = [&dump]( auto value ) {
+        dump.read( reinterpret_cast<char*>( &value ), sizeof( value ) );
+        return value;
+    };
+
+    char magic[8];
+    dump.read( magic, 8 );
+    REQUIRE( std::string( magic, 8 ) == "DSPFLTR1" );
+
+    REQUIRE( read( uint64_t() ) == 0 );
+    REQUIRE( read( uint64_t() ) == 0 );
+    REQUIRE( read( int32_t() ) == -1 );
+
+    REQUIRE( read( uint32_t() ) == 2 );
+    for ( std::string expected : { "DSPatch::SlowCounter", "DSPatch::PassThrough" } )
+    {
+        std::string name( read( uint32_t() ), '\0' );
+        dump.read( name.data(), (std::streamsize)name.size() );
+        REQUIRE( name == expected );
+    }
+
+    const auto recordCount = read( uint32_t() );
+    REQUIRE( recordCount == circuit->GetFlightRecord().size() );
+
+    for ( uint32_t i = 0; i < recordCount; ++i )
+    {
+        REQUIRE( read( int32_t() ) != -1 );
+        REQUIRE( read( int32_t() ) >= 0 );
+        read( int32_t() );
+
+        const auto startTime = read( uint64_t() );
+        const auto endTime = read( uint64_t() );
+        REQUIRE( endTime >= startTime );
+    }
+
+    REQUIRE( dump.peek() == std::char_traits<char>::eof() );
+
+    // Ticks slower than the trigger threshold should dump to file, once per ring's worth of ticks
+    const std::string filePath = "FlightRecorderTest.bin";
+
+    circuit->SetBufferCount( 0 );
+    circuit->SetThreadCount( 0 );
+    circuit->SetFlightRecorderTrigger( 100000000, filePath );
+
+    circuit->Tick();
+    REQUIRE( circuit->GetFlightRecorderDumpCount() == 0 );
+
+    circuit->SetFlightRecorderTrigger( 100000, filePath );
+
+    for ( int i = 0; i < 3; ++i )
+    {
+        circuit->Tick();
+    }
+    REQUIRE( circuit->GetFlightRecorderDumpCount() == 1 );
+
+    std::ifstream file( filePath, std::ios::binary );
+    REQUIRE( file );
+
+    file.read( magic, 8 );
+    REQUIRE( std::string( magic, 8 ) == "DSPFLTR1" );
+
+    uint64_t threshold, tickTime;
+    file.read( reinterpret_cast<char*>( &threshold ), sizeof( threshold ) );
+    file.read( reinterpret_cast<char*>( &tickTime ), sizeof( tickTime ) );
+    REQUIRE( threshold == 100000 );
+    REQUIRE( tickTime > threshold );
+
+    file.close();
+    std::remove( filePath.c_str() );
+
+    // Disabling should free the rings
+    circuit->SetFlightRecorderEnabled( false );
+    circuit->Tick();
+
+    REQUIRE( circuit->GetFlightRecord().empty() );
+}
+
+TEST_CASE( "GraphExportTest" )
+{
+    // Configure a circuit with a short (1 wire) and a long (2 wire) branch
+    auto circuit = std::make_shared<Circuit>();
+
+    auto counter = std::make_shared<BlockCounter>();
+    auto abs = std::make_shared<BlockAbs>();
+    auto add = std::make_shared<BlockAdd>();
+
+    circuit->AddComponent( add );
+    circuit->AddComponent( abs );
+    circuit->AddComponent( counter );
+
+    circuit->ConnectOutToIn( counter, 0, add, 0 );
+    circuit->ConnectOutToIn( counter, 0, abs, 0 );
+    circuit->ConnectOutToIn( abs, 0, add, 1 );
+
+    circuit->SetThreadCount( 2 );
+
+    for ( int i = 0; i < 10; ++i )
+    {
+        circuit->Tick();
+    }
+    circuit->Sync();
+
+    // The DOT export should name ports, and mark the long branch as the critical path
+    std::stringstream dot;
+    circuit->ExportDot( dot );
+
+    const auto dotString = dot.str();
+    REQUIRE( dotString.find( "digraph DSPatch" ) == 0 );
+    REQUIRE( dotString.find( "c0 [label=\"0: DSPatch::BlockCounter\\nlevel: 0, thread: " ) != std::string::npos );
+    REQUIRE( dotString.find( "c1 [label=\"1: DSPatch::BlockAbs\\nlevel: 1, thread: " ) != std::string::npos );
+    REQUIRE( dotString.find( "c2 [label=\"2: DSPatch::BlockAdd\\nlevel: 2, thread: " ) != std::string::npos );
+    REQUIRE( dotString.find( "c0 -> c2 [label=\"0 -> in0" ) != std::string::npos );
+    REQUIRE( dotString.find( "c1 -> c2 [label=\"out -> in1" ) != std::string::npos );
+
+    // The JSON export should carry the same graph
+    std::stringstream json;
+    circuit->ExportJson( json );
+
+    const auto jsonString = json.str();
+    REQUIRE( jsonString.find( "\"threadCount\":2" ) != std::string::npos );
+    REQUIRE( jsonString.find( "{\"id\":2,\"type\":\"DSPatch::BlockAdd\",\"inputs\":[\"in0\",\"in1\"],\"outputs\":[\"out\"],"
+                              "\"level\":2" ) != std::string::npos );
+    REQUIRE( jsonString.find( "{\"from\":0,\"fromOutput\":0,\"to\":2,\"toInput\":0,\"feedback\":false,\"critical\":false" ) !=
+             std::string::npos );
+    REQUIRE( jsonString.find( "{\"from\":1,\"fromOutput\":0,\"to\":2,\"toInput\":1,\"feedback\":false,\"critical\":true" ) !=
+             std::string::npos );
+
+    size_t criticalCount = 0;
+    for ( auto pos = jsonString.find( "\"critical\":true" ); pos != std::string::npos;
+          pos = jsonString.find( "\"critical\":true", pos + 1 ) )
+    {
+        ++criticalCount;
+    }
+    REQUIRE( criticalCount == 5 );  // 3 components, 2 wires
+
+    // Every component should be assigned one of the 2 threads
+    for ( int i = 0; i < 3; ++i )
+    {
+        const auto pos = jsonString.find( "\"id\":" + std::to_string( i ) + "," );
+        const auto thread = jsonString.find( "\"thread\":", pos );
+        REQUIRE( ( jsonString[thread + 9] == '0' || jsonString[thread + 9] == '1' ) );
+    }
+
+#ifdef DSPATCH_ENABLE_STATS
+    REQUIRE( jsonString.find( "\"stats\":true" ) == 1 );
+    REQUIRE( jsonString.find( "\"processTime\":{\"count\":10," ) != std::string::npos );
+    REQUIRE( jsonString.find( "\"copies\":10" ) != std::string::npos );
+#else
+    REQUIRE( jsonString.find( "\"stats\":false" ) == 1 );
+    REQUIRE( jsonString.find( "\"processTime\"" ) == std::string::npos );
+#endif
+
+    // Exporting shouldn't disturb a circuit re-optimizing on its auto-tick thread
+    circuit->StartAutoTick();
+
+    for ( int i = 0; i < 100; ++i )
+    {
+        circuit->ConnectOutToIn( i % 2 == 0 ? Component::SPtr( counter ) : abs, 0, add, 1 );
+
+        std::stringstream rewiredDot;
+        circuit->ExportDot( rewiredDot );
+
+        const auto addLevel = std::string( "DSPatch::BlockAdd\\nlevel: " ) + ( i % 2 == 0 ? "1" : "2" );
+        REQUIRE( rewiredDot.str().find( addLevel ) != std::string::npos );
+    }
+
+    circuit->StopAutoTick();
+}
+
+TEST_CASE( "TopologySerializationTest" )
+{
+    // Configure a circuit with a parallel branch
+    auto circuit = std::make_shared<Circuit>();
+
+    auto counter = std::make_shared<Counter>();
+    auto incrementer = std::make_shared<Incrementer>();
+    auto adder = std::make_shared<Adder>();
+
+    circuit->AddComponent( adder );
+    circuit->AddComponent( incrementer );
+    circuit->AddComponent( counter );
+
+    circuit->ConnectOutToIn( counter, 0, incrementer, 0 );
+    circuit->ConnectOutToIn( incrementer, 0, adder, 0 );
+    circuit->ConnectOutToIn( counter, 0, adder, 1 );
+
+    circuit->SetBufferCount( 2 );
+    circuit->SetThreadCount( 2 );
+    circuit->SetBlockSize( 64 );
+
+    circuit->Tick();
+    circuit->Sync();
+
+    std::stringstream topology;
+    circuit->SaveTopology( topology );
+
+    // Components should be saved in processing order
+    std::stringstream json;
+    circuit->SaveTopologyJson( json );
+
+    REQUIRE( json.str() ==
+             "{\"bufferCount\":2,\"threadCount\":2,\"blockSize\":64,\"components\":[\"DSPatch::Counter\","
+             "\"DSPatch::Incrementer\",\"DSPatch::Adder\"],\"parallelOrder\":[0,1,2],\"wires\":[{\"from\":0,\"fromOutput\":0,"
+             "\"to\":1,\"toInput\":0},{\"from\":1,\"fromOutput\":0,\"to\":2,\"toInput\":0},{\"from\":0,\"fromOutput\":0,\"to\":2,"
+             "\"toInput\":1}]}\n" );
+
+    ComponentFactory factory;
+    factory.Register<Counter>();
+    factory.Register<Incrementer>();
+    factory.Register<Adder>();
+
+    REQUIRE( factory.IsRegistered( "DSPatch::Counter" ) );
+    REQUIRE( !factory.IsRegistered( "DSPatch::PassThrough" ) );
+
+    // Load the topology into a circuit with existing contents
+    auto loadedCircuit = std::make_shared<Circuit>();
+    loadedCircuit->AddComponent( std::make_shared<PassThrough>() );
+
+    std::vector<Component::SPtr> components;
+    REQUIRE( loadedCircuit->LoadTopology( topology, factory, components ) );
+
+    REQUIRE( components.size() == 3 );
+    REQUIRE( loadedCircuit->GetComponentCount() == 3 );
+    REQUIRE( loadedCircuit->GetBufferCount() == 2 );
+    REQUIRE( loadedCircuit->GetThreadCount() == 2 );
+    REQUIRE( loadedCircuit->GetBlockSize() == 64 );
+
+    const Component* fromComponent = nullptr;
+    int fromOutput = -1;
+    REQUIRE( components[2]->GetInputWire( 1, fromComponent, fromOutput ) );
+    REQUIRE( fromComponent == components[0].get() );
+    REQUIRE( fromOutput == 0 );
+
+    // Saving the loaded circuit should reproduce the same topology
+    std::stringstream resaved;
+    loadedCircuit->SaveTopology( resaved );
+    REQUIRE( resaved.str() == topology.str() );
+
+    // The loaded circuit should tick
+    auto loadedCounter = std::dynamic_pointer_cast<Counter>( components[0] );
+    REQUIRE( loadedCounter != nullptr );
+
+    for ( int i = 0; i < 10; ++i )
+    {
+        loadedCircuit->Tick();
+    }
+    loadedCircuit->Sync();
+
+    REQUIRE( loadedCounter->Count() == 10 );
+
+    // A topology with an unregistered type (or that is truncated) shouldn't load, leaving the circuit untouched
+    ComponentFactory partialFactory;
+    partialFactory.Register<Counter>();
+    partialFactory.Register<Incrementer>();
+
+    std::stringstream unknownType( topology.str() );
+    std::vector<Component::SPtr> unloadedComponents;
+    REQUIRE( !loadedCircuit->LoadTopology( unknownType, partialFactory, unloadedComponents ) );
+
+    const auto truncated = topology.str().substr( 0, topology.str().size() - 4 );
+    std::stringstream truncatedType( truncated );
+    REQUIRE( !loadedCircuit->LoadTopology( truncatedType, factory, unloadedComponents ) );
+
+    // As shouldn't one with corrupt counts or block size (without trying to allocate for them)
+    auto corrupt = []( int32_t blockSize, uint32_t componentCount, uint32_t typeIdSize, uint32_t wireCount ) {
+        std::stringstream stream;
+        auto write = [&stream]( const auto& value ) { stream.write( reinterpret_cast<const char*>( &value ), sizeof( value ) ); };
+
+        stream.write( "DSPTOPO1", 8 );
+        write( (int32_t)0 );
+        write( (int32_t)0 );
+        write( blockSize );
+        write( componentCount );
+        if ( componentCount != 0 )
+        {
+            write( typeIdSize );
+        }
+        else
+        {
+            write( wireCount );
+        }
+        return stream;
+    };
+
+    auto corruptStream = corrupt( 256, 0xFFFFFFFF, 0xFFFFFFFF, 0 );
+    REQUIRE( !loadedCircuit->LoadTopology( corruptStream, factory, unloadedComponents ) );
+    corruptStream = corrupt( 256, 0xFFFFFFFF, 7, 0 );
+    REQUIRE( !loadedCircuit->LoadTopology( corruptStream, factory, unloadedComponents ) );
+    corruptStream = corrupt( 256, 0, 0, 0xFFFFFFFF );
+    REQUIRE( !loadedCircuit->LoadTopology( corruptStream, factory, unloadedComponents ) );
+    corruptStream = corrupt( 0, 0, 0, 0 );
+    REQUIRE( !loadedCircuit->LoadTopology( corruptStream, factory, unloadedComponents ) );
+
+    REQUIRE( unloadedComponents.empty() );
+    REQUIRE( loadedCircuit->GetComponentCount() == 3 );
+
+    loadedCircuit->Tick();
+    loadedCircuit->Sync();
+
+    REQUIRE( loadedCounter->Count() == 11 );
+}
+
+TEST_CASE( "EditTransactionTest" )
+{
+    auto circuit = std::make_shared<Circuit>();
+
+    auto counter = std::make_shared<Counter>();
+    circuit->AddComponent( counter );
+
+    auto probe = std::make_shared<PassThrough>();
+    circuit->AddComponent( probe );
+    circuit->ConnectOutToIn( counter, 0, probe, 0 );
+
+    circuit->SetBufferCount( 2 );
+    circuit->StartAutoTick();
+
+    // Build a chain of incrementers between the counter and probe in a single edit
+    circuit->BeginEdit();
+
+    std::vector<Component::SPtr> incrementers;
+    Component::SPtr previous = counter;
+
+    for ( int i = 0; i < 100; ++i )
+    {
+        auto incrementer = std::make_shared<Incrementer>();
+        REQUIRE( circuit->AddComponent( incrementer ) );
+        REQUIRE( circuit->ConnectOutToIn( previous, 0, incrementer, 0 ) );
+        incrementers.emplace_back( incrementer );
+        previous = incrementer;
+    }
+
+    REQUIRE( circuit->ConnectOutToIn( previous, 0, probe, 0 ) );
+
+    // Nested edits should be applied by the outermost Commit()
+    circuit->BeginEdit();
+    REQUIRE( circuit->RemoveComponent( incrementers[50] ) );
+    REQUIRE( circuit->ConnectOutToIn( incrementers[49], 0, incrementers[51], 0 ) );
+    REQUIRE( circuit->Commit() );
+
+    // Nothing should be applied until Commit()
+    REQUIRE( circuit->GetComponentCount() == 2 );
+
+    REQUIRE( circuit->Commit() );
+
+    REQUIRE( circuit->GetComponentCount() == 101 );
+
+    const Component* fromComponent = nullptr;
+    int fromOutput = -1;
+    REQUIRE( probe->GetInputWire( 0, fromComponent, fromOutput ) );
+    REQUIRE( fromComponent == incrementers.back().get() );
+    REQUIRE( incrementers[51]->GetInputWire( 0, fromComponent, fromOutput ) );
+    REQUIRE( fromComponent == incrementers[49].get() );
+    REQUIRE( !incrementers[50]->GetInputWire( 0, fromComponent, fromOutput ) );
+
+    // An invalid edit should discard the whole edit, leaving the circuit untouched
+    auto orphan = std::make_shared<Incrementer>();
+
+    circuit->BeginEdit();
+    REQUIRE( circuit->DisconnectComponent( incrementers[0] ) );
+    REQUIRE( circuit->ConnectOutToIn( orphan, 0, probe, 0 ) );  // orphan isn't in the circuit
+    REQUIRE( !circuit->Commit() );
+
+    REQUIRE( circuit->GetComponentCount() == 101 );
+    REQUIRE( incrementers[0]->GetInputWire( 0, fromComponent, fromOutput ) );
+    REQUIRE( fromComponent == counter.get() );
+
+    // Components removed earlier in an edit can't be connected later in it
+    circuit->BeginEdit();
+    REQUIRE( circuit->RemoveComponent( incrementers[0] ) );
+    REQUIRE( circuit->ConnectOutToIn( counter, 0, incrementers[0], 0 ) );
+    REQUIRE( !circuit->Commit() );
+
+    REQUIRE( circuit->GetComponentCount() == 101 );
+
+    // Commit() without BeginEdit() should fail
+    REQUIRE( !circuit->Commit() );
+
+    circuit->StopAutoTick();
+
+    // The committed circuit should tick
+    auto lastCount = counter->Count();
+    circuit->Tick();
+    circuit->Tick();
+    circuit->Sync();
+
+    REQUIRE( counter->Count() == lastCount + 2 );
+}
+
+TEST_CASE( "RemoveComponentTest" )
+{
+    auto circuit = std::make_shared<Circuit>();
+
+    // A counter fanning out to 3 chains of 2 incrementers
+    auto counter = std::make_shared<Counter>();
+    circuit->AddComponent( counter );
+
+    std::vector<Component::SPtr> heads, tails;
+    for ( int i = 0; i < 3; ++i )
+    {
+        heads.emplace_back( std::make_shared<Incrementer>() );
+        tails.emplace_back( std::make_shared<Incrementer>() );
+
+        circuit->AddComponent( heads.back() );
+        circuit->AddComponent( tails.back() );
+
+        circuit->ConnectOutToIn( counter, 0, heads.back(), 0 );
+        circuit->ConnectOutToIn( heads.back(), 0, tails.back(), 0 );
+    }
+
+    circuit->SetThreadCount( 2 );
+    circuit->Tick();
+
+    const Component* fromComponent = nullptr;
+    int fromOutput = -1;
+
+    // Removing a head should disconnect it from both the counter and its tail
+    REQUIRE( circuit->RemoveComponent( heads[1] ) );
+    REQUIRE( !circuit->RemoveComponent( heads[1] ) );
+    REQUIRE( circuit->GetComponentCount() == 6 );
+
+    REQUIRE( !heads[1]->GetInputWire( 0, fromComponent, fromOutput ) );
+    REQUIRE( !tails[1]->GetInputWire( 0, fromComponent, fromOutput ) );
+
+    REQUIRE( heads[0]->GetInputWire( 0, fromComponent, fromOutput ) );
+    REQUIRE( fromComponent == counter.get() );
+    REQUIRE( heads[2]->GetInputWire( 0, fromComponent, fromOutput ) );
+    REQUIRE( fromComponent == counter.get() );
+    REQUIRE( tails[2]->GetInputWire( 0, fromComponent, fromOutput ) );
+    REQUIRE( fromComponent == heads[2].get() );
+
+    // Disconnecting the counter should disconnect all of its consumers
+    REQUIRE( circuit->DisconnectComponent( counter ) );
+
+    for ( const auto& head : heads )
+    {
+        REQUIRE( !head->GetInputWire( 0, fromComponent, fromOutput ) );
+    }
+    REQUIRE( tails[0]->GetInputWire( 0, fromComponent, fromOutput ) );
+    REQUIRE( fromComponent == heads[0].get() );
+
+    // Removed components can be added again, and the circuit should still tick
+    REQUIRE( circuit->AddComponent( heads[1] ) );
+    REQUIRE( circuit->ConnectOutToIn( counter, 0, heads[1], 0 ) );
+    REQUIRE( circuit->RemoveComponent( counter ) );
+    REQUIRE( circuit->GetComponentCount() == 6 );
+
+    circuit->Tick();
+    circuit->Sync();
+
+    std::stringstream topology;
+    circuit->SaveTopologyJson( topology );
+    REQUIRE( topology.str().find( "\"parallelOrder\":[" ) != std::string::npos );
+    REQUIRE( topology.str().find( "\"wires\":[{" ) != std::string::npos );
+}
+
+TEST_CASE( "ComponentIdTest" )
+{
+    auto circuit = std::make_shared<Circuit>();
+
+    auto counter = std::make_shared<Counter>();
+    auto incrementer = std::make_shared<Incrementer>();
+    auto passThrough = std::make_shared<PassThrough>();
+
+    ComponentId counterId, incrementerId, passThroughId;
+    REQUIRE( circuit->AddComponent( counter, counterId ) );
+    REQUIRE( circuit->AddComponent( incrementer, incrementerId ) );
+    REQUIRE( circuit->AddComponent( passThrough, passThroughId ) );
+    REQUIRE( !circuit->AddComponent( counter, counterId ) );
+    REQUIRE( counterId == ComponentId() );
+
+    counterId = circuit->GetComponentId( counter );
+    REQUIRE( counterId != ComponentId() );
+    REQUIRE( counterId != incrementerId );
+    REQUIRE( circuit->GetComponent( counterId ) == counter );
+    REQUIRE( circuit->GetComponent( ComponentId() ) == nullptr );
+
+    // Components can be wired via ComponentIds
+    REQUIRE( circuit->ConnectOutToIn( counterId, 0, incrementerId, 0 ) );
+    REQUIRE( circuit->ConnectOutToIn( incrementerId, 0, passThroughId, 0 ) );
+    REQUIRE( !circuit->ConnectOutToIn( counterId, 1, incrementerId, 0 ) );
+
+    circuit->Tick();
+    REQUIRE( counter->Count() == 1 );
+
+    const Component* fromComponent = nullptr;
+    int fromOutput = -1;
+    REQUIRE( passThrough->GetInputWire( 0, fromComponent, fromOutput ) );
+    REQUIRE( fromComponent == incrementer.get() );
+
+    // A removed component's ComponentId should be rejected, even once its slot is reused
+    REQUIRE( circuit->DisconnectComponent( incrementerId ) );
+    REQUIRE( !passThrough->GetInputWire( 0, fromComponent, fromOutput ) );
+
+    REQUIRE( circuit->RemoveComponent( incrementerId ) );
+    REQUIRE( circuit->GetComponentCount() == 2 );
+    REQUIRE( circuit->GetComponent( incrementerId ) == nullptr );
+    REQUIRE( circuit->GetComponentId( incrementer ) == ComponentId() );
+    REQUIRE( !circuit->RemoveComponent( incrementerId ) );
+    REQUIRE( !circuit->DisconnectComponent( incrementerId ) );
+    REQUIRE( !circuit->ConnectOutToIn( counterId, 0, incrementerId, 0 ) );
+
+    auto newIncrementer = std::make_shared<Incrementer>();
+    ComponentId newIncrementerId;
+    REQUIRE( circuit->AddComponent( newIncrementer, newIncrementerId ) );
+    REQUIRE( newIncrementerId.index == incrementerId.index );
+    REQUIRE( newIncrementerId != incrementerId );
+    REQUIRE( circuit->GetComponent( newIncrementerId ) == newIncrementer );
+
+    // The Component::SPtr API should act on the same slots
+    REQUIRE( circuit->ConnectOutToIn( counter, 0, newIncrementer, 0 ) );
+    REQUIRE( circuit->ConnectOutToIn( newIncrementerId, 0, passThroughId, 0 ) );
+    REQUIRE( circuit->RemoveComponent( passThrough ) );
+    REQUIRE( circuit->GetComponent( passThroughId ) == nullptr );
+
+    // ComponentIds aren't assigned while editing
+    circuit->BeginEdit();
+
+    ComponentId editId;
+    REQUIRE( circuit->AddComponent( passThrough, editId ) );
+    REQUIRE( editId == ComponentId() );
+    REQUIRE( circuit->ConnectOutToIn( newIncrementer, 0, passThrough, 0 ) );
+
+    REQUIRE( circuit->Commit() );
+
+    editId = circuit->GetComponentId( passThrough );
+    REQUIRE( circuit->GetComponent( editId ) == passThrough );
+    REQUIRE( passThrough->GetInputWire( 0, fromComponent, fromOutput ) );
+    REQUIRE( fromComponent == newIncrementer.get() );
+
+    circuit->Tick();
+    REQUIRE( counter->Count() == 2 );
+
+    // Removing all components should invalidate all ComponentIds
+    circuit->RemoveAllComponents();
+
+    REQUIRE( circuit->GetComponent( counterId ) == nullptr );
+    REQUIRE( circuit->GetComponent( newIncrementerId ) == nullptr );
+    REQUIRE( circuit->GetComponent( editId ) == nullptr );
+
+    // A producer wired in from outside the circuit should be disconnected on optimizing, rather than taken for one of ours
+    auto foreignCounter = std::make_shared<Counter>();
+    auto consumer = std::make_shared<PassThrough>();
+    auto probe = std::make_shared<SequenceProbe>( 2 );  // (the circuit has ticked twice)
+
+    REQUIRE( circuit->AddComponent( consumer ) );
+    REQUIRE( circuit->AddComponent( probe ) );
+    REQUIRE( circuit->ConnectOutToIn( consumer, 0, probe, 0 ) );
+    REQUIRE( consumer->ConnectInput( foreignCounter, 0, 0 ) );
+
+    circuit->SetThreadCount( 2 );
+    circuit->SetShardingEnabled( true );
+
+    for ( int i = 0; i < 10; ++i )
+    {
+        circuit->Tick();
+    }
+    circuit->Sync();
+
+    REQUIRE( probe->NextSequence() == 12 );
+    REQUIRE( foreignCounter->Count() == 0 );
+    REQUIRE( circuit->GetComponentCount() == 2 );
+    REQUIRE( circuit->GetComponentId( foreignCounter ) == ComponentId() );
+    REQUIRE( !consumer->GetInputWire( 0, fromComponent, fromOutput ) );
+    REQUIRE( circuit->GetComponent( circuit->GetComponentId( consumer ) ) == consumer );
+}
+
+TEST_CASE( "EmplaceTest" )
+{
+    auto circuit = std::make_shared<Circuit>();
+
+    auto counter = circuit->Emplace<Counter>( 2 );
+
+    std::vector<std::shared_ptr<Incrementer>> incrementers;
+    Component::SPtr previous = counter;
+
+    for ( int i = 0; i < 100; ++i )
+    {
+        incrementers.emplace_back( circuit->Emplace<Incrementer>() );
+        REQUIRE( circuit->ConnectOutToIn( previous, 0, incrementers.back(), 0 ) );
+        previous = incrementers.back();
+    }
+
+    REQUIRE( circuit->GetComponentCount() == 101 );
+    REQUIRE( circuit->GetComponent( circuit->GetComponentId( counter ) ) == counter );
+
+    // Components emplaced one after the other should sit side by side in memory
+    const auto stride = (const char*)incrementers[1].get() - (const char*)incrementers[0].get();
+    REQUIRE( stride > 0 );
+    REQUIRE( stride < 1024 );
+
+    for ( size_t i = 1; i < incrementers.size(); ++i )
+    {
+        REQUIRE( (const char*)incrementers[i].get() - (const char*)incrementers[i - 1].get() == stride );
+    }
+
+    for ( int i = 0; i < 10; ++i )
+    {
+        circuit->Tick();
+    }
+    REQUIRE( counter->Count() == 20 );
+
+    // A removed component's memory should be reused once released
+    const auto address = incrementers[50].get();
+
+    circuit->RemoveComponent( incrementers[50] );
+    incrementers[50] = nullptr;
+
+    auto replacement = circuit->Emplace<Incrementer>();
+    REQUIRE( replacement.get() == address );
+
+    // Emplaced components should outlive their circuit
+    circuit = nullptr;
+
+    REQUIRE( counter->Count() == 20 );
+    REQUIRE( replacement->GetInputCount() == 1 );
+}
+
+TEST_CASE( "TickSequenceTest" )
+{
+    // Configure a circuit with a probe checking that it sees each tick's sequence number in order
+    auto circuit = std::make_shared<Circuit>();
+
+    auto counter = std::make_shared<Counter>();
+    auto probe = std::make_shared<SequenceProbe>();
+
+    circuit->AddComponent( counter );
+    circuit->AddComponent( probe );
+
+    circuit->ConnectOutToIn( counter, 0, probe, 0 );
+
+    REQUIRE( circuit->GetWaitStrategy() == Component::WaitStrategy::Yield );
+
+    uint64_t tickCount = 0;
+
+    using WaitStrategy = Component::WaitStrategy;
+
+    for ( auto waitStrategy : { WaitStrategy::Yield, WaitStrategy::Spin, WaitStrategy::Backoff } )
+    {
+        circuit->SetWaitStrategy( waitStrategy );
+
+        REQUIRE( circuit->GetWaitStrategy() == waitStrategy );
+        REQUIRE( probe->GetWaitStrategy() == waitStrategy );
+
+        // The sequence should carry on across buffer and thread count changes
+        for ( int bufferCount : { 0, 1, 3, 4 } )
+        {
+            for ( int threadCount : { 0, 2 } )
+            {
+                circuit->SetBufferCount( bufferCount );
+                circuit->SetThreadCount( threadCount );
+
+                for ( int i = 0; i < 50; ++i )
+                {
+                    circuit->Tick();
+                }
+                circuit->Sync();
+
+                tickCount += 50;
+                REQUIRE( probe->NextSequence() == tickCount );
+            }
+        }
+    }
+
+    // A component added mid-stream should pick up from the circuit's next tick
+    auto lateProbe = std::make_shared<SequenceProbe>( tickCount );
+    circuit->AddComponent( lateProbe );
+
+    REQUIRE( lateProbe->GetWaitStrategy() == Component::WaitStrategy::Backoff );
+
+    for ( int i = 0; i < 50; ++i )
+    {
+        circuit->Tick();
+    }
+    circuit->Sync();
+
+    REQUIRE( probe->NextSequence() == tickCount + 50 );
+    REQUIRE( lateProbe->NextSequence() == tickCount + 50 );
+}
+
+TEST_CASE( "ReorderingTest" )
+{
+    // Configure a circuit with an in-order component that holds up its first tick until an independent out-of-order
+    // component has processed the second
+    for ( bool reordering : { false, true } )
+    {
+        auto circuit = std::make_shared<Circuit>();
+
+        auto secondTickSeen = std::make_shared<std::atomic<bool>>( false );
+        auto inOrder = std::make_shared<DeferralProbe>( Component::ProcessOrder::InOrder, secondTickSeen );
+        auto outOfOrder = std::make_shared<DeferralProbe>( Component::ProcessOrder::OutOfOrder, secondTickSeen );
+
+        circuit->AddComponent( inOrder );
+        circuit->AddComponent( outOfOrder );
+
+        circuit->SetBufferCount( 2 );
+        circuit->SetReorderingEnabled( reordering );
+
+        REQUIRE( circuit->GetReorderingEnabled() == reordering );
+
+        circuit->Tick();
+        circuit->Tick();
+        circuit->Sync();
+
+        // Without reordering, the second buffer stalls behind the in-order component before reaching the out-of-order one
+        REQUIRE( inOrder->WaitedForSecondTick() == reordering );
+    }
+
+    // Deferred components should still see their inputs in order, and process their ticks in sequence
+    auto circuit = std::make_shared<Circuit>();
+
+    auto counter = std::make_shared<Counter>();
+    auto passThrough = std::make_shared<PassThrough>();
+    auto inOrderProbe = std::make_shared<SequenceProbe>();
+    auto outOfOrderProbe = std::make_shared<PassThrough>();
+    auto lastProbe = std::make_shared<SequenceProbe>();
+
+    circuit->AddComponent( counter );
+    circuit->AddComponent( passThrough );
+    circuit->AddComponent( inOrderProbe );
+    circuit->AddComponent( outOfOrderProbe );
+    circuit->AddComponent( lastProbe );
+
+    circuit->ConnectOutToIn( counter, 0, passThrough, 0 );
+    circuit->ConnectOutToIn( passThrough, 0, inOrderProbe, 0 );
+    circuit->ConnectOutToIn( passThrough, 0, outOfOrderProbe, 0 );
+    circuit->ConnectOutToIn( outOfOrderProbe, 0, lastProbe, 0 );
+
+    circuit->SetReorderingEnabled( true );
+
+    uint64_t tickCount = 0;
+
+    for ( int bufferCount : { 2, 3, 4, 0, 4 } )
+    {
+        circuit->SetBufferCount( bufferCount );
+
+        for ( int i = 0; i < 1000; ++i )
+        {
+            circuit->Tick();
+        }
+        circuit->Sync();
+
+        tickCount += 1000;
+        REQUIRE( inOrderProbe->NextSequence() == tickCount );
+        REQUIRE( lastProbe->NextSequence() == tickCount );
+    }
+
+    // Feedback wires disable reordering (but the circuit should still tick as usual)
+    auto feedbackFrom = std::make_shared<PassThrough>();
+    auto feedbackTo = std::make_shared<PassThrough>();
+    circuit->AddComponent( feedbackFrom );
+    circuit->AddComponent( feedbackTo );
+    REQUIRE( circuit->ConnectOutToIn( feedbackFrom, 0, feedbackTo, 0 ) );
+    REQUIRE( circuit->ConnectOutToIn( feedbackTo, 0, feedbackFrom, 0 ) );
+
+    for ( int i = 0; i < 1000; ++i )
+    {
+        circuit->Tick();
+    }
+    circuit->Sync();
+
+    REQUIRE( inOrderProbe->NextSequence() == tickCount + 1000 );
+    REQUIRE( lastProbe->NextSequence() == tickCount + 1000 );
+
+    // Loaded circuits should be planned for reordering just as optimized ones are
+    auto savedCircuit = std::make_shared<Circuit>();
+
+    for ( int i = 0; i < 8; ++i )
+    {
+        auto chainCounter = std::make_shared<Counter>();
+        auto chainPassThrough = std::make_shared<PassThrough>();
+        auto chainProbe = std::make_shared<SequenceProbe>();
+
+        savedCircuit->AddComponent( chainCounter );
+        savedCircuit->AddComponent( chainPassThrough );
+        savedCircuit->AddComponent( chainProbe );
+
+        savedCircuit->ConnectOutToIn( chainCounter, 0, chainPassThrough, 0 );
+        savedCircuit->ConnectOutToIn( chainPassThrough, 0, chainProbe, 0 );
+    }
+
+    savedCircuit->SetBufferCount( 4 );
+    savedCircuit->Optimize();
+
+    std::stringstream topology;
+    savedCircuit->SaveTopology( topology );
+
+    ComponentFactory factory;
+    factory.Register<Counter>();
+    factory.Register<PassThrough>();
+    factory.Register<SequenceProbe>();
+
+    auto loadedCircuit = std::make_shared<Circuit>();
+    loadedCircuit->SetReorderingEnabled( true );
+
+    std::vector<Component::SPtr> components;
+    REQUIRE( loadedCircuit->LoadTopology( topology, factory, components ) );
+
+    for ( int i = 0; i < 1000; ++i )
+    {
+        loadedCircuit->Tick();
+    }
+    loadedCircuit->Sync();
+
+    for ( const auto& component : components )
+    {
+        if ( auto probe = std::dynamic_pointer_cast<SequenceProbe>( component ) )
+        {
+            REQUIRE( probe->NextSequence() == 1000 );
+        }
+    }
+}
+
+TEST_CASE( "CallerRunsTest" )
+{
+    // Configure a circuit with 2 parallel branches converging on a probe
+    auto circuit = std::make_shared<Circuit>();
+
+    auto counter = std::make_shared<Counter>();
+    auto passThrough1 = std::make_shared<PassThrough>();
+    auto passThrough2 = std::make_shared<PassThrough>();
+    auto probe1 = std::make_shared<SequenceProbe>();
+    auto probe2 = std::make_shared<SequenceProbe>();
+
+    circuit->AddComponent( counter );
+    circuit->AddComponent( passThrough1 );
+    circuit->AddComponent( passThrough2 );
+    circuit->AddComponent( probe1 );
+    circuit->AddComponent( probe2 );
+
+    circuit->ConnectOutToIn( counter, 0, passThrough1, 0 );
+    circuit->ConnectOutToIn( counter, 0, passThrough2, 0 );
+    circuit->ConnectOutToIn( passThrough1, 0, probe1, 0 );
+    circuit->ConnectOutToIn( passThrough2, 0, probe2, 0 );
+
+    circuit->SetCallerRunsEnabled( true );
+
+    REQUIRE( circuit->GetCallerRunsEnabled() );
+
+    uint64_t tickCount = 0;
+
+    for ( int threadCount : { 1, 2, 3, 4 } )
+    {
+        circuit->SetThreadCount( threadCount );
+
+        for ( int i = 0; i < 1000; ++i )
+        {
+            circuit->Tick();
+            ++tickCount;
+
+            // Each tick should be complete by the time Tick() returns
+            REQUIRE( probe1->NextSequence() == tickCount );
+            REQUIRE( probe2->NextSequence() == tickCount );
+        }
+    }
+
+    // Caller-runs should be ignored when multi-buffered, and can be switched off again
+    for ( bool callerRuns : { true, false } )
+    {
+        circuit->SetCallerRunsEnabled( callerRuns );
+        circuit->SetBufferCount( callerRuns ? 3 : 0 );
+
+        for ( int i = 0; i < 1000; ++i )
+        {
+            circuit->Tick();
+        }
+        circuit->Sync();
+
+        tickCount += 1000;
+        REQUIRE( probe1->NextSequence() == tickCount );
+        REQUIRE( probe2->NextSequence() == tickCount );
+    }
+}
+
+TEST_CASE( "LowLatencyTest" )
+{
+    // Configure a circuit with 2 parallel branches converging on a probe
+    auto circuit = std::make_shared<Circuit>();
+
+    auto counter = std::make_shared<Counter>();
+    auto passThrough1 = std::make_shared<PassThrough>();
+    auto passThrough2 = std::make_shared<PassThrough>();
+    auto probe1 = std::make_shared<SequenceProbe>();
+    auto probe2 = std::make_shared<SequenceProbe>();
+
+    circuit->AddComponent( counter );
+    circuit->AddComponent( passThrough1 );
+    circuit->AddComponent( passThrough2 );
+    circuit->AddComponent( probe1 );
+    circuit->AddComponent( probe2 );
+
+    circuit->ConnectOutToIn( counter, 0, passThrough1, 0 );
+    circuit->ConnectOutToIn( counter, 0, passThrough2, 0 );
+    circuit->ConnectOutToIn( passThrough1, 0, probe1, 0 );
+    circuit->ConnectOutToIn( passThrough2, 0, probe2, 0 );
+
+    circuit->SetLowLatencyEnabled( true );
+
+    REQUIRE( circuit->GetLowLatencyEnabled() );
+
+    uint64_t tickCount = 0;
+
+    for ( bool callerRuns : { false, true } )
+    {
+        circuit->SetCallerRunsEnabled( callerRuns );
+
+        for ( int bufferCount : { 0, 2 } )
+        {
+            circuit->SetBufferCount( bufferCount );
+
+            for ( int threadCount : { 1, 2, 3, 4 } )
+            {
+                circuit->SetThreadCount( threadCount );
+
+                for ( int i = 0; i < 1000; ++i )
+                {
+                    circuit->Tick();
+
+                    // Pause now and then, so that the threads outlast their spin budget and park
+                    if ( i % 250 == 0 )
+                    {
+                        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+                    }
+                }
+                circuit->Sync();
+
+                tickCount += 1000;
+                REQUIRE( probe1->NextSequence() == tickCount );
+                REQUIRE( probe2->NextSequence() == tickCount );
+            }
+        }
+    }
+
+    // Low-latency mode can be switched off again
+    circuit->SetLowLatencyEnabled( false );
+
+    for ( int i = 0; i < 1000; ++i )
+    {
+        circuit->Tick();
+    }
+    circuit->Sync();
+
+    REQUIRE( probe1->NextSequence() == tickCount + 1000 );
+    REQUIRE( probe2->NextSequence() == tickCount + 1000 );
+}
+
+TEST_CASE( "ShardingTest" )
+{
+    // Configure a circuit with 2 shards on 2 threads: a gated probe (holding up its first tick until the test opens its gate)
+    // feeding a pass-through, and an ungated probe
+    {
+        auto circuit = std::make_shared<Circuit>();
+
+        auto gate = std::make_shared<ShardProbe::Gate>();
+        auto gated = std::make_shared<ShardProbe>( gate );
+        auto passThrough = std::make_shared<PassThrough>();
+        auto ungated = std::make_shared<ShardProbe>();
+
+        circuit->AddComponent( gated );
+        circuit->AddComponent( passThrough );
+        circuit->AddComponent( ungated );
+
+        circuit->ConnectOutToIn( gated, 0, passThrough, 0 );
+
+        circuit->SetThreadCount( 2 );
+        circuit->SetShardingEnabled( true );
+
+        REQUIRE( circuit->GetShardingEnabled() );
+
+        // Sharded, Tick() shouldn't wait on the held up shard's thread (without sharding, the 2nd Tick() would never return)
+        for ( int i = 0; i < 4; ++i )
+        {
+            circuit->Tick();
+        }
+
+        // so the ungated shard should work through its ticks while the gated one is still held up on its first
+        while ( ungated->TickCount() != 4 )
+        {
+            std::this_thread::yield();
+        }
+        REQUIRE( gated->TickCount() == 0 );
+
+        gate->Open();
+        circuit->Sync();
+
+        REQUIRE( gated->TickCount() == 4 );
+        REQUIRE( ungated->TickCount() == 4 );
+    }
+
+    // Sharded circuits should tick each shard in order, whatever the buffer and thread counts
+    auto circuit = std::make_shared<Circuit>();
+
+    std::vector<std::shared_ptr<SequenceProbe>> probes;
+
+    for ( int i = 0; i < 5; ++i )
+    {
+        auto counter = std::make_shared<Counter>();
+        auto passThrough = std::make_shared<PassThrough>();
+        auto probe = std::make_shared<SequenceProbe>();
+
+        circuit->AddComponent( counter );
+        circuit->AddComponent( passThrough );
+        circuit->AddComponent( probe );
+
+        circuit->ConnectOutToIn( counter, 0, passThrough, 0 );
+        circuit->ConnectOutToIn( passThrough, 0, probe, 0 );
+
+        probes.emplace_back( probe );
+    }
+
+    circuit->SetShardingEnabled( true );
+
+    uint64_t tickCount = 0;
+
+    for ( int mode = 0; mode < 3; ++mode )
+    {
+        circuit->SetCallerRunsEnabled( mode == 1 );
+        circuit->SetLowLatencyEnabled( mode == 2 );
+
+        for ( int bufferCount : { 0, 3 } )
+        {
+            for ( int threadCount : { 2, 3, 4 } )
+            {
+                circuit->SetBufferCount( bufferCount );
+                circuit->SetThreadCount( threadCount );
+
+                for ( int i = 0; i < 1000; ++i )
+                {
+                    circuit->Tick();
+                }
+                circuit->Sync();
+
+                tickCount += 1000;
+                for ( const auto& probe : probes )
+                {
+                    REQUIRE( probe->NextSequence() == tickCount );
+                }
+            }
+        }
+    }
+
+    // removing components should leave nothing of theirs in the shards
+    circuit->RemoveAllComponents();
+    probes.clear();
+
+    circuit->Tick();
+    circuit->Sync();
+
+    std::vector<std::shared_ptr<Counter>> counters;
+
+    for ( int i = 0; i < 4; ++i )
+    {
+        auto counter = std::make_shared<Counter>();
+        auto passThrough = std::make_shared<PassThrough>();
+
+        circuit->AddComponent( counter );
+        circuit->AddComponent( passThrough );
+        circuit->ConnectOutToIn( counter, 0, passThrough, 0 );
+
+        counters.emplace_back( counter );
+    }
+
+    circuit->Tick();
+    circuit->Sync();
+
+    circuit->RemoveComponent( counters[0] );
+    counters[0] = nullptr;
+
+    circuit->Tick();
+    circuit->Sync();
+
+    REQUIRE( counters[1]->Count() == 2 );
+
+    circuit->RemoveAllComponents();
+    counters.clear();
+
+    circuit->Tick();
+    circuit->Sync();
+}
+
+TEST_CASE( "ClockDividerTest" )
+{
+    for ( int bufferCount : { 0, 1 } )
+    {
+        auto circuit = std::make_shared<Circuit>();
+        circuit->SetBufferCount( bufferCount );
+
+        // a held and an absent counter ticking every 4th tick, each feeding a probe ticking every tick
+        auto heldCounter = std::make_shared<Counter>();
+        auto heldProbe = std::make_shared<ClockProbe>();
+        auto absentCounter = std::make_shared<Counter>();
+        auto absentProbe = std::make_shared<ClockProbe>();
+
+        // a counter ticking every tick, feeding a probe ticking every tick and another ticking every 3rd tick
+        auto counter = std::make_shared<Counter>();
+        auto fastProbe = std::make_shared<ClockProbe>();
+        auto slowProbe = std::make_shared<ClockProbe>();
+
+        for ( auto component : std::vector<Component::SPtr>{
+                  heldCounter, heldProbe, absentCounter, absentProbe, counter, fastProbe, slowProbe } )
+        {
+            circuit->AddComponent( component );
+        }
+
+        circuit->ConnectOutToIn( heldCounter, 0, heldProbe, 0 );
+        circuit->ConnectOutToIn( absentCounter, 0, absentProbe, 0 );
+        circuit->ConnectOutToIn( counter, 0, fastProbe, 0 );
+        circuit->ConnectOutToIn( counter, 0, slowProbe, 0 );
+
+        REQUIRE( circuit->SetClockDivider( heldCounter, 4 ) );
+        REQUIRE( circuit->SetClockDivider( absentCounter, 4, Component::IdleOutput::Absent ) );
+        REQUIRE( circuit->SetClockDivider( slowProbe, 3 ) );
+
+        REQUIRE( heldCounter->GetClockDivider() == 4 );
+        REQUIRE( heldCounter->GetIdleOutput() == Component::IdleOutput::Hold );
+        REQUIRE( absentCounter->GetIdleOutput() == Component::IdleOutput::Absent );
+        REQUIRE( !circuit->SetClockDivider( std::make_shared<Counter>(), 2 ) );
+
+        for ( int i = 0; i < 24; ++i )
+        {
+            circuit->Tick();
+        }
+        circuit->Sync();
+
+        // idle components are skipped entirely
+        REQUIRE( heldCounter->Count() == 6 );
+        REQUIRE( absentCounter->Count() == 6 );
+        REQUIRE( counter->Count() == 24 );
+
+        REQUIRE( heldProbe->Received().size() == 24 );
+        REQUIRE( absentProbe->Received().size() == 24 );
+        REQUIRE( fastProbe->Received().size() == 24 );
+        REQUIRE( slowProbe->Received().size() == 8 );
+
+        for ( int i = 0; i < 24; ++i )
+        {
+            // held outputs keep their last values while idle, absent outputs are absent
+            REQUIRE( heldProbe->Received()[i] == std::pair<uint64_t, int>( i, i / 4 ) );
+            REQUIRE( absentProbe->Received()[i] == std::pair<uint64_t, int>( i, i % 4 == 0 ? i / 4 : -1 ) );
+
+            // consumers at other rates see every value they're due, whichever processes first
+            REQUIRE( fastProbe->Received()[i] == std::pair<uint64_t, int>( i, i ) );
+        }
+
+        for ( int i = 0; i < 8; ++i )
+        {
+            REQUIRE( slowProbe->Received()[i] == std::pair<uint64_t, int>( i * 3, i * 3 ) );
+        }
+
+        // multi-buffered circuits suspend their dividers, ticking every component every tick
+        circuit->SetBufferCount( 3 );
+
+        REQUIRE( !circuit->SetClockDivider( counter, 2 ) );
+        REQUIRE( counter->GetClockDivider() == 1 );
+
+        for ( int i = 0; i < 6; ++i )
+        {
+            circuit->Tick();
+        }
+        circuit->Sync();
+
+        REQUIRE( heldCounter->Count() == 12 );
+        REQUIRE( slowProbe->Received().size() == 14 );
+        REQUIRE( slowProbe->Received().back() == std::pair<uint64_t, int>( 29, 29 ) );
+
+        // returning to a single buffer, dividers pick up where the tick sequence is
+        circuit->SetBufferCount( bufferCount );
+
+        for ( int i = 0; i < 6; ++i )
+        {
+            circuit->Tick();
+        }
+        circuit->Sync();
+
+        REQUIRE( heldCounter->Count() == 13 );
+        REQUIRE( slowProbe->Received().size() == 16 );
+        REQUIRE( slowProbe->Received()[14] == std::pair<uint64_t, int>( 30, 30 ) );
+        REQUIRE( slowProbe->Received()[15] == std::pair<uint64_t, int>( 33, 33 ) );
+        REQUIRE( heldProbe->Received().back() == std::pair<uint64_t, int>( 35, 12 ) );
+
+        // as do multi-threaded circuits
+        circuit->SetThreadCount( 2 );
+
+        REQUIRE( !circuit->SetClockDivider( counter, 2 ) );
+        REQUIRE( circuit->SetClockDivider( counter, 1 ) );
+
+        circuit->SetThreadCount( 0 );
+
+        // resetting the dividers ticks every component every tick again
+        circuit->SetClockDivider( heldCounter, 1 );
+        circuit->SetClockDivider( absentCounter, 1 );
+        circuit->SetClockDivider( slowProbe, 1 );
+
+        circuit->Tick();
+        circuit->Sync();
+
+        REQUIRE( heldCounter->Count() == 14 );
+        REQUIRE( slowProbe->Received().back() == std::pair<uint64_t, int>( 36, 36 ) );
+        REQUIRE( absentProbe->Received().back() == std::pair<uint64_t, int>( 36, 13 ) );
+    }
+
+    // removing all components should leave nothing of theirs in the clock plan
+    for ( int bufferCount : { 0, 1 } )
+    {
+        auto circuit = std::make_shared<Circuit>();
+        circuit->SetBufferCount( bufferCount );
+
+        auto counter = std::make_shared<Counter>();
+        auto passThrough = std::make_shared<PassThrough>();
+
+        circuit->AddComponent( counter );
+        circuit->AddComponent( passThrough );
+        circuit->ConnectOutToIn( counter, 0, passThrough, 0 );
+        circuit->SetClockDivider( passThrough, 2 );
+
+        circuit->Tick();
+        circuit->Sync();
+
+        circuit->RemoveAllComponents();
+        counter = nullptr;
+        passThrough = nullptr;
+
+        circuit->Tick();
+        circuit->Tick();
+        circuit->Sync();
+
+        // a component added afterwards is ticked every tick
+        auto newCounter = std::make_shared<Counter>();
+        circuit->AddComponent( newCounter );
+
+        circuit->Tick();
+        circuit->Tick();
+        circuit->Sync();
+
+        REQUIRE( newCounter->Count() == 2 );
+    }
+
+    // dividers with too long a combined period to plan tick by tick should still be honoured
+    for ( int bufferCount : { 0, 1 } )
+    {
+        auto circuit = std::make_shared<Circuit>();
+        circuit->SetBufferCount( bufferCount );
+
+        std::vector<std::shared_ptr<Counter>> counters;
+
+        for ( int clockDivider : { 97, 89, 83, 79, 1000000 } )
+        {
+            auto counter = std::make_shared<Counter>();
+            auto probe = std::make_shared<ClockProbe>();
+
+            circuit->AddComponent( counter );
+            circuit->AddComponent( probe );
+            circuit->ConnectOutToIn( counter, 0, probe, 0 );
+
+            REQUIRE( circuit->SetClockDivider( counter, clockDivider ) );
+
+            counters.emplace_back( counter );
+        }
+
+        for ( int i = 0; i < 200; ++i )
+        {
+            circuit->Tick();
+        }
+        circuit->Sync();
+
+        REQUIRE( counters[0]->Count() == 3 );  // ticks 0, 97 and 194
+        REQUIRE( counters[1]->Count() == 3 );  // ticks 0, 89 and 178
+        REQUIRE( counters[2]->Count() == 3 );  // ticks 0, 83 and 166
+        REQUIRE( counters[3]->Count() == 3 );  // ticks 0, 79 and 158
+        REQUIRE( counters[4]->Count() == 1 );  // tick 0
+    }
+
+    // loaded circuits should be clocked just as optimized ones are
+    auto savedCircuit = std::make_shared<Circuit>();
+    savedCircuit->AddComponent( std::make_shared<Counter>() );
+
+    std::stringstream topology;
+    savedCircuit->SaveTopology( topology );
+
+    ComponentFactory factory;
+    factory.Register( "DSPatch::Counter", [] {
+        auto counter = std::make_shared<Counter>();
+        counter->SetClockDivider( 2 );
+        return counter;
+    } );
+
+    auto loadedCircuit = std::make_shared<Circuit>();
+
+    std::vector<Component::SPtr> components;
+    REQUIRE( loadedCircuit->LoadTopology( topology, factory, components ) );
+
+    for ( int i = 0; i < 4; ++i )
+    {
+        loadedCircuit->Tick();
+    }
+
+    REQUIRE( std::static_pointer_cast<Counter>( components.front() )->Count() == 2 );
+}
+
+TEST_CASE( "CompactionTest" )
+{
+    // Configure a circuit of 5 counter -> pass-through -> probe chains, added back to front (so out of tick order)
+    auto circuit = std::make_shared<Circuit>();
+
+    std::vector<std::shared_ptr<SequenceProbe>> probes;
+
+    for ( int i = 0; i < 5; ++i )
+    {
+        auto counter = std::make_shared<Counter>();
+        auto passThrough = std::make_shared<PassThrough>();
+        auto probe = std::make_shared<SequenceProbe>();
+
+        circuit->AddComponent( probe );
+        circuit->AddComponent( passThrough );
+        circuit->AddComponent( counter );
+
+        circuit->ConnectOutToIn( counter, 0, passThrough, 0 );
+        circuit->ConnectOutToIn( passThrough, 0, probe, 0 );
+
+        probes.emplace_back( probe );
+    }
+
+    circuit->SetCompactionEnabled( true );
+
+    REQUIRE( circuit->GetCompactionEnabled() );
+
+    // Relocating the components' state should go unnoticed, whatever the buffer and thread counts
+    uint64_t tickCount = 0;
+
+    for ( int bufferCount : { 0, 3 } )
+    {
+        for ( int threadCount : { 0, 2 } )
+        {
+            circuit->SetBufferCount( bufferCount );
+            circuit->SetThreadCount( threadCount );
+
+            for ( int i = 0; i < 1000; ++i )
+            {
+                circuit->Tick();
+            }
+            circuit->Sync();
+
+            tickCount += 1000;
+            for ( const auto& probe : probes )
+            {
+                REQUIRE( probe->NextSequence() == tickCount );
+            }
+        }
+    }
+
+    // As should re-optimizing (re-compacting), and moving the state back onto the heap, while auto-ticking
+    circuit->SetBufferCount( 0 );
+    circuit->SetThreadCount( 0 );
+
+    auto counter = std::make_shared<Counter>();
+
+    circuit->StartAutoTick();
+
+    for ( int i = 0; i < 100; ++i )
+    {
+        circuit->SetCompactionEnabled( i % 2 == 0 );
+
+        circuit->AddComponent( counter );
+        circuit->Optimize();
+        circuit->RemoveComponent( counter );
+    }
+
+    circuit->StopAutoTick();
+
+    REQUIRE( !circuit->GetCompactionEnabled() );
+
+    tickCount = probes[0]->NextSequence();
+    for ( const auto& probe : probes )
+    {
+        REQUIRE( probe->NextSequence() == tickCount );
+    }
+
+    // Components should keep their state (and its arena) beyond removal from the circuit, and the circuit itself
+    circuit->SetCompactionEnabled( true );
+    circuit->AddComponent( counter );
+
+    const auto count = counter->Count();
+    circuit->Tick();
+
+    circuit = nullptr;
+
+    REQUIRE( counter->Count() == count + 1 );
+    REQUIRE( probes[1]->GetInputCount() == 1 );
+}
+
 TEST_CASE( "BufferPerformanceTest" )
 {
     // Configure a circuit made up of 4 parallel counters, then adjust the thread count